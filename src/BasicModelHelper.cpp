@@ -1,66 +1,116 @@
 #include "BasicModelHelper.hpp"
+#include "ConfigMapHelper.hpp"
+#include "utils/LruCache.hpp"
 
 #include <mars/utils/misc.h>
+#include <cstdlib>
+#include <functional>
+#include <mutex>
 
 using namespace configmaps;
 
 namespace xrock_gui_model
 {
 
+    void BasicModelHelper::buildPortIndex(ConfigMap &node, PortIndex &index)
+    {
+        index.inputs.clear();
+        index.outputs.clear();
+        if (node.hasKey("inputs"))
+        {
+            for (auto &input : node["inputs"])
+            {
+                index.inputs.emplace(input["name"].getString(), &input);
+            }
+        }
+        if (node.hasKey("outputs"))
+        {
+            for (auto &output : node["outputs"])
+            {
+                index.outputs.emplace(output["name"].getString(), &output);
+            }
+        }
+    }
+
+    void BasicModelHelper::buildInterfaceIndex(ConfigMap &model, InterfaceIndex &index)
+    {
+        index.byNode.clear();
+        index.byName.clear();
+        index.removed.clear();
+        if (!model["versions"][0].hasKey("interfaces"))
+            return;
+        ConfigVector &interfaces = model["versions"][0]["interfaces"];
+        for (size_t i = 0; i < interfaces.size(); ++i)
+        {
+            ConfigItem &interface = interfaces[i];
+            if (interface.hasKey("linkToNode"))
+            {
+                index.byNode[interface["linkToNode"].getString()].push_back(i);
+            }
+            index.byName[interface["name"].getString()].push_back(i);
+        }
+    }
+
     void BasicModelHelper::updateExportedInterfacesFromModel(ConfigMap &node, ConfigMap &model, bool overrideExportName)
+    {
+        InterfaceIndex interfaces;
+        PortIndex ports;
+        buildInterfaceIndex(model, interfaces);
+        buildPortIndex(node, ports);
+        updateExportedInterfacesFromModel(node, model, interfaces, ports, overrideExportName);
+    }
+
+    void BasicModelHelper::updateExportedInterfacesFromModel(ConfigMap &node, ConfigMap &model,
+                                                             const InterfaceIndex &interfaces, PortIndex &ports,
+                                                             bool overrideExportName)
     {
         // exposed interfaces are stored in the input data within the bagel_gui
         // so we have to create this information from the model interfaces
-        if(model["versions"][0].hasKey("interfaces"))
+        auto linked = interfaces.byNode.find(node["name"].getString());
+        if (linked == interfaces.byNode.end())
+            return;
+        ConfigVector &modelInterfaces = model["versions"][0]["interfaces"];
+        for (size_t i : linked->second)
         {
-            //ConfigVector interfaces = model["versions"][0]["interfaces"];
-            for(auto interface: model["versions"][0]["interfaces"])
+            ConfigItem &interface = modelInterfaces[i];
+            const std::string &portName(interface["linkToInterface"].getString());
+            // search for interface
+            if (interface["direction"] == "INCOMING" || interface["direction"] == "BIDIRECTIONAL")
             {
-                if(interface.hasKey("linkToNode") && interface["linkToNode"] == node["name"])
+                auto port = ports.inputs.find(portName);
+                if (port == ports.inputs.end())
+                    continue;
+                ConfigItem &input = *port->second;
+                input["interface"] = 1;
+                if (overrideExportName || !input.hasKey("interfaceExportName"))
+                {
+                    input["interfaceExportName"] = interface["name"];
+                }
+                if (interface.hasKey("data"))
                 {
-                    // search for interface
-                    if(interface["direction"] == "INCOMING" || interface["direction"] == "BIDIRECTIONAL")
+                    ConfigMap dataMap;
+                    if (interface["data"].isMap())
                     {
-                        for(ConfigVector::iterator input = node["inputs"].begin();
-                            input < node["inputs"].end(); ++input)
-                        {
-                            if((*input)["name"] == interface["linkToInterface"])
-                            {
-                                (*input)["interface"] = 1;
-                                if(overrideExportName || !input->hasKey("interfaceExportName"))
-                                {
-                                    (*input)["interfaceExportName"] = interface["name"];
-                                }
-                                if(interface.hasKey("data"))
-                                {
-                                    ConfigMap dataMap;
-                                    if(interface["data"].isMap())
-                                    {
-                                        dataMap = interface["data"];
-                                    }
-                                    else
-                                    {
-                                        dataMap = ConfigMap::fromYamlString(interface["data"].getString());
-                                    }
-                                    ConfigMap &inputMap = *input;
-                                    inputMap.append(dataMap);
-                                }
-                            }
-                        }
-                    } else {
-                        for(ConfigVector::iterator output = node["outputs"].begin();
-                            output < node["outputs"].end(); ++output)
-                        {
-                            if((*output)["name"] == interface["linkToInterface"])
-                            {
-                                (*output)["interface"] = 1;
-                                if(overrideExportName || !output->hasKey("interfaceExportName"))
-                                {
-                                    (*output)["interfaceExportName"] = interface["name"];
-                                }
-                            }
-                        }
+                        dataMap = interface["data"];
+                    }
+                    else
+                    {
+                        dataMap = ConfigMap::fromYamlString(interface["data"].getString());
                     }
+                    ConfigMap &inputMap = input;
+                    inputMap.append(dataMap);
+                }
+            }
+            else
+            {
+                auto port = ports.outputs.find(portName);
+                if (port == ports.outputs.end())
+                    continue;
+                ConfigItem &output = *port->second;
+                output["interface"] = 1;
+                if (overrideExportName || !output.hasKey("interfaceExportName"))
+                {
+                    output["interfaceExportName"] = interface["name"];
                 }
             }
         }
@@ -85,39 +135,51 @@ namespace xrock_gui_model
     }
 
     void BasicModelHelper::updateExportedInterfacesToModel(ConfigMap &node, ConfigMap &model, bool handleAlias)
+    {
+        InterfaceIndex interfaces;
+        buildInterfaceIndex(model, interfaces);
+        updateExportedInterfacesToModel(node, model, interfaces, handleAlias);
+        finishExportedInterfacesToModel(model, interfaces);
+    }
+
+    void BasicModelHelper::updateExportedInterfacesToModel(ConfigMap &node, ConfigMap &model,
+                                                           InterfaceIndex &interfaces, bool handleAlias)
     {
         // add exported interfaces of node to interface list
         const std::string& nodeName(node["name"].getString());
         const std::string& nodeAlias(node["alias"].getString());
-        for(auto port: node["inputs"])
+        for (const std::string portType : {"inputs", "outputs"})
         {
-            const std::string& portName(port["name"].getString());
-            const std::string& portAlias(port["alias"].getString());
-            if(port.hasKey("interface")) {
+            if (!node.hasKey(portType))
+                continue;
+            const bool isInput = (portType == "inputs");
+            for (auto &port : node[portType])
+            {
+                if (!port.hasKey("interface"))
+                    continue;
+                const std::string& portName(port["name"].getString());
+                const std::string portAlias = port.hasKey("alias") ? port["alias"].getString() : std::string();
+                const std::string exportName = port.hasKey("interfaceExportName") ? port["interfaceExportName"].getString() : std::string();
                 const int interfaceId = port["interface"];
                 // TODO: What meaning has value 2?
-                if((interfaceId == 1) || (interfaceId == 2))
+                if ((interfaceId == 1) || (interfaceId == 2))
                 {
                     // Search for the matching external interface first
-                    bool found = false;
-                    for (auto& interface : model["versions"][0]["interfaces"])
+                    auto existing = interfaces.byName.find(exportName);
+                    if (existing != interfaces.byName.end() && !existing->second.empty())
                     {
-                        if (interface["name"] == port["interfaceExportName"])
+                        // Interface already exists. Just update alias!
+                        ConfigItem &interface = model["versions"][0]["interfaces"][existing->second.front()];
+                        interface["alias"] = (nodeAlias.empty() ? nodeName : nodeAlias) + std::string(":") + (portAlias.empty() ? portName : portAlias);
+                        if (isInput && port.hasKey("initValue"))
                         {
-                            // Interface already exists. Just update alias!
-                            interface["alias"] = (nodeAlias.empty() ? nodeName : nodeAlias) + std::string(":") + (portAlias.empty() ? portName : portAlias);
-                            found = true;
-                            if(port.hasKey("initValue"))
-                            {
-                                ConfigMap data;
-                                data["initValue"] = port["initValue"];
-                                interface["data"] = data.toYamlString();
-                            }
-                            break;
+                            ConfigMap data;
+                            data["initValue"] = port["initValue"];
+                            interface["data"] = data.toYamlString();
                         }
+                        // If the interface already exists, we are done here
+                        continue;
                     }
-                    // If the interface already exists, we are done here
-                    if (found) continue;
 
                     // The interface does not yet exist, so we create a NEW one
                     ConfigMap interface;
@@ -143,121 +205,116 @@ namespace xrock_gui_model
                     {
                         interface["name"] = port["interfaceExportName"];
                     }
-                    if(port.hasKey("initValue"))
+                    if(isInput && port.hasKey("initValue"))
                     {
                         ConfigMap data;
                         data["initValue"] = port["initValue"];
                         interface["data"] = data.toYamlString();
                     }
-                    model["versions"][0]["interfaces"].push_back(interface);
+                    ConfigItem &interfaceList = model["versions"][0]["interfaces"];
+                    const size_t position = interfaceList.size();
+                    interfaceList.push_back(interface);
+                    interfaces.byNode[nodeName].push_back(position);
+                    interfaces.byName[interface["name"].getString()].push_back(position);
                 }
                 else if (interfaceId == 0)
                 {
-                    // In this case the external interface shall be removed. We do this by copiing every interface except for matching ones
-                    ConfigVector keep;
-                    for (auto interface : model["versions"][0]["interfaces"])
+                    // In this case the external interface shall be removed
+                    auto existing = interfaces.byName.find(exportName);
+                    if (existing != interfaces.byName.end())
                     {
-                        if (interface["name"] == port["interfaceExportName"])
-                            continue;
-                        keep.push_back(interface);
+                        interfaces.removed.insert(interfaces.removed.end(), existing->second.begin(), existing->second.end());
+                        interfaces.byName.erase(existing);
                     }
-                    model["versions"][0]["interfaces"] = keep;
                 }
             }
         }
+    }
 
-        for(auto port: node["outputs"])
+    void BasicModelHelper::finishExportedInterfacesToModel(ConfigMap &model, InterfaceIndex &interfaces)
+    {
+        if (interfaces.removed.empty())
+            return;
+        // Copy every interface except for the removed ones
+        std::vector<char> remove(model["versions"][0]["interfaces"].size(), 0);
+        for (size_t i : interfaces.removed)
         {
-            const std::string& portName(port["name"].getString());
-            const std::string& portAlias(port["alias"].getString());
-            if(port.hasKey("interface")) {
-                const int interfaceId = port["interface"];
-                // TODO: What meaning has value 2?
-                if((interfaceId == 1) || (interfaceId == 2))
-                {
-                    // Search for the matching external interface first
-                    bool found = false;
-                    for (auto& interface : model["versions"][0]["interfaces"])
-                    {
-                        if (interface["name"] == port["interfaceExportName"])
-                        {
-                            // Interface already exists. Just update alias!
-                            interface["alias"] = (nodeAlias.empty() ? nodeName : nodeAlias) + std::string(":") + (portAlias.empty() ? portName : portAlias);
-                            found = true;
-                            break;
-                        }
-                    }
-                    // If the interface already exists, we are done here
-                    if (found) continue;
-
-                    // The interface does not yet exist, so we create a NEW one
-                    ConfigMap interface;
-                    if(port.hasKey("domain"))
-                    {
-                        interface["domain"] = port["domain"];
-                    }
-                    interface["direction"] = port["direction"];
-                    if(port.hasKey("multiplicity"))
-                    {
-                        interface["multiplicity"] = port["multiplicity"];
-                    }
-                    interface["type"] = port["type"];
-                    interface["linkToNode"] = node["name"];
-                    interface["linkToInterface"] = port["name"];
-                    interface["name"] = nodeName + std::string(":") + portName;
-                    if(handleAlias)
-                    {
-                        interface["alias"] = (nodeAlias.empty() ? nodeName : nodeAlias) + std::string(":") + (portAlias.empty() ? portName : portAlias);
-                        // todo: should we also have an option to define the export name in the GUI?
-                    }
-                    else
-                    {
-                        interface["name"] = port["interfaceExportName"];
-                    }
-                    model["versions"][0]["interfaces"].push_back(interface);
-                }
-                else if (interfaceId == 0)
-                {
-                    // In this case the external interface shall be removed. We do this by copiing every interface except for matching ones
-                    ConfigVector keep;
-                    for (auto interface : model["versions"][0]["interfaces"])
-                    {
-                        if (interface["name"] == port["interfaceExportName"])
-                            continue;
-                        keep.push_back(interface);
-                    }
-                    model["versions"][0]["interfaces"] = keep;
-                }
+            remove[i] = 1;
+        }
+        ConfigVector keep;
+        size_t i = 0;
+        for (auto &interface : model["versions"][0]["interfaces"])
+        {
+            if (!remove[i++])
+            {
+                keep.push_back(interface);
             }
         }
+        model["versions"][0]["interfaces"] = keep;
+        // The positions changed, so the index has to be rebuilt
+        buildInterfaceIndex(model, interfaces);
+    }
+
+    // Original yaml strings of the data maps decoded by decodeData(), by the name of the entry and the hash
+    // of the decoded map (see ConfigMapHelper::hash()). Lets encodeData() skip the serialization of data which was not modified.
+    static std::mutex encodingsMutex;
+    static LruCache<uint64_t, std::string> encodings(4096);
+
+    static uint64_t encodingKey(ConfigItem &item)
+    {
+        uint64_t key = ConfigMapHelper::hash(item["data"]);
+        if (item.hasKey("name") && item["name"].isAtom())
+            key ^= std::hash<std::string>()(item["name"].getString()) * 1099511628211ull;
+        return key;
+    }
+
+    static void rememberEncoding(ConfigItem &item, const std::string &dataString)
+    {
+        const uint64_t key = encodingKey(item);
+        std::lock_guard<std::mutex> lock(encodingsMutex);
+        encodings.insert(key, dataString);
+    }
+
+    static bool findEncoding(ConfigItem &item, std::string &dataString)
+    {
+        const uint64_t key = encodingKey(item);
+        std::lock_guard<std::mutex> lock(encodingsMutex);
+        const std::string *found = encodings.find(key);
+        if (!found)
+            return false;
+        dataString = *found;
+        return true;
     }
 
     void BasicModelHelper::convertFromLegacyModelFormat(configmaps::ConfigMap &model)
     {
         //  - Store model information in sub-map
         model["model"] = ConfigMap(model);
+        normalizeModelData(model);
+    }
+
+    void BasicModelHelper::normalizeModelData(configmaps::ConfigMap &model)
+    {
+        if (!model.hasKey("versions") || model["versions"].size() == 0)
+            return;
 
         //  - Convert old domainData keys
+        //    The data strings of the version, the edges and the configuration entries are kept as they are
+        //    and only decoded on first access (see decodeData()). Thus, untouched data is neither parsed
+        //    here nor serialized again by convertToLegacyModelFormat().
         std::string domainData = mars::utils::tolower(model["domain"].getString()) + "Data";
         if(model["versions"][0].hasKey(domainData))
         {
             if(model["versions"][0][domainData].hasKey("data"))
             {
-                if(model["versions"][0][domainData]["data"].isMap())
-                {
-                    model["versions"][0]["data"] = model["versions"][0][domainData]["data"];
-                    ((ConfigMap)model["versions"][0]).erase(domainData);
-                }
-                else
-                {
-                    model["versions"][0]["data"] = ConfigMap::fromYamlString(model["versions"][0][domainData]["data"]);
-                    ((ConfigMap)model["versions"][0]).erase(domainData);
-                }
+                model["versions"][0]["data"] = model["versions"][0][domainData]["data"];
+                ConfigMap &version = model["versions"][0];
+                version.erase(domainData);
             }
         }
 
-        //  - Check the types of annotation data in the model
-        //    - check if data properties of edges are in string format and convert them to map
+        //  - Remove empty data strings of edges and copy the edge weights
+        //    Only edges whose data mentions a weight have to be decoded for that.
         if(model["versions"][0].hasKey("components"))
         {
             if(model["versions"][0]["components"].hasKey("edges"))
@@ -265,75 +322,34 @@ namespace xrock_gui_model
                 ConfigVector &edges = model["versions"][0]["components"]["edges"];
                 for(ConfigVector::iterator edge = edges.begin(); edge != edges.end(); ++edge)
                 {
-                    if(edge->hasKey("data"))
-                    {
-                        if(!(*edge)["data"].isMap())
-                        {
-                            if((*edge)["data"] == "")
-                            {
-                                ((ConfigMap)*edge).erase("data");
-                            }
-                            else
-                            {
-                                (*edge)["data"] = ConfigMap::fromYamlString((*edge)["data"]);
-                            }
-                        }
-                    }
-
-                    if(edge->hasKey("data"))
+                    if(!edge->hasKey("data"))
+                        continue;
+                    if(!(*edge)["data"].isMap())
                     {
-                        if((*edge)["data"].hasKey("weight"))
+                        if((*edge)["data"] == "")
                         {
-                            (*edge)["weight"] = (*edge)["data"]["weight"];
+                            ConfigMap &e = *edge;
+                            e.erase("data");
+                            continue;
                         }
+                        if((*edge)["data"].getString().find("weight") == std::string::npos || !decodeData(*edge))
+                            continue;
                     }
-                }
-            }
-
-            // todo: convert to legacy
-            if(model["versions"][0]["components"].hasKey("configuration"))
-            {
-                if(model["versions"][0]["components"]["configuration"].hasKey("nodes"))
-                {
-                    ConfigVector &nodes = model["versions"][0]["components"]["configuration"]["nodes"];
-                    for(ConfigVector::iterator node = nodes.begin(); node != nodes.end(); ++node)
-                        if(node->hasKey("data") && !(*node)["data"].isMap())
+                    if((*edge)["data"].hasKey("weight"))
                     {
-                        (*node)["data"] = ConfigMap::fromYamlString((*node)["data"]);
+                        (*edge)["weight"] = (*edge)["data"]["weight"];
                     }
                 }
             }
         }
-        if (model["versions"][0]["components"].hasKey("configuration"))
-        {
-            if (model["versions"][0]["components"]["configuration"].hasKey("edges"))
-            {
-                ConfigVector &edges = model["versions"][0]["components"]["configuration"]["edges"];
-                std::cout << "BasicModelHelper edges: " << edges.toJsonString() << std::endl;
-                
-                for (ConfigVector::iterator edge = edges.begin(); edge != edges.end(); ++edge)
-                    if (edge->hasKey("data") && !(*edge)["data"].isMap())
-                    {
-                        (*edge)["data"] = ConfigMap::fromYamlString((*edge)["data"]);
-                    }
-            }
-        }
-    
 
         // todo: convert to legacy
+        //    The default configuration is decoded where it is used (see decodeData())
         if(model["versions"][0].hasKey("defaultConfig"))
         {
             model["versions"][0]["defaultConfiguration"] = model["versions"][0]["defaultConfig"];
-            ((ConfigMap)(model["versions"][0])).erase("defaultConfig");
-        }
-
-        if(model["versions"][0].hasKey("defaultConfiguration"))
-        {
-            ConfigMap &map1 = model["versions"][0]["defaultConfiguration"];
-            if(map1.hasKey("data") and !map1["data"].isMap())
-            {
-                map1["data"] = ConfigMap::fromYamlString(map1["data"]);
-            }
+            ConfigMap &version = model["versions"][0];
+            version.erase("defaultConfig");
         }
     }
 
@@ -347,16 +363,8 @@ namespace xrock_gui_model
         std::string domainData = mars::utils::tolower(model["domain"].getString()) + "Data";
         if(model["versions"][0].hasKey("data"))
         {
-            std::string dataString;
-            if(model["versions"][0]["data"].isMap())
-            {
-                dataString = model["versions"][0]["data"].toYamlString();
-            }
-            else
-            {
-                dataString << model["versions"][0]["data"];
-            }
-            model["versions"][0][domainData]["data"] = dataString;
+            encodeData(model["versions"][0]);
+            model["versions"][0][domainData]["data"] = model["versions"][0]["data"];
             ConfigMap &m = model["versions"][0];
             m.erase("data");
         }
@@ -369,13 +377,7 @@ namespace xrock_gui_model
                 ConfigVector &edges = model["versions"][0]["components"]["edges"];
                 for(ConfigVector::iterator edge = edges.begin(); edge != edges.end(); ++edge)
                 {
-                    if(edge->hasKey("data") && (*edge)["data"].isMap())
-                    {
-                        std::string dataString = (*edge)["data"].toYamlString();
-                        ConfigMap &e = *edge;
-                        e.erase("data");
-                        e["data"] = dataString;
-                    }
+                    encodeData(*edge);
                 }
             }
         }
@@ -387,13 +389,7 @@ namespace xrock_gui_model
                 ConfigVector &nodes = model["versions"][0]["components"]["configuration"]["nodes"];
                 for(ConfigVector::iterator node = nodes.begin(); node != nodes.end(); ++node)
                 {
-                    if(node->hasKey("data") && (*node)["data"].isMap())
-                    {
-                        std::string dataString = (*node)["data"].toYamlString();
-                        ConfigMap &n = *node;
-                        n.erase("data");
-                        n["data"] = dataString;
-                    }
+                    encodeData(*node);
                 }
             }
             if (model["versions"][0]["components"]["configuration"].hasKey("edges"))
@@ -401,16 +397,86 @@ namespace xrock_gui_model
                 ConfigVector &edges = model["versions"][0]["components"]["configuration"]["edges"];
                 for (ConfigVector::iterator edge = edges.begin(); edge != edges.end(); ++edge)
                 {
-                    if (edge->hasKey("data") && (*edge)["data"].isMap())
-                    {
-                        std::string dataString = (*edge)["data"].toYamlString();
-                        ConfigMap &n = *edge;
-                        n.erase("data");
-                        n["data"] = dataString;
-                    }
+                    encodeData(*edge);
                 }
             }
         }
     }
 
+    bool BasicModelHelper::decodeData(ConfigItem &item)
+    {
+        if (!item.hasKey("data"))
+            return false;
+        if (item["data"].isMap())
+            return true;
+        const std::string dataString = item["data"].getString();
+        if (dataString.empty())
+        {
+            ConfigMap &map = item;
+            map.erase("data");
+            return false;
+        }
+        item["data"] = ConfigMap::fromYamlString(dataString);
+        rememberEncoding(item, dataString);
+        return true;
+    }
+
+    void BasicModelHelper::encodeData(ConfigItem &item)
+    {
+        if (!item.hasKey("data") || !item["data"].isMap())
+            return;
+        std::string dataString;
+        if (!findEncoding(item, dataString))
+            dataString = item["data"].toYamlString();
+        ConfigMap &map = item;
+        map.erase("data");
+        map["data"] = dataString;
+    }
+
+    bool BasicModelHelper::collapseComponents(ConfigMap &model)
+    {
+        if (!model.hasKey("versions"))
+            return false;
+        bool collapsed = false;
+        for (auto &version : model["versions"])
+        {
+            if (!version.hasKey("components") || !version["components"].isMap())
+                continue;
+            ConfigItem &components = version["components"];
+            if (components.hasKey("collapsed"))
+                continue;
+            ConfigMap summary;
+            summary["collapsed"] = true;
+            summary["numNodes"] = (int)(components.hasKey("nodes") ? components["nodes"].size() : 0);
+            summary["numEdges"] = (int)(components.hasKey("edges") ? components["edges"].size() : 0);
+            version["components"] = summary;
+            collapsed = true;
+        }
+        return collapsed;
+    }
+
+    bool BasicModelHelper::hasComponents(ConfigMap &model)
+    {
+        if (!model.hasKey("versions") || model["versions"].size() == 0 || !model["versions"][0].hasKey("components"))
+            return false;
+        ConfigItem &components = model["versions"][0]["components"];
+        if (components.hasKey("collapsed"))
+            return components.hasKey("numNodes") && (int)components["numNodes"] > 0;
+        return components.hasKey("nodes");
+    }
+
+    bool BasicModelHelper::nodeHasComponents(const ConfigMap &node)
+    {
+        static const ConfigPath componentsPath("model/versions/0/components");
+        static const ConfigPath collapsedPath("collapsed");
+        static const ConfigPath numNodesPath("numNodes");
+        static const ConfigPath nodesPath("nodes");
+        const ConfigItem *components = ConfigMapHelper::findItem(node, componentsPath);
+        if (!components)
+            return false;
+        if (ConfigMapHelper::findItem(*components, collapsedPath))
+            return std::atoi(ConfigMapHelper::getString(*components, numNodesPath, "0").c_str()) > 0;
+        return ConfigMapHelper::findItem(*components, nodesPath) != NULL;
+    }
+
 } // end of namespace xrock_gui_model
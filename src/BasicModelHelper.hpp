@@ -7,6 +7,8 @@
 
 #pragma once
 #include <configmaps/ConfigData.h>
+#include <unordered_map>
+#include <vector>
 
 namespace xrock_gui_model
 {
@@ -17,9 +19,33 @@ namespace xrock_gui_model
         BasicModelHelper() {}
         ~BasicModelHelper() {}
 
+        // Name based index of the ports of a node (port name -> port). The pointers stay valid as long
+        // as the inputs/outputs vectors of the node are not resized.
+        struct PortIndex
+        {
+            std::unordered_map<std::string, configmaps::ConfigItem *> inputs;
+            std::unordered_map<std::string, configmaps::ConfigItem *> outputs;
+        };
+        static void buildPortIndex(configmaps::ConfigMap &node, PortIndex &index);
+
+        // Name based index of the interfaces of a model (positions in versions[0].interfaces).
+        // It is built once per load/save and kept up to date by updateExportedInterfacesToModel().
+        struct InterfaceIndex
+        {
+            // linkToNode -> interfaces linked to the node
+            std::unordered_map<std::string, std::vector<size_t>> byNode;
+            // interface name -> interfaces with that name
+            std::unordered_map<std::string, std::vector<size_t>> byName;
+            // interfaces to be removed by finishExportedInterfacesToModel()
+            std::vector<size_t> removed;
+        };
+        static void buildInterfaceIndex(configmaps::ConfigMap &model, InterfaceIndex &index);
+
         // searches for interfaces of the node that are exporeted to the model and adds these information
         // to the node data, that it can be displayed correctly by the gui
         static void updateExportedInterfacesFromModel(configmaps::ConfigMap &node, configmaps::ConfigMap &model, bool overrideExportName);
+        static void updateExportedInterfacesFromModel(configmaps::ConfigMap &node, configmaps::ConfigMap &model,
+                                                      const InterfaceIndex &interfaces, PortIndex &ports, bool overrideExportName);
 
         // remove all model interfaces that are linked to component interfaces        
         static void clearExportedInterfacesInModel(configmaps::ConfigMap &model);
@@ -27,15 +53,38 @@ namespace xrock_gui_model
         // If node ports are configured in the gui to be exposed we have to create a linked interface
         // in the model itself
         static void updateExportedInterfacesToModel(configmaps::ConfigMap &node, configmaps::ConfigMap &model, bool handleAlias);
+        // Same as above but uses and updates the given index. Interfaces of unexported ports are only marked
+        // in the index and have to be removed by finishExportedInterfacesToModel() after all nodes are processed.
+        static void updateExportedInterfacesToModel(configmaps::ConfigMap &node, configmaps::ConfigMap &model,
+                                                    InterfaceIndex &interfaces, bool handleAlias);
+        static void finishExportedInterfacesToModel(configmaps::ConfigMap &model, InterfaceIndex &interfaces);
 
         // Converts from the old basic model to the new representation:
         //  - Store model information in sub-map
         //  - Convert old domainData keys
         //  - Check the types of annotation data in the model
         static void convertFromLegacyModelFormat(configmaps::ConfigMap &model);
+        // The part of convertFromLegacyModelFormat() which does not touch the "model" sub-map. It is applied to
+        // models of the current format as well, since they may still contain old keys or encoded data.
+        static void normalizeModelData(configmaps::ConfigMap &model);
 
+        // Decodes the "data" entry of the given item (version, edge or configuration entry) in place if it is
+        // still a yaml string. Empty strings are removed. Returns true if the item has a data map afterwards.
+        // Data strings are left untouched by convertFromLegacyModelFormat() until they are accessed this way.
+        static bool decodeData(configmaps::ConfigItem &item);
+        // Turns a "data" map of the given item back into a yaml string. Maps which did not change since they
+        // were decoded by decodeData() get their original string back instead of being serialized again.
+        static void encodeData(configmaps::ConfigItem &item);
         // Reverse conversion from convertFromLegacyModelFormat
         static void convertToLegacyModelFormat(configmaps::ConfigMap &model);
+
+        // Replaces the inner components (nodes, edges, configuration) of all versions of the model by a
+        // summary { collapsed: true, numNodes, numEdges }. Returns true if something was collapsed.
+        static bool collapseComponents(configmaps::ConfigMap &model);
+        // Returns true if the (possibly collapsed) model has inner nodes
+        static bool hasComponents(configmaps::ConfigMap &model);
+        // Same for the model embedded in a node which is only available as const, e.g. a BagelGui node map
+        static bool nodeHasComponents(const configmaps::ConfigMap &node);
     };
 } // end of namespace xrock_gui_model
 
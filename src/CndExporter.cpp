@@ -0,0 +1,770 @@
+/**
+ * \file CndExporter.cpp
+ * \brief Creates the component network description (CND) of a software component model
+ **/
+
+#include "CndExporter.hpp"
+#include "BasicModelHelper.hpp"
+#include "ConfigMapHelper.hpp"
+#include "YamlWriter.hpp"
+#include "Logger.hpp"
+#include "utils/ParallelFor.hpp"
+
+#include <urdf_parser/urdf_parser.h>
+#include <mars/utils/misc.h>
+#include <cctype>
+#include <cstdio>
+#include <list>
+#include <set>
+#include <sstream>
+#include <unordered_map>
+
+using namespace configmaps;
+
+namespace xrock_gui_model
+{
+
+    // Nesting limit of composite parts (protects against recursive models)
+    static const int maxDepth = 32;
+
+    // Decodes the data entry of a configuration and returns the task properties.
+    // The default configurations of the task models wrap the properties in an additional "data" key.
+    static ConfigMap getProperties(ConfigItem &configuration)
+    {
+        ConfigMap properties;
+        try
+        {
+            if (!BasicModelHelper::decodeData(configuration))
+                return properties;
+        }
+        catch (...)
+        {
+            XROCK_LOG(Warning, "CndExporter: invalid configuration data");
+            return properties;
+        }
+        properties = configuration["data"];
+        if (properties.hasKey("data"))
+        {
+            ConfigMap inner;
+            if (properties["data"].isMap())
+                inner = properties["data"];
+            properties.erase("data");
+            for (auto &it : inner)
+            {
+                if (!properties.hasKey(it.first))
+                    properties[it.first] = it.second;
+            }
+        }
+        return properties;
+    }
+
+    // Tasks without deployment node run in an orogen default deployment. The process is named after
+    // the task, so several tasks of the same type get separate processes. The orogen_default_ prefix
+    // marks it as default deployment (see DeploymentGenerator).
+    static std::string defaultProcessName(const std::string &taskName)
+    {
+        return "orogen_default_" + taskName;
+    }
+
+    void CndExporter::clear()
+    {
+        partModels.clear();
+        composites.clear();
+        edges.clear();
+        tasks = ConfigMap();
+        deployments = ConfigMap();
+        taskDeployment.clear();
+        error.clear();
+    }
+
+    void CndExporter::reset()
+    {
+        clear();
+        nodeOutputs.clear();
+        blocks.clear();
+        lastFile.clear();
+        lastContentHash = 0;
+        lastFileStat = FileStat();
+    }
+
+    CndExporter::PartModel *CndExporter::getPartModel(const std::string &domain, const std::string &name,
+                                                      const std::string &version, NodeOutput &output)
+    {
+        const std::string key = domain + "::" + name + "::" + version;
+        auto it = partModels.find(key);
+        if (it == partModels.end())
+        {
+            ConfigMap model = resolver(domain, name, version);
+            if (model.empty() || !model.hasKey("versions"))
+                return NULL;
+            // the content is only hashed if the part has no revision
+            Stamp stamp;
+            stamp.revision = partRevision ? partRevision(domain, name, version) : 0;
+            if (!stamp.revision)
+                stamp.hash = ConfigMapHelper::hash(model);
+            it = partModels.emplace(key, PartModel{domain, name, version, std::move(model), stamp}).first;
+        }
+        output.parts[key] = it->second.stamp;
+        return &it->second;
+    }
+
+    // Returns true if the part models the output was created from did not change. Parts with an
+    // unchanged revision are not resolved at all.
+    bool CndExporter::isCurrent(const NodeOutput &output)
+    {
+        NodeOutput current;
+        for (auto &it : output.parts)
+        {
+            const size_t separator = it.first.find("::");
+            const size_t nameEnd = it.first.rfind("::");
+            if (separator == std::string::npos || nameEnd == separator)
+                return false;
+            const std::string domain = it.first.substr(0, separator);
+            const std::string name = it.first.substr(separator + 2, nameEnd - separator - 2);
+            const std::string version = it.first.substr(nameEnd + 2);
+            if (it.second.revision && partRevision && partRevision(domain, name, version) == it.second.revision)
+                continue;
+            PartModel *part = getPartModel(domain, name, version, current);
+            if (!part || part->stamp != it.second)
+                return false;
+        }
+        return true;
+    }
+
+    // Configuration of the nodes and the configuration set by the parent (see configureComponents)
+    static void collectConfigs(ConfigItem &components, ConfigItem *overrides,
+                               std::map<std::string, ConfigItem *> &configs,
+                               std::map<std::string, ConfigItem *> &parentConfigs)
+    {
+        if (components.hasKey("configuration") && components["configuration"].hasKey("nodes"))
+        {
+            for (auto &config : components["configuration"]["nodes"])
+                configs[config["name"].getString()] = &config;
+        }
+        if (overrides && overrides->isVector())
+        {
+            for (auto &config : *overrides)
+                parentConfigs[config["name"].getString()] = &config;
+        }
+    }
+
+    bool CndExporter::addComponents(ConfigMap &model, const std::string &prefix, ConfigItem *overrides, int depth,
+                                    NodeOutput &output)
+    {
+        if (depth > maxDepth)
+        {
+            error = "component nesting too deep at " + prefix;
+            return false;
+        }
+        ConfigItem &version = model["versions"][0];
+        if (!version.hasKey("components") || !version["components"].isMap())
+            return true;
+        ConfigItem &components = version["components"];
+
+        std::map<std::string, ConfigItem *> configs, parentConfigs;
+        collectConfigs(components, overrides, configs, parentConfigs);
+        if (components.hasKey("nodes"))
+        {
+            for (auto &node : components["nodes"])
+            {
+                if (!addNode(node, prefix, configs, parentConfigs, depth, output))
+                    return false;
+            }
+        }
+        addEdges(components, prefix, output);
+        return true;
+    }
+
+    bool CndExporter::addNode(ConfigItem &node, const std::string &prefix,
+                              std::map<std::string, ConfigItem *> &configs,
+                              std::map<std::string, ConfigItem *> &parentConfigs, int depth, NodeOutput &output)
+    {
+        const std::string name = node["name"].getString();
+        const std::string fullName = prefix + name;
+        ConfigItem &nodeModel = node["model"];
+        const std::string modelName = nodeModel["name"].getString();
+        const std::string modelVersion = nodeModel.hasKey("version") ? nodeModel["version"].getString()
+                                                                      : nodeModel["versions"][0]["name"].getString();
+        PartModel *partModel = getPartModel(nodeModel["domain"].getString(), modelName, modelVersion, output);
+        if (!partModel)
+        {
+            error = "unknown component model " + modelName + " " + modelVersion + " of " + fullName;
+            return false;
+        }
+        ConfigMap *part = &partModel->model;
+
+        // The node configuration replaces the default configuration of the part,
+        // the configuration of the parent replaces both
+        ConfigMap properties;
+        ConfigItem *submodel = NULL;
+        if ((*part)["versions"][0].hasKey("defaultConfiguration"))
+        {
+            ConfigItem defaults = (*part)["versions"][0]["defaultConfiguration"];
+            properties = getProperties(defaults);
+        }
+        for (auto *source : {&configs, &parentConfigs})
+        {
+            auto it = source->find(name);
+            if (it == source->end())
+                continue;
+            ConfigItem &config = *it->second;
+            if (config.hasKey("data"))
+                properties = getProperties(config);
+            if (config.hasKey("submodel"))
+                submodel = &config["submodel"];
+        }
+
+        if (BasicModelHelper::hasComponents(*part))
+        {
+            output.composites[fullName] = nodeModel["domain"].getString() + "::" + modelName + "::" + modelVersion;
+            if (!addComponents(*part, fullName + ".", submodel, depth + 1, output))
+                return false;
+        }
+        else if ((*part)["type"].getString() == "software::Deployment")
+        {
+            ConfigMap &deployment = output.deployments[fullName];
+            deployment = properties;
+            if (!deployment.hasKey("process_name"))
+                deployment["process_name"] = fullName;
+            deployment["taskList"] = ConfigMap();
+        }
+        else
+        {
+            ConfigMap task;
+            task["type"] = modelName;
+            for (auto &it : properties)
+            {
+                if (it.first == "deployment")
+                    output.taskDeployment[fullName] = it.second.getString();
+                else
+                    task[it.first] = it.second;
+            }
+            output.tasks[fullName] = task;
+        }
+        return true;
+    }
+
+    void CndExporter::addEdges(ConfigItem &components, const std::string &prefix, NodeOutput &output)
+    {
+        if (!components.hasKey("edges"))
+            return;
+        std::map<std::string, ConfigItem *> edgeConfigs;
+        if (components.hasKey("configuration") && components["configuration"].hasKey("edges"))
+        {
+            for (auto &config : components["configuration"]["edges"])
+                edgeConfigs[config["name"].getString()] = &config;
+        }
+        for (auto &edge : components["edges"])
+        {
+            PendingEdge pending;
+            pending.from = {prefix + edge["from"]["name"].getString(), edge["from"]["interface"].getString()};
+            pending.to = {prefix + edge["to"]["name"].getString(), edge["to"]["interface"].getString()};
+            std::string name = edge.hasKey("name") ? edge["name"].getString() : "";
+            if (name.empty())
+            {
+                name = edge["from"]["name"].getString() + "." + pending.from.interface + "_" +
+                       edge["to"]["name"].getString() + "." + pending.to.interface;
+            }
+            pending.name = prefix + name;
+            if (edge.hasKey("data") && BasicModelHelper::decodeData(edge))
+                pending.data = edge["data"];
+            auto config = edgeConfigs.find(name);
+            if (config != edgeConfigs.end() && BasicModelHelper::decodeData(*config->second))
+            {
+                for (auto &it : (ConfigMap &)(*config->second)["data"])
+                    pending.data[it.first] = it.second;
+            }
+            output.edges.push_back(std::move(pending));
+        }
+    }
+
+    // Follows the exported interfaces of composite nodes down to the task which provides the port
+    bool CndExporter::resolveEndpoint(Endpoint &endpoint)
+    {
+        for (int depth = 0; depth <= maxDepth; ++depth)
+        {
+            auto composite = composites.find(endpoint.node);
+            if (composite == composites.end())
+                return tasks.hasKey(endpoint.node);
+            ConfigItem &version = (*composite->second)["versions"][0];
+            if (!version.hasKey("interfaces"))
+                return false;
+            bool found = false;
+            for (auto &interface : version["interfaces"])
+            {
+                if (interface.hasKey("linkToNode") && interface["name"].getString() == endpoint.interface)
+                {
+                    endpoint.node += "." + interface["linkToNode"].getString();
+                    endpoint.interface = interface["linkToInterface"].getString();
+                    found = true;
+                    break;
+                }
+            }
+            if (!found)
+                return false;
+        }
+        return false;
+    }
+
+    bool CndExporter::createCnd(ConfigMap &model, ConfigMap &cnd)
+    {
+        clear();
+        if (!model.hasKey("versions") || model["versions"].size() == 0)
+        {
+            error = "invalid model";
+            return false;
+        }
+        ConfigItem &version = model["versions"][0];
+        if (version.hasKey("components") && version["components"].isMap())
+        {
+            ConfigItem &components = version["components"];
+            std::map<std::string, ConfigItem *> configs, parentConfigs;
+            collectConfigs(components, NULL, configs, parentConfigs);
+
+            // Flatten the top level nodes which changed since the last export, reuse the others
+            std::map<std::string, NodeOutput> outputs;
+            // outputs of nodes with duplicate names, they are not kept for the next export
+            std::list<NodeOutput> duplicates;
+            std::vector<NodeOutput *> order;
+            size_t reused = 0;
+            if (components.hasKey("nodes"))
+            {
+                for (auto &node : components["nodes"])
+                {
+                    const std::string name = node["name"].getString();
+                    // the node entry and configuration are only hashed if the node has no revision
+                    Stamp stamp;
+                    stamp.revision = nodeRevision ? nodeRevision(name) : 0;
+                    if (!stamp.revision)
+                    {
+                        std::ostringstream input;
+                        ConfigMapHelper::writeBinary(input, node);
+                        auto config = configs.find(name);
+                        if (config != configs.end())
+                            ConfigMapHelper::writeBinary(input, *config->second);
+                        stamp.hash = std::hash<std::string>()(input.str());
+                    }
+
+                    const bool duplicate = outputs.find(name) != outputs.end();
+                    if (duplicate)
+                        duplicates.emplace_back();
+                    NodeOutput &output = duplicate ? duplicates.back() : outputs[name];
+                    auto previous = nodeOutputs.find(name);
+                    if (!duplicate && previous != nodeOutputs.end() && previous->second.stamp == stamp &&
+                        isCurrent(previous->second))
+                    {
+                        output = std::move(previous->second);
+                        ++reused;
+                    }
+                    else
+                    {
+                        output.stamp = stamp;
+                        if (!addNode(node, "", configs, parentConfigs, 0, output))
+                        {
+                            nodeOutputs.clear();
+                            return false;
+                        }
+                    }
+                    order.push_back(&output);
+                }
+            }
+            NodeOutput topLevel;
+            addEdges(components, "", topLevel);
+            order.push_back(&topLevel);
+
+            for (NodeOutput *output : order)
+            {
+                for (auto &it : output->tasks)
+                    tasks[it.first] = it.second;
+                for (auto &it : output->deployments)
+                    deployments[it.first] = it.second;
+                for (auto &it : output->taskDeployment)
+                    taskDeployment[it.first] = it.second;
+                for (auto &it : output->composites)
+                    composites[it.first] = &partModels[it.second].model;
+                edges.insert(edges.end(), output->edges.begin(), output->edges.end());
+            }
+            nodeOutputs.swap(outputs);
+            XROCK_LOG(Debug, "CndExporter: reused " << reused << " of " << order.size() - 1 << " nodes");
+        }
+        else
+        {
+            nodeOutputs.clear();
+        }
+
+        ConfigMap connections;
+        for (auto &edge : edges)
+        {
+            if (!resolveEndpoint(edge.from) || !resolveEndpoint(edge.to))
+            {
+                XROCK_LOG(Warning, "CndExporter: skip connection " << edge.name << ", its interfaces do not belong to tasks");
+                continue;
+            }
+            ConfigMap &connection = connections[edge.name];
+            connection["from"]["task_id"] = edge.from.node;
+            connection["from"]["port_name"] = edge.from.interface;
+            connection["to"]["task_id"] = edge.to.node;
+            connection["to"]["port_name"] = edge.to.interface;
+            if (!edge.data.empty())
+                connection["data"] = edge.data;
+        }
+
+        // Assign the tasks to their deployments; the deployment is searched in the scope of the task first
+        for (auto &it : tasks)
+        {
+            const std::string &taskName = it.first;
+            const std::string type = it.second["type"].getString();
+            auto assigned = taskDeployment.find(taskName);
+            if (assigned != taskDeployment.end())
+            {
+                const size_t scope = taskName.rfind('.');
+                const std::string scoped = scope == std::string::npos ? assigned->second
+                                                                      : taskName.substr(0, scope + 1) + assigned->second;
+                const std::string &deploymentName = deployments.hasKey(scoped) ? scoped : assigned->second;
+                if (deployments.hasKey(deploymentName))
+                {
+                    deployments[deploymentName]["taskList"][taskName] = type;
+                    continue;
+                }
+                XROCK_LOG(Warning, "CndExporter: unknown deployment " << assigned->second << " of " << taskName);
+            }
+            ConfigMap &deployment = deployments[taskName + "_deployment"];
+            deployment["deployer"] = "orogen";
+            deployment["hostID"] = "local";
+            deployment["process_name"] = defaultProcessName(taskName);
+            deployment["taskList"][taskName] = type;
+        }
+
+        cnd = ConfigMap();
+        cnd["tasks"] = tasks;
+        cnd["connections"] = connections;
+        cnd["deployments"] = deployments;
+        return true;
+    }
+
+    bool CndExporter::enhanceTf(ConfigMap &cnd, const std::string &urdfFile)
+    {
+        urdf::ModelInterfaceSharedPtr urdfModel = urdf::parseURDFFile(urdfFile);
+        if (!urdfModel)
+        {
+            error = "could not parse urdf file " + urdfFile;
+            return false;
+        }
+        ConfigVector staticTransforms, dynamicTransforms;
+        for (auto &it : urdfModel->joints_)
+        {
+            const urdf::JointSharedPtr &joint = it.second;
+            const urdf::Pose &pose = joint->parent_to_joint_origin_transform;
+            ConfigMap transform;
+            transform["from"] = joint->parent_link_name;
+            transform["to"] = joint->child_link_name;
+            transform["translation"][0] = pose.position.x;
+            transform["translation"][1] = pose.position.y;
+            transform["translation"][2] = pose.position.z;
+            transform["rotation"][0] = pose.rotation.x;
+            transform["rotation"][1] = pose.rotation.y;
+            transform["rotation"][2] = pose.rotation.z;
+            transform["rotation"][3] = pose.rotation.w;
+            if (joint->type == urdf::Joint::FIXED)
+            {
+                staticTransforms.push_back(transform);
+            }
+            else
+            {
+                transform["joint"] = joint->name;
+                dynamicTransforms.push_back(transform);
+            }
+        }
+        cnd["transformer"]["static_transforms"] = staticTransforms;
+        cnd["transformer"]["dynamic_transforms"] = dynamicTransforms;
+        return true;
+    }
+
+    bool CndExporter::writeCnd(ConfigMap &cnd, const std::string &filename)
+    {
+        // Format the entries of the sections separately, unchanged entries reuse their yaml
+        // of the last export
+        std::map<std::string, Block> current;
+        std::vector<Block *> parts;
+        size_t contentHash = 0;
+        for (auto &section : cnd)
+        {
+            std::vector<std::pair<std::string, ConfigItem *>> entries;
+            const bool isSection = !section.second.isMap() || section.second.size() == 0;
+            if (!isSection)
+            {
+                Block &header = current[section.first];
+                header.hash = 0;
+                header.text = YamlWriter::formatString(section.first) + ":\n";
+                parts.push_back(&header);
+                for (auto &entry : (ConfigMap &)section.second)
+                    entries.emplace_back(section.first + '\0' + entry.first, &entry.second);
+            }
+            else
+            {
+                entries.emplace_back(std::string(1, '\0') + section.first, &section.second);
+            }
+            for (auto &entry : entries)
+            {
+                const size_t hash = ConfigMapHelper::hash(*entry.second);
+                Block &block = current[entry.first];
+                auto previous = blocks.find(entry.first);
+                if (previous != blocks.end() && previous->second.hash == hash)
+                {
+                    block = std::move(previous->second);
+                }
+                else
+                {
+                    std::ostringstream text;
+                    YamlWriter writer(text);
+                    writer.writeEntry(isSection ? section.first : entry.first.substr(section.first.size() + 1),
+                                      *entry.second, isSection ? 0 : 1);
+                    block.hash = hash;
+                    block.text = text.str();
+                }
+                parts.push_back(&block);
+                contentHash ^= std::hash<std::string>()(entry.first) + block.hash + 0x9e3779b9 + (contentHash << 6) + (contentHash >> 2);
+            }
+        }
+        blocks.swap(current);
+
+        // Skip the write if the file still has the content of the last export
+        FileStat fileStat;
+        if (FileStat::read(filename, fileStat) && filename == lastFile && contentHash == lastContentHash &&
+            fileStat == lastFileStat)
+        {
+            XROCK_LOG(Debug, "CndExporter: " << filename << " is up to date");
+            return true;
+        }
+        lastFile.clear();
+
+        const bool written = YamlWriter::writeFile(filename, [&](std::ostream &out)
+                                                   {
+            if (cnd.empty())
+                out << "{}\n";
+            for (Block *block : parts)
+                out.write(block->text.data(), block->text.size()); },
+                                                   error);
+        if (!written)
+            return false;
+        if (FileStat::read(filename, lastFileStat))
+        {
+            lastFile = filename;
+            lastContentHash = contentHash;
+        }
+        return true;
+    }
+
+    // The cnd file name of a partition: characters other than [A-Za-z0-9_.-] are replaced,
+    // names which collide after that get a number
+    static std::string partitionFileName(const std::string &partition, std::set<std::string> &used)
+    {
+        std::string name = partition;
+        for (char &c : name)
+        {
+            if (!isalnum((unsigned char)c) && c != '_' && c != '-' && c != '.')
+                c = '_';
+        }
+        if (name.empty() || name[0] == '.')
+            name = "_" + name;
+        std::string fileName = name + ".cnd";
+        for (int i = 2; !used.insert(fileName).second; ++i)
+            fileName = name + "_" + std::to_string(i) + ".cnd";
+        return fileName;
+    }
+
+    const std::string CndExporter::unassignedPartition = "<unassigned>";
+
+    bool CndExporter::partitionCnd(ConfigMap &cnd, const std::string &partitionKey,
+                                   std::map<std::string, ConfigMap> &partitions, ConfigMap &manifest)
+    {
+        partitions.clear();
+        manifest = ConfigMap();
+        for (const char *section : {"tasks", "connections", "deployments"})
+        {
+            if (cnd.hasKey(section) && !cnd[section].isMap() && cnd[section].size() > 0)
+                return false;
+        }
+        ConfigMap noEntries;
+        ConfigMap &tasks = cnd.hasKey("tasks") && cnd["tasks"].isMap() ? (ConfigMap &)cnd["tasks"] : noEntries;
+        ConfigMap &connections = cnd.hasKey("connections") && cnd["connections"].isMap() ? (ConfigMap &)cnd["connections"] : noEntries;
+        ConfigMap &deployments = cnd.hasKey("deployments") && cnd["deployments"].isMap() ? (ConfigMap &)cnd["deployments"] : noEntries;
+
+        manifest["partition_key"] = partitionKey;
+        manifest["partitions"] = ConfigMap();
+        std::set<std::string> fileNames;
+        auto getPartition = [&](const std::string &name) -> ConfigMap &
+        {
+            auto it = partitions.find(name);
+            if (it != partitions.end())
+                return it->second;
+            ConfigMap &partition = partitions[name];
+            partition["tasks"] = ConfigMap();
+            partition["connections"] = ConfigMap();
+            partition["deployments"] = ConfigMap();
+            // the remaining sections (e.g. transformer) apply to all partitions
+            for (auto &section : cnd)
+            {
+                if (section.first != "tasks" && section.first != "connections" && section.first != "deployments")
+                    partition[section.first] = section.second;
+            }
+            manifest["partitions"][name]["file"] = partitionFileName(name, fileNames);
+            manifest["partitions"][name]["deployments"] = ConfigVector();
+            return partition;
+        };
+
+        // Partition of each deployment (empty: unassigned). The unassigned partition must not merge
+        // with a partition of the same name.
+        std::vector<std::string> deploymentPartition;
+        std::set<std::string> assigned;
+        deploymentPartition.reserve(deployments.size());
+        for (auto &it : deployments)
+        {
+            std::string name = it.first;
+            if (partitionKey != "deployment")
+                name = it.second.hasKey(partitionKey) ? it.second[partitionKey].getString() : std::string();
+            if (!name.empty())
+                assigned.insert(name);
+            deploymentPartition.push_back(name);
+        }
+        std::string unassigned = unassignedPartition;
+        for (int i = 2; assigned.count(unassigned); ++i)
+            unassigned = unassignedPartition + "_" + std::to_string(i);
+        manifest["unassigned_partition"] = unassigned;
+
+        std::unordered_map<std::string, std::string> taskPartition;
+        size_t index = 0;
+        for (auto &it : deployments)
+        {
+            const std::string &name = deploymentPartition[index].empty() ? unassigned : deploymentPartition[index];
+            ++index;
+            getPartition(name)["deployments"][it.first] = it.second;
+            manifest["partitions"][name]["deployments"].push_back(ConfigAtom(it.first));
+            if (!it.second.hasKey("taskList") || !it.second["taskList"].isMap())
+                continue;
+            for (auto &task : (ConfigMap &)it.second["taskList"])
+                taskPartition.emplace(task.first, name);
+        }
+        for (auto &it : tasks)
+        {
+            auto partition = taskPartition.find(it.first);
+            if (partition == taskPartition.end())
+            {
+                XROCK_LOG(Warning, "CndExporter: task " << it.first << " has no deployment, it is added to the partition " << unassigned);
+                partition = taskPartition.emplace(it.first, unassigned).first;
+            }
+            getPartition(partition->second)["tasks"][it.first] = it.second;
+        }
+
+        manifest["cross_partition_connections"] = ConfigMap();
+        for (auto &it : connections)
+        {
+            ConfigItem &connection = it.second;
+            if (!connection.hasKey("from") || !connection.hasKey("to"))
+                continue;
+            auto from = taskPartition.find(connection["from"]["task_id"].getString());
+            auto to = taskPartition.find(connection["to"]["task_id"].getString());
+            if (from == taskPartition.end() || to == taskPartition.end())
+            {
+                XROCK_LOG(Warning, "CndExporter: skip connection " << it.first << " between unknown tasks");
+                continue;
+            }
+            if (from->second == to->second)
+            {
+                getPartition(from->second)["connections"][it.first] = connection;
+                continue;
+            }
+            ConfigItem &cross = manifest["cross_partition_connections"][it.first];
+            cross = connection;
+            cross["from"]["partition"] = from->second;
+            cross["to"]["partition"] = to->second;
+        }
+        return true;
+    }
+
+    bool CndExporter::exportPartitions(ConfigMap &model, const std::string &folder, const std::string &partitionKey,
+                                       const std::string &urdfFile, size_t numThreads)
+    {
+        ConfigMap cnd;
+        if (!createCnd(model, cnd))
+            return false;
+        if (!urdfFile.empty() && !enhanceTf(cnd, urdfFile))
+            return false;
+        std::map<std::string, ConfigMap> partitions;
+        ConfigMap manifest;
+        if (!partitionCnd(cnd, partitionKey, partitions, manifest))
+        {
+            error = "invalid cnd";
+            return false;
+        }
+        mars::utils::createDirectory(folder);
+        if (!mars::utils::pathExists(folder))
+        {
+            error = "cannot create " + folder;
+            return false;
+        }
+
+        // the partitions are independent, so they are written in parallel
+        std::vector<std::pair<std::string, ConfigMap *>> files;
+        files.reserve(partitions.size());
+        for (auto &it : partitions)
+            files.emplace_back(folder + "/" + manifest["partitions"][it.first]["file"].getString(), &it.second);
+        std::vector<std::string> errors(files.size());
+        parallelFor(files.size(), [&](size_t i)
+                    { YamlWriter::writeFile(files[i].first, *files[i].second, errors[i]); },
+                    numThreads);
+        for (auto &fileError : errors)
+        {
+            if (!fileError.empty())
+            {
+                error = fileError;
+                return false;
+            }
+        }
+
+        // Remove the partition files of the previous export which were not written again. Only plain
+        // file names from the manifest are removed.
+        const std::string manifestFile = folder + "/partitions.yml";
+        if (mars::utils::pathExists(manifestFile))
+        {
+            std::set<std::string> written;
+            for (auto &it : partitions)
+                written.insert(manifest["partitions"][it.first]["file"].getString());
+            try
+            {
+                ConfigMap previous = ConfigMap::fromYamlFile(manifestFile);
+                if (previous.hasKey("partitions") && previous["partitions"].isMap())
+                {
+                    for (auto &it : (ConfigMap &)previous["partitions"])
+                    {
+                        if (!it.second.isMap() || !it.second.hasKey("file"))
+                            continue;
+                        const std::string file = it.second["file"].getString();
+                        if (file.empty() || file.find('/') != std::string::npos || file == "partitions.yml" ||
+                            file == "." || file == ".." || written.count(file))
+                            continue;
+                        if (std::remove((folder + "/" + file).c_str()) == 0)
+                            XROCK_LOG(Info, "CndExporter: removed stale partition " << it.first << " (" << file << ")");
+                    }
+                }
+            }
+            catch (...)
+            {
+                XROCK_LOG(Warning, "CndExporter: cannot read the previous " << manifestFile);
+            }
+        }
+        XROCK_LOG(Info, "CndExporter: exported " << partitions.size() << " partitions by " << partitionKey << " to " << folder);
+        return YamlWriter::writeFile(manifestFile, manifest, error);
+    }
+
+    bool CndExporter::exportCnd(ConfigMap &model, const std::string &filename, const std::string &urdfFile)
+    {
+        ConfigMap cnd;
+        if (!createCnd(model, cnd))
+            return false;
+        if (!urdfFile.empty() && !enhanceTf(cnd, urdfFile))
+            return false;
+        return writeCnd(cnd, filename);
+    }
+
+} // end of namespace xrock_gui_model
@@ -0,0 +1,160 @@
+/**
+ * \file CndExporter.hpp
+ * \brief Creates the component network description (CND) of a software component model
+ **/
+
+#pragma once
+#include "utils/FileStat.hpp"
+#include <configmaps/ConfigData.h>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace xrock_gui_model
+{
+
+    // The exporter keeps the state of its last export, so repeated exports of the same model
+    // only redo the changed parts: the flattened components of top level nodes whose entry,
+    // configuration and part models did not change are reused, only changed cnd entries are
+    // formatted again and a file whose content did not change is not rewritten. The output is
+    // byte identical to a full export. Nodes and part models are compared by the revisions given
+    // by setRevisions(), by the hash of their content if no revision is known.
+    class CndExporter
+    {
+    public:
+        // Returns the complete component model of a part or an empty map if it is unknown
+        typedef std::function<configmaps::ConfigMap(const std::string &domain, const std::string &name,
+                                                    const std::string &version)>
+            ModelResolver;
+        // Revision of a top level node (entry and configuration) or of a part model. The content is
+        // unchanged as long as the revision is, 0 means unknown.
+        typedef std::function<uint64_t(const std::string &nodeName)> NodeRevision;
+        typedef std::function<uint64_t(const std::string &domain, const std::string &name, const std::string &version)>
+            PartRevision;
+
+        explicit CndExporter(ModelResolver resolver) : resolver(resolver) {}
+
+        void setResolver(ModelResolver resolver) { this->resolver = resolver; }
+        void setRevisions(NodeRevision nodeRevision, PartRevision partRevision)
+        {
+            this->nodeRevision = nodeRevision;
+            this->partRevision = partRevision;
+        }
+
+        // Creates the CND (tasks, connections, deployments) of a model as returned by
+        // ComponentModelInterface::getModelInfo(). The inner components of composite parts are
+        // flattened, their tasks are named <node>.<inner node>. Tasks which are not assigned to a
+        // deployment node (configuration key "deployment") get an orogen default deployment.
+        bool createCnd(configmaps::ConfigMap &model, configmaps::ConfigMap &cnd);
+        // Adds the joint transforms of the urdf file (tf_enhance): fixed joints as static
+        // transforms, all other joints as dynamic transforms.
+        bool enhanceTf(configmaps::ConfigMap &cnd, const std::string &urdfFile);
+        // createCnd(), enhanceTf() if a urdf file is given and writeCnd()
+        bool exportCnd(configmaps::ConfigMap &model, const std::string &filename, const std::string &urdfFile = "");
+        // Streams the cnd to the file; the file is replaced only if it was written completely
+        bool writeCnd(configmaps::ConfigMap &cnd, const std::string &filename);
+        // Splits the cnd of the model into partitions and writes <partition>.cnd for each of them
+        // into folder (created if needed), formatted and written on numThreads workers (0: one per
+        // core). A task belongs to the partition given by the partitionKey entry of its deployment
+        // (e.g. "hostID") or, for the key "deployment", to the partition named after its deployment.
+        // Deployments without partitionKey entry and tasks without deployment go to the unassigned
+        // partition (see unassignedPartition), its name is stored as unassigned_partition in the manifest.
+        // Connections between partitions are left out of the partition cnds and are listed in
+        // <folder>/partitions.yml together with the partitions and their files. Partition files
+        // listed in the previous partitions.yml which are not written again are removed.
+        bool exportPartitions(configmaps::ConfigMap &model, const std::string &folder, const std::string &partitionKey,
+                              const std::string &urdfFile = "", size_t numThreads = 0);
+        // The partitioning of exportPartitions(): partition name -> cnd and the manifest
+        static bool partitionCnd(configmaps::ConfigMap &cnd, const std::string &partitionKey,
+                                 std::map<std::string, configmaps::ConfigMap> &partitions,
+                                 configmaps::ConfigMap &manifest);
+        // Name of the partition of unassigned deployments and tasks. The brackets are not valid in host or
+        // deployment names; a partition which uses the name anyway gets a different unassigned partition.
+        static const std::string unassignedPartition;
+        // Drops the state of the last export
+        void reset();
+
+        const std::string &getError() const { return error; }
+
+    private:
+        struct Endpoint
+        {
+            std::string node, interface;
+        };
+        struct PendingEdge
+        {
+            std::string name;
+            Endpoint from, to;
+            configmaps::ConfigMap data;
+        };
+        // Identifies the content of a node or part model: its revision if known, otherwise its hash
+        struct Stamp
+        {
+            uint64_t revision = 0;
+            size_t hash = 0;
+
+            bool operator==(const Stamp &other) const { return revision == other.revision && hash == other.hash; }
+            bool operator!=(const Stamp &other) const { return !(*this == other); }
+        };
+        struct PartModel
+        {
+            std::string domain, name, version;
+            configmaps::ConfigMap model;
+            Stamp stamp;
+        };
+        // The flattened components of a top level node
+        struct NodeOutput
+        {
+            // the node entry and its configuration
+            Stamp stamp;
+            // key -> part models the output was created from
+            std::map<std::string, Stamp> parts;
+            configmaps::ConfigMap tasks, deployments;
+            std::map<std::string, std::string> taskDeployment;
+            // flattened name of composite nodes -> key of their part model
+            std::map<std::string, std::string> composites;
+            std::vector<PendingEdge> edges;
+        };
+        // Formatted yaml of a cnd entry
+        struct Block
+        {
+            size_t hash;
+            std::string text;
+        };
+
+        PartModel *getPartModel(const std::string &domain, const std::string &name, const std::string &version,
+                                NodeOutput &output);
+        bool isCurrent(const NodeOutput &output);
+        bool addComponents(configmaps::ConfigMap &model, const std::string &prefix,
+                           configmaps::ConfigItem *overrides, int depth, NodeOutput &output);
+        bool addNode(configmaps::ConfigItem &node, const std::string &prefix,
+                     std::map<std::string, configmaps::ConfigItem *> &configs,
+                     std::map<std::string, configmaps::ConfigItem *> &parentConfigs, int depth, NodeOutput &output);
+        void addEdges(configmaps::ConfigItem &components, const std::string &prefix, NodeOutput &output);
+        bool resolveEndpoint(Endpoint &endpoint);
+        void clear();
+
+        ModelResolver resolver;
+        NodeRevision nodeRevision;
+        PartRevision partRevision;
+        // Part models by domain/name/version, resolved once per export
+        std::map<std::string, PartModel> partModels;
+        // Flattened name of composite nodes -> their part model
+        std::map<std::string, configmaps::ConfigMap *> composites;
+        std::vector<PendingEdge> edges;
+        configmaps::ConfigMap tasks, deployments;
+        // Task -> name of the deployment node given in its configuration
+        std::map<std::string, std::string> taskDeployment;
+        // State of the last export: the outputs of the top level nodes, the formatted cnd entries
+        // (by section and name) and the written file
+        std::map<std::string, NodeOutput> nodeOutputs;
+        std::map<std::string, Block> blocks;
+        std::string lastFile;
+        size_t lastContentHash = 0;
+        FileStat lastFileStat;
+        std::string error;
+    };
+
+} // end of namespace xrock_gui_model
@@ -0,0 +1,380 @@
+/**
+ * \file CndImporter.cpp
+ * \brief Creates a component model from a component network description (CND) file
+ **/
+
+#include "CndImporter.hpp"
+#include "GraphLayout.hpp"
+#include "Logger.hpp"
+
+#include <mars/utils/misc.h>
+#include <yaml-cpp/eventhandler.h>
+#include <yaml-cpp/exceptions.h>
+#include <yaml-cpp/parser.h>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <unordered_map>
+
+using namespace configmaps;
+
+namespace xrock_gui_model
+{
+
+    namespace
+    {
+        // Builds the entries of the top level sections (e.g. tasks/<name>) from the yaml events and
+        // hands each entry to the callback as soon as it is complete, so the document is never held
+        // in memory as a whole. Anchored nodes are kept, an alias is replaced by a copy of its node.
+        class SectionReader : public YAML::EventHandler
+        {
+        public:
+            typedef std::function<void(const std::string &section, const std::string &key, ConfigItem &entry)> Callback;
+
+            // typed: plain scalars become numbers/booleans where possible, otherwise they stay untyped (as written)
+            SectionReader(Callback callback, bool typed) : callback(callback), typed(typed) {}
+
+            void OnDocumentStart(const YAML::Mark &) override {}
+            void OnDocumentEnd() override {}
+            void OnNull(const YAML::Mark &, YAML::anchor_t anchor) override { addValue(ConfigItem(nullAtom()), anchor); }
+
+            void OnAlias(const YAML::Mark &mark, YAML::anchor_t anchor) override
+            {
+                auto it = anchors.find(anchor);
+                if (it == anchors.end())
+                    throw YAML::ParserException(mark, "alias of an unknown or unfinished anchor");
+                if (expectsKey())
+                {
+                    if (!it->second.isAtom())
+                        throw YAML::ParserException(mark, "alias of a map or sequence used as key");
+                    setKey(it->second.getString());
+                    return;
+                }
+                addValue(it->second, YAML::NullAnchor);
+            }
+
+            void OnScalar(const YAML::Mark &, const std::string &tag, YAML::anchor_t anchor, const std::string &value) override
+            {
+                if (expectsKey())
+                {
+                    if (anchor != YAML::NullAnchor)
+                        anchors[anchor] = ConfigItem(ConfigAtom(value));
+                    setKey(value);
+                    return;
+                }
+                addValue(ConfigItem(toAtom(tag, value)), anchor);
+            }
+
+            void OnSequenceStart(const YAML::Mark &, const std::string &, YAML::anchor_t anchor, YAML::EmitterStyle::value) override
+            {
+                beginContainer(false, anchor);
+            }
+
+            void OnMapStart(const YAML::Mark &, const std::string &, YAML::anchor_t anchor, YAML::EmitterStyle::value) override
+            {
+                beginContainer(true, anchor);
+            }
+
+            void OnSequenceEnd() override { endContainer(); }
+            void OnMapEnd() override { endContainer(); }
+
+        private:
+            struct Frame
+            {
+                ConfigItem *item;
+                bool isMap;
+                bool expectKey;
+                std::string key;
+                YAML::anchor_t anchor;
+            };
+
+            bool expectsKey() const
+            {
+                return !stack.empty() && stack.back().isMap && stack.back().expectKey;
+            }
+
+            void setKey(const std::string &key)
+            {
+                stack.back().key = key;
+                stack.back().expectKey = false;
+            }
+
+            ConfigAtom nullAtom() const
+            {
+                return typed ? ConfigAtom(std::string()) : ConfigAtom();
+            }
+
+            // Plain scalars are typed like the yaml core schema does, quoted scalars stay strings
+            ConfigAtom toAtom(const std::string &tag, const std::string &value) const
+            {
+                if (tag == "!")
+                    return ConfigAtom(value);
+                if (!typed)
+                {
+                    ConfigAtom atom;
+                    atom.setUnparsedString(value);
+                    return atom;
+                }
+                if (value == "true" || value == "True" || value == "TRUE")
+                    return ConfigAtom(true);
+                if (value == "false" || value == "False" || value == "FALSE")
+                    return ConfigAtom(false);
+                if (value.empty() || value == "~" || value == "null")
+                    return ConfigAtom(std::string());
+                const char *begin = value.c_str();
+                char *end;
+                errno = 0;
+                long number = strtol(begin, &end, 10);
+                if (*end == '\0' && errno == 0)
+                {
+                    if (number >= INT_MIN && number <= INT_MAX)
+                        return ConfigAtom((int)number);
+                    if (number > 0)
+                        return ConfigAtom((unsigned long)number);
+                }
+                double real = strtod(begin, &end);
+                if (*end == '\0')
+                    return ConfigAtom(real);
+                return ConfigAtom(value);
+            }
+
+            // Returns the item which receives the next value of the current container
+            ConfigItem *nextTarget(bool &isEntry)
+            {
+                isEntry = false;
+                if (stack.empty())
+                    return &document;
+                Frame &top = stack.back();
+                if (top.isMap)
+                {
+                    top.expectKey = true;
+                    // entries of the top level sections are streamed
+                    if (stack.size() == 2)
+                    {
+                        isEntry = true;
+                        entryKey = top.key;
+                        entry = ConfigItem();
+                        return &entry;
+                    }
+                    // the sections themselves are not stored in the document
+                    if (stack.size() == 1)
+                    {
+                        section = top.key;
+                        sectionItem = ConfigItem();
+                        return &sectionItem;
+                    }
+                    return &(*top.item)[top.key];
+                }
+                ConfigVector &vector = *top.item;
+                vector.push_back(ConfigItem());
+                return &vector.back();
+            }
+
+            void addValue(const ConfigItem &value, YAML::anchor_t anchor)
+            {
+                if (anchor != YAML::NullAnchor)
+                    anchors[anchor] = value;
+                bool isEntry;
+                ConfigItem *target = nextTarget(isEntry);
+                *target = value;
+                if (isEntry)
+                {
+                    if (stack.back().anchor != YAML::NullAnchor)
+                        (*stack.back().item)[entryKey] = entry;
+                    callback(section, entryKey, entry);
+                }
+                // a whole section given by an alias is streamed entry by entry as well
+                else if (target == &sectionItem && sectionItem.isMap())
+                {
+                    for (auto &it : (ConfigMap &)sectionItem)
+                        callback(section, it.first, it.second);
+                }
+            }
+
+            void beginContainer(bool isMap, YAML::anchor_t anchor)
+            {
+                bool isEntry;
+                ConfigItem *target = nextTarget(isEntry);
+                if (isMap)
+                    *target = ConfigMap();
+                else
+                    *target = ConfigVector();
+                stack.push_back(Frame{target, isMap, isMap, std::string(), anchor});
+            }
+
+            void endContainer()
+            {
+                if (stack.empty())
+                    return;
+                const bool entryDone = stack.size() == 3 && stack.back().item == &entry;
+                // the anchored node is complete now, aliases can only follow it
+                if (stack.back().anchor != YAML::NullAnchor)
+                    anchors[stack.back().anchor] = *stack.back().item;
+                stack.pop_back();
+                if (entryDone)
+                {
+                    // an anchored section keeps its entries for later aliases
+                    if (stack.back().anchor != YAML::NullAnchor)
+                        (*stack.back().item)[entryKey] = entry;
+                    callback(section, entryKey, entry);
+                    entry = ConfigItem();
+                }
+            }
+
+            Callback callback;
+            bool typed;
+            std::vector<Frame> stack;
+            ConfigItem document, sectionItem, entry;
+            std::string section, entryKey;
+            std::unordered_map<YAML::anchor_t, ConfigItem> anchors;
+        };
+
+        std::string currentDate()
+        {
+            char buffer[32];
+            std::time_t now = std::time(NULL);
+            std::strftime(buffer, sizeof(buffer), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+            return buffer;
+        }
+    }
+
+    bool CndImporter::importCnd(const std::string &fileName, ConfigMap &model)
+    {
+        error.clear();
+        std::ifstream in(fileName);
+        if (!in)
+        {
+            error = "cannot open " + fileName;
+            return false;
+        }
+
+        std::string name = fileName;
+        mars::utils::removeFilenamePrefix(&name);
+        mars::utils::removeFilenameSuffix(&name);
+        model = ConfigMap();
+        model["name"] = name;
+        model["domain"] = "SOFTWARE";
+        model["type"] = "CND";
+        model["versions"][0]["name"] = "v0.0.1";
+        model["versions"][0]["projectName"] = "";
+        model["versions"][0]["designedBy"] = "";
+        model["versions"][0]["date"] = currentDate();
+        ConfigItem &components = model["versions"][0]["components"];
+        components["nodes"] = ConfigVector();
+        components["edges"] = ConfigVector();
+        components["configuration"]["nodes"] = ConfigVector();
+        ConfigVector &nodes = components["nodes"];
+        ConfigVector &edges = components["edges"];
+        ConfigVector &configurations = components["configuration"]["nodes"];
+
+        // Task names in file order and the connections by task name (they may precede the tasks)
+        std::unordered_map<std::string, size_t> taskIndex;
+        std::vector<std::string> taskNames;
+        std::vector<std::pair<std::string, std::string>> connectedTasks;
+
+        SectionReader reader([&](const std::string &section, const std::string &key, ConfigItem &entry)
+                             {
+            if (section == "tasks" && entry.isMap())
+            {
+                if (taskIndex.count(key))
+                    return;
+                taskIndex[key] = taskNames.size();
+                taskNames.push_back(key);
+                ConfigMap node;
+                node["name"] = key;
+                node["model"]["domain"] = "SOFTWARE";
+                node["model"]["version"] = "v0.0.1";
+                node["model"]["name"] = entry.hasKey("type") ? entry["type"].getString() : std::string();
+                nodes.push_back(node);
+                ConfigMap config;
+                config["name"] = key;
+                config["data"] = entry;
+                configurations.push_back(config);
+            }
+            else if (section == "connections" && entry.isMap())
+            {
+                if (!entry.hasKey("from") || !entry.hasKey("to"))
+                    return;
+                ConfigItem &from = entry["from"];
+                ConfigItem &to = entry["to"];
+                ConfigMap edge;
+                edge["from"]["domain"] = "SOFTWARE";
+                edge["from"]["interface"] = from["port_name"];
+                edge["from"]["name"] = from["task_id"];
+                edge["to"]["domain"] = "SOFTWARE";
+                edge["to"]["interface"] = to["port_name"];
+                edge["to"]["name"] = to["task_id"];
+                edge["name"] = key;
+                if (entry.hasKey("data"))
+                    edge["data"] = entry["data"];
+                edges.push_back(edge);
+                connectedTasks.emplace_back(from["task_id"].getString(), to["task_id"].getString());
+            } },
+                             true);
+        try
+        {
+            YAML::Parser parser(in);
+            parser.HandleNextDocument(reader);
+        }
+        catch (const YAML::Exception &e)
+        {
+            error = "invalid cnd file " + fileName + ": " + e.what();
+            return false;
+        }
+
+        std::vector<GraphLayout::Edge> layoutEdges;
+        layoutEdges.reserve(connectedTasks.size());
+        for (auto &connection : connectedTasks)
+        {
+            auto from = taskIndex.find(connection.first);
+            auto to = taskIndex.find(connection.second);
+            if (from == taskIndex.end() || to == taskIndex.end())
+            {
+                XROCK_LOG(Warning, "CndImporter: connection between unknown tasks " << connection.first << " and " << connection.second);
+                continue;
+            }
+            layoutEdges.emplace_back(from->second, to->second);
+        }
+        std::vector<GraphLayout::Position> positions = GraphLayout::layered(taskNames.size(), layoutEdges);
+        ConfigMap &layout = model["versions"][0]["data"]["gui"]["layouts"]["software"];
+        for (size_t i = 0; i < taskNames.size(); ++i)
+        {
+            layout[taskNames[i]]["x"] = positions[i].x;
+            layout[taskNames[i]]["y"] = positions[i].y;
+        }
+        model["versions"][0]["data"]["gui"]["defaultLayout"] = "software";
+        model["modelPath"] = mars::utils::getPathOfFile(fileName);
+        XROCK_LOG(Info, "imported " << fileName << ": " << taskNames.size() << " tasks, " << edges.size() << " connections");
+        return true;
+    }
+
+    bool CndImporter::readCnd(const std::string &fileName, ConfigMap &cnd)
+    {
+        error.clear();
+        std::ifstream in(fileName);
+        if (!in)
+        {
+            error = "cannot open " + fileName;
+            return false;
+        }
+        cnd = ConfigMap();
+        SectionReader reader([&](const std::string &section, const std::string &key, ConfigItem &entry)
+                             { cnd[section][key] = entry; },
+                             false);
+        try
+        {
+            YAML::Parser parser(in);
+            parser.HandleNextDocument(reader);
+        }
+        catch (const YAML::Exception &e)
+        {
+            error = "invalid cnd file " + fileName + ": " + e.what();
+            return false;
+        }
+        return true;
+    }
+
+} // end of namespace xrock_gui_model
@@ -0,0 +1,32 @@
+/**
+ * \file CndImporter.hpp
+ * \brief Creates a component model from a component network description (CND) file
+ **/
+
+#pragma once
+#include <configmaps/ConfigData.h>
+#include <string>
+
+namespace xrock_gui_model
+{
+
+    class CndImporter
+    {
+    public:
+        CndImporter() {}
+        ~CndImporter() {}
+
+        // Reads the cnd file in one streaming pass and creates the basic model of a SOFTWARE CND model:
+        // one node per task (the task entry becomes the node configuration), one edge per
+        // connection and a layered layout of the nodes.
+        bool importCnd(const std::string &fileName, configmaps::ConfigMap &model);
+        // Reads the sections of the cnd file (tasks, connections, deployments, ...) without
+        // interpreting them. Plain scalars stay untyped (as written), quoted scalars become strings.
+        bool readCnd(const std::string &fileName, configmaps::ConfigMap &cnd);
+        const std::string &getError() const { return error; }
+
+    private:
+        std::string error;
+    };
+
+} // end of namespace xrock_gui_model
@@ -4,6 +4,7 @@
 #include "ConfigureDialog.hpp"
 #include "ConfigMapHelper.hpp"
 #include "ImportDialog.hpp"
+#include "Logger.hpp"
 
 #include <QVBoxLayout>
 #include <QLabel>
@@ -277,18 +278,17 @@ namespace xrock_gui_model
     {
         ComponentModelInterface* newModel = dynamic_cast<ComponentModelInterface *>(model);
         if (!newModel) return;
-        fprintf(stderr, "getModelInfo\n");
         auto info = newModel->getModelInfo();
-        for(auto &[k, v]: (ConfigMap)info)
+        if(Logger::instance().isEnabled(LogLevel::Debug))
         {
-            fprintf(stderr, "%s:", k.c_str());
-            fprintf(stderr, " %s\n", v.toYamlString().c_str());
+            for(auto &[k, v]: info)
+            {
+                XROCK_LOG(Debug, "model info " << k << ": " << v.toYamlString());
+            }
         }
         currentModel = nullptr;
-        fprintf(stderr, "update widgets\n");
         this->update_widgets(info);
         // set uri info to uri text field 
-        fprintf(stderr, "output info\n");
         if(info.hasKey("uri"))
         {
           uri->setText(QString::fromStdString(info["uri"]));
@@ -307,7 +307,6 @@ namespace xrock_gui_model
         currentModel = newModel;
         updateModel();
         updateManageHardwareLinkButtonState();
-        fprintf(stderr, "done\n");
     }
 
     void ComponentModelEditorWidget::updateManageHardwareLinkButtonState()
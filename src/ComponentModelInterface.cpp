@@ -7,13 +7,23 @@
 #include "ComponentModelInterface.hpp"
 #include "ConfigMapHelper.hpp"
 #include "BasicModelHelper.hpp"
+#include "NodeInfoCache.hpp"
+#include "GraphLayout.hpp"
+#include "Logger.hpp"
+#include "utils/ParallelFor.hpp"
+#include "utils/FileStat.hpp"
+#include "utils/YamlFileScan.hpp"
 #include <osg_graph_viz/Node.hpp>
 #include <bagel_gui/BagelGui.hpp>
 #include <QMessageBox>
 
 #include <mars/utils/misc.h>
-#include <dirent.h>
 #include <iostream>
+#include <algorithm>
+#include <unordered_set>
+#include <functional>
+#include <sstream>
+#include <cstdlib>
 using namespace bagel_gui;
 using namespace configmaps;
 using namespace mars::utils;
@@ -21,7 +31,50 @@ using namespace mars::utils;
 namespace xrock_gui_model
 {
 
-    ComponentModelInterface::ComponentModelInterface(BagelGui *bagelGui, XRockGUI *xrockGui) : ModelInterface(bagelGui), xrockGui(xrockGui)
+    // Revisions of nodes and part models are unique in the process, so they never match content
+    // of another model instance
+    static uint64_t nextRevision()
+    {
+        static uint64_t revision = 0;
+        return ++revision;
+    }
+
+    static uint64_t nextInstanceId()
+    {
+        static uint64_t instanceId = 0;
+        return ++instanceId;
+    }
+
+    // The configuration directory may be read-only (e.g. an installed package), so the node info
+    // cache lives in the user's cache directory. The cache drops entries of files it did not see,
+    // therefore every configuration directory gets its own cache file.
+    static std::string nodeInfoCacheFile(const std::string &confDir)
+    {
+        std::string cacheDir;
+        const char *xdgCache = getenv("XDG_CACHE_HOME");
+        const char *home = getenv("HOME");
+        if (xdgCache && xdgCache[0] == '/')
+        {
+            cacheDir = xdgCache;
+        }
+        else if (home && home[0])
+        {
+            cacheDir = std::string(home) + "/.cache";
+            createDirectory(cacheDir);
+        }
+        else
+        {
+            return confDir + "/node_info_cache.bin";
+        }
+        cacheDir += "/xrock_gui";
+        createDirectory(cacheDir);
+        std::stringstream name;
+        name << cacheDir << "/node_info_cache_" << std::hex << std::hash<std::string>()(confDir) << ".bin";
+        return name.str();
+    }
+
+    ComponentModelInterface::ComponentModelInterface(BagelGui *bagelGui, XRockGUI *xrockGui)
+        : ModelInterface(bagelGui), xrockGui(xrockGui), instanceId(nextInstanceId())
     {
         simpleTypeGen = false;
         std::string confDir = bagelGui->getConfigDir();
@@ -30,6 +83,29 @@ namespace xrock_gui_model
         {
             config.append(ConfigMap::fromYamlFile(confDir + "/config.yml", true));
         }
+        // Number of threads used to scan and parse the node definitions (0: one per core, 1: sequential)
+        size_t loadThreads = 0;
+        if (config.hasKey("node_definitions_threads"))
+        {
+            const int threads = (int)config["node_definitions_threads"];
+            if (threads >= 0)
+                loadThreads = threads;
+            else
+                XROCK_LOG(Warning, "ComponentModelInterface: ignore negative node_definitions_threads " << threads);
+        }
+        typeGracePeriod = 60.0;
+        typeMemoryBudget = 64 * 1024 * 1024;
+        if (config.hasKey("type_cache"))
+        {
+            if (config["type_cache"].hasKey("grace_period"))
+            {
+                typeGracePeriod = config["type_cache"]["grace_period"];
+            }
+            if (config["type_cache"].hasKey("memory_budget_mb"))
+            {
+                typeMemoryBudget = (double)config["type_cache"]["memory_budget_mb"] * 1024 * 1024;
+            }
+        }
         // 20221110 MS: What are xrock_node_definitions?
         ConfigVector::iterator it = config["xrock_node_definitions"].begin();
         std::vector<std::string> searchPaths;
@@ -47,10 +123,22 @@ namespace xrock_gui_model
         }
 
         {
+            // The derived node infos of unchanged definition files are read from a binary cache
+            NodeInfoCache cache;
+            const std::string cacheFile = nodeInfoCacheFile(confDir);
+            const bool useCache = !config.hasKey("node_info_cache") || (bool)config["node_info_cache"];
+            if (useCache)
+            {
+                cache.load(cacheFile);
+            }
             std::vector<std::string>::iterator it2 = searchPaths.begin();
             for (; it2 != searchPaths.end(); ++it2)
             {
-                loadNodeInfo(*it2);
+                loadNodeInfo(*it2, false, loadThreads, useCache ? &cache : NULL);
+            }
+            if (useCache && cache.needsStore())
+            {
+                cache.store(cacheFile);
             }
         }
 
@@ -84,7 +172,7 @@ namespace xrock_gui_model
                 }
             }
             orogenFolder += (std::string)config["OrogenFolder"];
-            loadNodeInfo(orogenFolder, true);
+            loadNodeInfo(orogenFolder, true, loadThreads);
         }
     }
 
@@ -94,9 +182,18 @@ namespace xrock_gui_model
           xrockGui(other->xrockGui),
           simpleTypeGen(other->simpleTypeGen),
           nodeMap(other->nodeMap),
+          sharedModels(other->sharedModels),
           edgeMap(other->edgeMap),
+          nodeIds(other->nodeIds),
+          edgeEndpoints(other->edgeEndpoints),
+          nodeAliases(other->nodeAliases),
           nodeInfoMap(other->nodeInfoMap),
-          basicModel(other->basicModel)
+          basicModel(other->basicModel),
+          partRevisions(other->partRevisions),
+          instanceId(nextInstanceId()),
+          typeUsage(other->typeUsage),
+          typeGracePeriod(other->typeGracePeriod),
+          typeMemoryBudget(other->typeMemoryBudget)
     {
     }
 
@@ -111,52 +208,106 @@ namespace xrock_gui_model
     }
 
     // 20221110 MS: As far as i can see it, this stuff is needed for bagel only. It has nothing to do with XRock, right?
-    void ComponentModelInterface::loadNodeInfo(std::string path, bool orogen)
+    // The directory tree is scanned level by level and the yaml files are parsed on a pool of worker threads.
+    // Only the registration of the parsed models is done sequentially in the sorted order of the file paths.
+    void ComponentModelInterface::loadNodeInfo(std::string path, bool orogen, size_t numThreads, NodeInfoCache *cache)
     {
         if (path[path.size() - 1] != '/')
         {
             path += "/";
         }
-        DIR *dir;
-        struct dirent *ent;
-        if ((dir = opendir(path.c_str())) != NULL)
+        const auto start = std::chrono::steady_clock::now();
+        if (numThreads == 0)
         {
-            // go through all entities
-            while ((ent = readdir(dir)) != NULL)
-            {
-                std::string file = ent->d_name;
+            numThreads = defaultNumThreads();
+        }
 
-                if (file.find(".yml", file.size() - 4, 4) != std::string::npos)
-                {
-                    // try to load the yaml-file
-                    ConfigMap map = ConfigMap::fromYamlFile(path + file);
-                    if (orogen)
+        std::vector<std::string> files, invalid;
+        findYamlFiles(path, files, invalid, numThreads);
+        for (const std::string &dir : invalid)
+        {
+            // this is not a directory
+            XROCK_LOG(Warning, "Specified path " << dir << " is not a valid directory");
+        }
+
+        // try to load the yaml-files; unchanged files are taken from the cache
+        std::vector<ConfigMap> maps(files.size());
+        std::vector<std::vector<osg_graph_viz::NodeInfo>> infos(files.size());
+        std::vector<int64_t> mtimes(files.size(), 0);
+        std::vector<uint64_t> sizes(files.size(), 0);
+        std::vector<char> cached(files.size(), 0);
+        std::vector<std::string> errors(files.size());
+        parallelFor(files.size(), [&](size_t i)
                     {
-                        addOrogenInfo(map);
-                    }
-                    else
+            try
+            {
+                FileStat fileStat;
+                if (FileStat::read(files[i], fileStat))
+                {
+                    mtimes[i] = fileStat.mtime;
+                    sizes[i] = fileStat.size;
+                }
+                if (!orogen && cache)
+                {
+                    const std::vector<osg_graph_viz::NodeInfo> *entry = cache->lookup(files[i], mtimes[i], sizes[i]);
+                    if (entry)
                     {
-                        addNodeInfo(deriveTypeFromNodeInfo(map), map);
+                        infos[i] = *entry;
+                        cached[i] = 1;
+                        return;
                     }
                 }
-                else if (file.find(".", 0, 1) != std::string::npos)
+                maps[i] = ConfigMap::fromYamlFile(files[i]);
+                if (!orogen)
+                {
+                    infos[i].push_back(createNodeInfo(deriveTypeFromNodeInfo(maps[i]), maps[i]));
+                }
+            }
+            catch (std::exception &e)
+            {
+                errors[i] = e.what();
+            } }, numThreads);
+        const auto parsed = std::chrono::steady_clock::now();
+
+        size_t numCached = 0;
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            if (!errors[i].empty())
+            {
+                XROCK_LOG(Warning, "Could not load " << files[i] << ": " << errors[i]);
+                continue;
+            }
+            if (orogen)
+            {
+                addOrogenInfo(maps[i]);
+                continue;
+            }
+            if (cache)
+            {
+                if (cached[i])
                 {
-                    // skip ".*"
+                    cache->touch(files[i]);
+                    ++numCached;
                 }
                 else
                 {
-                    // go into the next dir
-                    loadNodeInfo(path + file + "/", orogen);
+                    cache->update(files[i], mtimes[i], sizes[i], infos[i]);
+                }
+            }
+            for (auto &info : infos[i])
+            {
+                if (nodeInfoMap.find(info.type) == nodeInfoMap.end())
+                {
+                    touchPartModel(info.type);
+                    nodeInfoMap[info.type] = std::move(info);
                 }
             }
-            closedir(dir);
-        }
-        else
-        {
-            // this is not a directory
-            std::cerr << "Specified path " << path.c_str() << " is not a valid directory" << std::endl;
         }
-        return;
+        const auto end = std::chrono::steady_clock::now();
+        XROCK_LOG(Debug, "loadNodeInfo: " << path << ": " << files.size() << " files (" << numCached << " cached) with "
+                  << numThreads << " threads: scan+parse "
+                  << std::chrono::duration<double, std::milli>(parsed - start).count() << " ms, register "
+                  << std::chrono::duration<double, std::milli>(end - parsed).count() << " ms");
     }
 
     std::string ComponentModelInterface::deriveTypeFrom(const std::string &domain, const std::string &name, const std::string &version)
@@ -180,6 +331,28 @@ namespace xrock_gui_model
         if (nodeInfoMap.find(type) != nodeInfoMap.end())
             return false;
 
+        // Register the new model in the nodeInfoMap data structure
+        nodeInfoMap[type] = createNodeInfo(type, model);
+        touchPartModel(type);
+
+        return true;
+    }
+
+    // This function derives the bagel specific NodeInfo from a component model
+    osg_graph_viz::NodeInfo ComponentModelInterface::createNodeInfo(const std::string &type, configmaps::ConfigMap &model)
+    {
+        // The default configuration is the configuration starting point of the nodes, so it is decoded here
+        if (model.hasKey("versions") && model["versions"].size() > 0 && model["versions"][0].hasKey("defaultConfiguration"))
+        {
+            try
+            {
+                BasicModelHelper::decodeData(model["versions"][0]["defaultConfiguration"]);
+            }
+            catch (...)
+            {
+                XROCK_LOG(Warning, "ComponentModelInterface::createNodeInfo(): invalid default configuration of " << type);
+            }
+        }
         // Setup all information in the NodeInfo
         osg_graph_viz::NodeInfo info;
         // It should preserve as much of the orignal model as possible, so we should actually copy everything into info in the beginning!
@@ -225,10 +398,7 @@ namespace xrock_gui_model
             info.map["configuration"] = model["versions"][0]["defaultConfiguration"];
         }
 
-        // Register the new model in the nodeInfoMap data structure
-        nodeInfoMap[info.type] = info;
-
-        return true;
+        return info;
     }
 
     // TODO: Is this function deprecated? Because we normally import orogen models from orogen_to_xrock script
@@ -286,26 +456,81 @@ namespace xrock_gui_model
                 info.numOutputs = numOutputs;
                 info.map = map;
                 nodeInfoMap[type] = info;
+                touchPartModel(type);
             }
         }
 
         return true;
     }
 
+    // The display name of a node is its alias or its name if no alias is set
+    static const std::string &displayName(const std::string &name, const std::string &alias)
+    {
+        return alias.empty() ? name : alias;
+    }
+
     // This function gets called whenever the GUI adds a new node to the canvas
     bool ComponentModelInterface::addNode(unsigned long nodeId, configmaps::ConfigMap *node)
     {
         ConfigMap &map = *node;
 
         // Check if the node has already been added
-        if (nodeMap.find(nodeId) != nodeMap.end())
+        if (nodeMap.contains(nodeId))
             return false;
 
         // TODO: Instead of these 'DES' nodes we should have a property called 'description'
         std::string nodeType = map["type"];
         if (nodeType == "DES")
             return true;
-        nodeMap[nodeId] = map;
+        // Nodes restored by an undo may use a type which was evicted in the meantime
+        if (nodeInfoMap.find(nodeType) == nodeInfoMap.end() && map.hasKey("model") && map["model"].isMap())
+            restoreType(nodeType, map["model"]);
+        NodeRecord &record = nodeMap.insert(nodeId, NodeRecord());
+        record.revision = nextRevision();
+        record.name = map["name"].getString();
+        nodeIds[record.name] = nodeId;
+        record.type = nodeType;
+        if (map.hasKey("uri"))
+        {
+            record.hasUri = true;
+            record.uri = map["uri"].getString();
+        }
+        if (map.hasKey("model"))
+        {
+            // Share the component model with other nodes of the same type
+            std::shared_ptr<const ConfigMap> &model = sharedModels[nodeType];
+            if (!model)
+            {
+                model = std::make_shared<const ConfigMap>(map["model"]);
+            }
+            record.model = model;
+        }
+        if (map.hasKey("inputs"))
+        {
+            for (auto &input : map["inputs"])
+            {
+                record.inputNames.push_back(input["name"].getString());
+                record.inputAliases.push_back(input.hasKey("alias") ? input["alias"].getString() : std::string());
+            }
+        }
+        if (map.hasKey("outputs"))
+        {
+            for (auto &output : map["outputs"])
+            {
+                record.outputNames.push_back(output["name"].getString());
+                record.outputAliases.push_back(output.hasKey("alias") ? output["alias"].getString() : std::string());
+            }
+        }
+        record.alias = map.hasKey("alias") ? map["alias"].getString() : std::string();
+        // Pasted nodes should not reuse the display name of another node. The node is kept as it is,
+        // the user has to resolve the conflict by renaming one of the nodes.
+        const std::string &name = displayName(record.name, record.alias);
+        if (nodeAliases.find(name) != nodeAliases.end())
+        {
+            reportAliasConflict("The name " + name + " of the added node is already used by another node");
+        }
+        indexAliases(nodeId, record);
+        acquireType(nodeType);
         return true;
     }
 
@@ -316,63 +541,74 @@ namespace xrock_gui_model
         return addNode(nodeId, &map);
     }
 
+    // Identifies the nodes and interfaces connected by an edge
+    static std::string edgeEndpointKey(ConfigMap &edge)
+    {
+        return edge["fromNode"].getString() + '\n' + edge["fromNodeOutput"].getString() + '\n' +
+               edge["toNode"].getString() + '\n' + edge["toNodeInput"].getString();
+    }
+
+    static void removeEdgeEndpoints(std::unordered_map<std::string, size_t> &edgeEndpoints, const std::string &key)
+    {
+        auto it = edgeEndpoints.find(key);
+        if (it != edgeEndpoints.end() && --it->second == 0)
+            edgeEndpoints.erase(it);
+    }
+
     // This function adds an entry in the edgeMap (while also checking compatibility)
     bool ComponentModelInterface::addEdge(unsigned long edgeId, configmaps::ConfigMap *edge)
     {
         ConfigMap &map = *edge;
 
         // Check if we already have added the edge
-        if (edgeMap.find(edgeId) != edgeMap.end())
+        if (edgeMap.contains(edgeId))
             return false;
 
         // Check if edge info is valid
-        // Check if nodes exist
+        // Check if nodes and interfaces exist
         const std::string &fromNodeName(map["fromNode"].getString());
-        const configmaps::ConfigMap *fromNodeMapPtr = bagelGui->getNodeMap(fromNodeName);
-        if (!fromNodeMapPtr)
+        const std::string &fromNodeOutputName(map["fromNodeOutput"].getString());
+        if (!hasNodePort(fromNodeName, "outputs", fromNodeOutputName))
             return false;
-        ConfigMap fromNodeMap = *fromNodeMapPtr;
-
         const std::string &toNodeName(map["toNode"].getString());
-        const configmaps::ConfigMap *toNodeMapPtr = bagelGui->getNodeMap(toNodeName);
-        if (!toNodeMapPtr)
+        const std::string &toNodeInputName(map["toNodeInput"].getString());
+        if (!hasNodePort(toNodeName, "inputs", toNodeInputName))
             return false;
-        ConfigMap toNodeMap = *toNodeMapPtr;
 
-        // Check if interfaces exist
+        edgeMap.insert(edgeId, map);
+        ++edgeEndpoints[edgeEndpointKey(map)];
+        return true;
+    }
+
+    // Checks whether the node exists and has a port with the given name.
+    // Nodes of the nodeMap are checked via their records, others (e.g. 'DES' nodes) via the bagel gui.
+    bool ComponentModelInterface::hasNodePort(const std::string &nodeName, const std::string &portType, const std::string &portName)
+    {
+        if (const NodeRecord *record = findNodeRecord(nodeName))
         {
-            const std::string &fromNodeOutputName(map["fromNodeOutput"].getString());
-            ConfigVector &outputs = fromNodeMap["outputs"];
-            bool found = false;
-            for (size_t i = 0; i < outputs.size(); i++)
-            {
-                if (outputs[i]["name"].getString() == fromNodeOutputName)
-                {
-                    found = true;
-                    break;
-                }
-            }
-            if (!found)
-                return false;
+            const std::vector<std::string> &ports = (portType == "inputs") ? record->inputNames : record->outputNames;
+            return std::find(ports.begin(), ports.end(), portName) != ports.end();
         }
+        const configmaps::ConfigMap *nodeMapPtr = bagelGui->getNodeMap(nodeName);
+        if (!nodeMapPtr)
+            return false;
+        ConfigMap node = *nodeMapPtr;
+        if (!node.hasKey(portType))
+            return false;
+        for (auto &port : node[portType])
         {
-            const std::string &toNodeInputName(map["toNodeInput"].getString());
-            ConfigVector &inputs = toNodeMap["inputs"];
-            bool found = false;
-            for (size_t i = 0; i < inputs.size(); i++)
-            {
-                if (inputs[i]["name"].getString() == toNodeInputName)
-                {
-                    found = true;
-                    break;
-                }
-            }
-            if (!found)
-                return false;
+            if (port["name"].getString() == portName)
+                return true;
         }
+        return false;
+    }
 
-        edgeMap[edgeId] = map;
-        return true;
+    const ComponentModelInterface::NodeRecord *ComponentModelInterface::findNodeRecord(const std::string &name) const
+    {
+        auto it = nodeIds.find(name);
+        if (it == nodeIds.end())
+            return NULL;
+        return nodeMap.find(it->second);
     }
 
     bool ComponentModelInterface::addEdge(unsigned long edgeId,
@@ -385,19 +621,7 @@ namespace xrock_gui_model
     // Checks whether an edge between the same nodes and interfaces already exists
     bool ComponentModelInterface::hasEdge(configmaps::ConfigMap *edge)
     {
-        ConfigMap &map = *edge;
-
-        for (auto it = edgeMap.begin(); it != edgeMap.end(); ++it)
-        {
-            if (it->second["fromNode"] == map["fromNode"] &&
-                it->second["toNode"] == map["toNode"] &&
-                it->second["fromNodeOutput"] == map["fromNodeOutput"] &&
-                it->second["toNodeInput"] == map["toNodeInput"])
-            {
-                return true;
-            }
-        }
-        return false;
+        return edgeEndpoints.find(edgeEndpointKey(*edge)) != edgeEndpoints.end();
     }
 
     bool ComponentModelInterface::hasEdge(const configmaps::ConfigMap &edge)
@@ -421,79 +645,275 @@ namespace xrock_gui_model
     // This function removes a node from the nodeMap
     bool ComponentModelInterface::removeNode(unsigned long nodeId)
     {
+        NodeRecord *record = nodeMap.find(nodeId);
+        if (!record)
+            return true;
+        const std::string type = record->type;
+        unindexNodeAlias(nodeId, *record);
+        auto name = nodeIds.find(record->name);
+        if (name != nodeIds.end() && name->second == nodeId)
+            nodeIds.erase(name);
         nodeMap.erase(nodeId);
+        releaseType(type);
+        evictUnusedTypes();
         return true;
     }
 
     // This function removed an edge from the edgeMap
     bool ComponentModelInterface::removeEdge(unsigned long edgeId)
     {
-        if (edgeMap.find(edgeId) == edgeMap.end())
+        ConfigMap *edge = edgeMap.find(edgeId);
+        if (!edge)
             return true;
-
+        removeEdgeEndpoints(edgeEndpoints, edgeEndpointKey(*edge));
         edgeMap.erase(edgeId);
         return true;
     }
 
     // This function updates an existing node in the nodeMap.
+    // The bagel gui calls it for every small change, so only the protected fields of the node are
+    // checked and restored. The uri and model are fixed, the name only changes if aliases are not handled.
+    // Renames and alias changes keep the alias indices up to date.
     bool ComponentModelInterface::updateNode(unsigned long nodeId,
                                              configmaps::ConfigMap &node)
     {
         if (node["type"] == "DES")
             return true;
-        std::map<unsigned long, ConfigMap>::iterator it = nodeMap.find(nodeId);
-        if (it != nodeMap.end())
+        if (NodeRecord *found = nodeMap.find(nodeId))
         {
+            NodeRecord &record = *found;
+            record.revision = nextRevision();
             // Do not allow changes to uri
-            if(it->second.hasKey("uri"))
+            if (record.hasUri)
             {
-                node["uri"] = it->second["uri"];
+                node["uri"] = record.uri;
             }
             // Do not allow changes to name but change the alias instead
-            if(xrockGui->handleAlias())
+            if (xrockGui->handleAlias())
             {
-                if (node["name"] != it->second["name"])
+                if (node["name"].getString() != record.name)
                 {
                     node["alias"] = node["name"];
+                    node["name"] = record.name;
                 }
-                // TODO: Check that the alias is unique across the whole node map
-                node["name"] = it->second["name"];
             }
-
-            // Do not allow changes to model
-            node["model"] = it->second["model"];
-            // Do not allow changes to interface names, change their alias instead
-            ConfigVector &inputs = node["inputs"];
-            for (size_t i = 0; i < inputs.size(); i++)
+            else if (node["name"].getString() != record.name)
             {
-                if (inputs[i]["name"] != it->second["inputs"][i]["name"])
+                // Without alias handling the node itself is renamed
+                unindexNodeAlias(nodeId, record);
+                nodeIds.erase(record.name);
+                record.name = node["name"].getString();
+                nodeIds[record.name] = nodeId;
+                indexNodeAlias(nodeId, record);
+            }
+            const std::string alias = node.hasKey("alias") ? node["alias"].getString() : std::string();
+            if (alias != record.alias)
+            {
+                const bool unique = isNodeAliasUnique(alias, nodeId);
+                if (!unique)
+                {
+                    reportAliasConflict("The alias " + alias + " of " + record.name + " is already used by another node");
+                }
+                if (!unique && !loadState)
+                {
+                    // Renames must not introduce ambiguous names, loaded models are kept as they are
+                    node["alias"] = record.alias;
+                }
+                else
                 {
-                    inputs[i]["alias"] = inputs[i]["name"];
+                    unindexNodeAlias(nodeId, record);
+                    record.alias = alias;
+                    indexNodeAlias(nodeId, record);
                 }
-                inputs[i]["name"] = it->second["inputs"][i]["name"];
             }
-            ConfigVector &outputs = node["outputs"];
-            for (size_t i = 0; i < outputs.size(); i++)
+
+            // Do not allow changes to model. It is only copied back if it differs from the shared model.
+            if (record.model && (!node.hasKey("model") || !node["model"].isMap() ||
+                                 !ConfigMapHelper::equals((ConfigMap &)node["model"], *record.model)))
+            {
+                node["model"] = *record.model;
+            }
+            // Do not allow changes to interface names, change their alias instead
+            if (node.hasKey("inputs"))
+            {
+                updatePortAliases(node["inputs"], record.name, record.inputNames, record.inputAliases, record.inputAliasIndex);
+            }
+            if (node.hasKey("outputs"))
+            {
+                updatePortAliases(node["outputs"], record.name, record.outputNames, record.outputAliases, record.outputAliasIndex);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // Restores the port names and keeps the alias index of the ports up to date.
+    // Renaming a port to a name or alias already used by another port of the same direction is rejected,
+    // except while a model is loaded (see reportAliasConflict()).
+    void ComponentModelInterface::updatePortAliases(ConfigVector &ports, const std::string &nodeName,
+                                                    const std::vector<std::string> &names, std::vector<std::string> &aliases,
+                                                    std::unordered_map<std::string, std::string> &aliasIndex)
+    {
+        for (size_t i = 0; i < ports.size() && i < names.size(); i++)
+        {
+            if (ports[i]["name"].getString() != names[i])
             {
-                if (outputs[i]["name"] != it->second["outputs"][i]["name"])
+                ports[i]["alias"] = ports[i]["name"];
+                ports[i]["name"] = names[i];
+            }
+            const std::string alias = ports[i].hasKey("alias") ? ports[i]["alias"].getString() : std::string();
+            if (alias == aliases[i])
+                continue;
+            auto used = alias.empty() ? aliasIndex.end() : aliasIndex.find(alias);
+            if (used != aliasIndex.end() && used->second != names[i])
+            {
+                reportAliasConflict("The alias " + alias + " of " + nodeName + ":" + names[i] +
+                                    " is already used by " + used->second);
+                if (!loadState)
                 {
-                    outputs[i]["alias"] = outputs[i]["name"];
+                    ports[i]["alias"] = aliases[i];
+                    continue;
                 }
-                outputs[i]["name"] = it->second["outputs"][i]["name"];
             }
-            // Update node
-            it->second = node;
+            auto old = aliasIndex.find(aliases[i]);
+            if (!aliases[i].empty() && old != aliasIndex.end() && old->second == names[i] && aliases[i] != names[i])
+                aliasIndex.erase(old);
+            aliases[i] = alias;
+            if (!alias.empty())
+                aliasIndex.emplace(alias, names[i]);
+        }
+    }
+
+    // Conflicting aliases (see reportAliasConflict()) share an entry until the user resolves them
+    void ComponentModelInterface::indexNodeAlias(unsigned long nodeId, const NodeRecord &record)
+    {
+        nodeAliases[displayName(record.name, record.alias)].push_back(nodeId);
+    }
+
+    void ComponentModelInterface::unindexNodeAlias(unsigned long nodeId, const NodeRecord &record)
+    {
+        auto it = nodeAliases.find(displayName(record.name, record.alias));
+        if (it == nodeAliases.end())
+            return;
+        std::vector<unsigned long> &ids = it->second;
+        ids.erase(std::remove(ids.begin(), ids.end(), nodeId), ids.end());
+        if (ids.empty())
+            nodeAliases.erase(it);
+    }
+
+    void ComponentModelInterface::indexAliases(unsigned long nodeId, NodeRecord &record)
+    {
+        indexNodeAlias(nodeId, record);
+        // Ports can be addressed by their name or their alias
+        record.inputAliasIndex.clear();
+        record.outputAliasIndex.clear();
+        for (size_t i = 0; i < record.inputNames.size(); ++i)
+        {
+            record.inputAliasIndex.emplace(record.inputNames[i], record.inputNames[i]);
+            if (!record.inputAliases[i].empty())
+                record.inputAliasIndex.emplace(record.inputAliases[i], record.inputNames[i]);
+        }
+        for (size_t i = 0; i < record.outputNames.size(); ++i)
+        {
+            record.outputAliasIndex.emplace(record.outputNames[i], record.outputNames[i]);
+            if (!record.outputAliases[i].empty())
+                record.outputAliasIndex.emplace(record.outputAliases[i], record.outputNames[i]);
+        }
+    }
+
+    bool ComponentModelInterface::isNodeAliasUnique(const std::string &alias, unsigned long nodeId) const
+    {
+        const NodeRecord *record = nodeMap.find(nodeId);
+        const std::string &name = alias.empty() && record ? record->name : alias;
+        auto it = nodeAliases.find(name);
+        if (it == nodeAliases.end())
+            return true;
+        return it->second.size() == 1 && it->second.front() == nodeId;
+    }
+
+    // Interactive edits are reported right away. Conflicts of a loaded model are collected
+    // and reported together once the model is loaded.
+    void ComponentModelInterface::reportAliasConflict(const std::string &message)
+    {
+        XROCK_LOG(Warning, "ComponentModelInterface: " << message);
+        aliasConflicts.push_back(message);
+        if (!loadState)
+            showAliasConflicts();
+    }
+
+    void ComponentModelInterface::showAliasConflicts()
+    {
+        if (aliasConflicts.empty())
+            return;
+        std::string text = "Names and aliases have to be unique. Please rename the conflicting nodes or interfaces:";
+        for (const std::string &conflict : aliasConflicts)
+            text += "\n  " + conflict;
+        aliasConflicts.clear();
+        QMessageBox::warning(nullptr, "Alias conflict", QString::fromStdString(text), QMessageBox::Ok);
+    }
+
+    std::string ComponentModelInterface::resolveNodeAlias(const std::string &alias) const
+    {
+        auto it = nodeAliases.find(alias);
+        if (it == nodeAliases.end() || it->second.empty())
+            return std::string();
+        const NodeRecord *record = nodeMap.find(it->second.front());
+        return record ? record->name : std::string();
+    }
+
+    bool ComponentModelInterface::findNodeId(const std::string &name, unsigned long &nodeId) const
+    {
+        auto it = nodeIds.find(name);
+        if (it != nodeIds.end())
+        {
+            nodeId = it->second;
             return true;
         }
-        return false;
+        auto alias = nodeAliases.find(name);
+        if (alias == nodeAliases.end() || alias->second.empty())
+            return false;
+        nodeId = alias->second.front();
+        return true;
+    }
+
+    std::string ComponentModelInterface::resolvePortAlias(const std::string &nodeName, const std::string &portType,
+                                                          const std::string &alias) const
+    {
+        const NodeRecord *record = findNodeRecord(nodeName);
+        if (!record)
+            return std::string();
+        const std::unordered_map<std::string, std::string> &index = (portType == "inputs") ? record->inputAliasIndex : record->outputAliasIndex;
+        auto it = index.find(alias);
+        return it == index.end() ? std::string() : it->second;
+    }
+
+    // Replaces a node or port alias by the name, names and unknown aliases are kept
+    void ComponentModelInterface::resolveEdgeEndpoint(std::string &nodeName, const std::string &portType, std::string &portName) const
+    {
+        if (!findNodeRecord(nodeName))
+        {
+            const std::string name = resolveNodeAlias(nodeName);
+            if (!name.empty())
+                nodeName = name;
+        }
+        const std::string port = resolvePortAlias(nodeName, portType, portName);
+        if (!port.empty())
+            portName = port;
     }
 
     bool ComponentModelInterface::updateEdge(unsigned long edgeId, configmaps::ConfigMap &edge)
     {
-        auto it = edgeMap.find(edgeId);
-        if (it != edgeMap.end())
+        if (ConfigMap *stored = edgeMap.find(edgeId))
         {
-            it->second = edge;
+            // Keep the endpoint index in sync if the edge was reconnected
+            const std::string oldKey = edgeEndpointKey(*stored);
+            const std::string newKey = edgeEndpointKey(edge);
+            if (oldKey != newKey)
+            {
+                removeEdgeEndpoints(edgeEndpoints, oldKey);
+                ++edgeEndpoints[newKey];
+            }
+            *stored = edge;
             return true;
         }
         return false;
@@ -530,194 +950,518 @@ namespace xrock_gui_model
         const std::string &partType(deriveTypeFrom(domain, name, version));
         if (hasNodeInfo(partType))
             return true;
+        // Make room for the new type before requesting it
+        evictUnusedTypes();
         // Get map from DB. For this we need a reference to the XRockGui
         ConfigMap partModel = xrockGui->db->requestModel(domain, name, version, true);
         partModels[partType] = partModel;
+        touchPartModel(partType);
+        // The nodes only carry the interface summary of the part. The inner components are
+        // kept once in partModels and expanded on demand (see getInnerComponents()).
+        ConfigMap collapsedModel = partModel;
+        BasicModelHelper::collapseComponents(collapsedModel);
         // Register the new model
         // NOTE: This function already converts the given basicModel into bagel specific stuff
-        if (!addNodeInfo(partType, partModel))
+        if (!addNodeInfo(partType, collapsedModel))
             return false;
+        // Types registered on demand are subject to eviction once no node uses them anymore
+        TypeUsage &usage = typeUsage[partType];
+        usage.refCount = 0;
+        usage.estimatedSize = ConfigMapHelper::estimateSize(partModel) + 2 * ConfigMapHelper::estimateSize(collapsedModel);
+        usage.lastReleased = std::chrono::steady_clock::now();
         // Once we have updated type info, we need to make the bagelGui aware of it.
         // Only then, the subsequent addNode() will work.
         bagelGui->updateNodeTypes();
         return true;
     }
 
+    // Returns the inner components of the part model of the given node. Collapsed models are expanded
+    // from partModels or requested from the DB if the part model is not resident anymore.
+    configmaps::ConfigMap ComponentModelInterface::getInnerComponents(configmaps::ConfigMap &node)
+    {
+        ConfigMap &model = node["model"];
+        if (!BasicModelHelper::hasComponents(model))
+            return ConfigMap();
+        if (!model["versions"][0]["components"].hasKey("collapsed"))
+            return model["versions"][0]["components"];
+        ConfigMap partModel = getPartModel(model["domain"].getString(), model["name"].getString(),
+                                           model["versions"][0]["name"].getString());
+        if (!partModel.hasKey("versions") || !partModel["versions"][0].hasKey("components"))
+            return ConfigMap();
+        return partModel["versions"][0]["components"];
+    }
+
+    configmaps::ConfigMap ComponentModelInterface::getPartModel(const std::string &domain, const std::string &name, const std::string &version)
+    {
+        const std::string partType = deriveTypeFrom(domain, name, version);
+        auto it = partModels.find(partType);
+        if (it != partModels.end())
+            return it->second;
+        // Parts without inner components are registered completely
+        auto info = nodeInfoMap.find(partType);
+        if (info != nodeInfoMap.end() && info->second.map.hasKey("model"))
+        {
+            ConfigMap &model = info->second.map["model"];
+            if (!BasicModelHelper::hasComponents(model))
+                return model;
+        }
+        ConfigMap partModel = xrockGui->db->requestModel(domain, name, version, true);
+        // Keep the part model only while its type is resident (see evictUnusedTypes())
+        if (typeUsage.find(partType) != typeUsage.end())
+        {
+            partModels[partType] = partModel;
+            touchPartModel(partType);
+        }
+        return partModel;
+    }
+
+    uint64_t ComponentModelInterface::getNodeRevision(const std::string &name) const
+    {
+        const NodeRecord *record = findNodeRecord(name);
+        return record ? record->revision : 0;
+    }
+
+    // Follows the lookup order of getPartModel(): only part models served from partModels or nodeInfoMap
+    // have a revision, the content of models requested from the DB is not tracked
+    uint64_t ComponentModelInterface::getPartModelRevision(const std::string &domain, const std::string &name, const std::string &version)
+    {
+        const std::string partType = deriveTypeFrom(domain, name, version);
+        if (partModels.find(partType) == partModels.end())
+        {
+            auto info = nodeInfoMap.find(partType);
+            if (info == nodeInfoMap.end() || !info->second.map.hasKey("model") ||
+                BasicModelHelper::hasComponents(info->second.map["model"]))
+                return 0;
+        }
+        auto revision = partRevisions.find(partType);
+        return revision == partRevisions.end() ? 0 : revision->second;
+    }
+
+    void ComponentModelInterface::touchPartModel(const std::string &type)
+    {
+        partRevisions[type] = nextRevision();
+        // Nodes added from now on share the model of the new registration
+        sharedModels.erase(type);
+    }
+
+    // Registers an evicted type again from the model carried by one of its nodes. The complete part model
+    // is requested from the DB again when it is needed (see getPartModel()).
+    void ComponentModelInterface::restoreType(const std::string &type, configmaps::ConfigMap &model)
+    {
+        if (!addNodeInfo(type, model))
+            return;
+        XROCK_LOG(Debug, "ComponentModelInterface: restored evicted type " << type);
+        TypeUsage &usage = typeUsage[type];
+        usage.refCount = 0;
+        usage.estimatedSize = 2 * ConfigMapHelper::estimateSize(model);
+        usage.lastReleased = std::chrono::steady_clock::now();
+        bagelGui->updateNodeTypes();
+    }
+
+    void ComponentModelInterface::acquireType(const std::string &type)
+    {
+        auto it = typeUsage.find(type);
+        if (it != typeUsage.end())
+        {
+            it->second.refCount++;
+        }
+    }
+
+    void ComponentModelInterface::releaseType(const std::string &type)
+    {
+        auto it = typeUsage.find(type);
+        if (it != typeUsage.end() && it->second.refCount > 0)
+        {
+            if (--it->second.refCount == 0)
+            {
+                it->second.lastReleased = std::chrono::steady_clock::now();
+            }
+        }
+    }
+
+    // Evicts the least recently released types which are not used by any node anymore
+    // and whose grace period is over, until the registered types fit into the memory budget.
+    void ComponentModelInterface::evictUnusedTypes()
+    {
+        size_t totalSize = 0;
+        std::vector<std::map<std::string, TypeUsage>::iterator> candidates;
+        const auto now = std::chrono::steady_clock::now();
+        for (auto it = typeUsage.begin(); it != typeUsage.end(); ++it)
+        {
+            totalSize += it->second.estimatedSize;
+            std::chrono::duration<double> unused = now - it->second.lastReleased;
+            if (it->second.refCount == 0 && unused.count() >= typeGracePeriod)
+            {
+                candidates.push_back(it);
+            }
+        }
+        if (totalSize <= typeMemoryBudget || candidates.empty())
+            return;
+
+        std::sort(candidates.begin(), candidates.end(), [](const auto &a, const auto &b)
+                  { return a->second.lastReleased < b->second.lastReleased; });
+        for (auto &it : candidates)
+        {
+            if (totalSize <= typeMemoryBudget)
+                break;
+            totalSize -= it->second.estimatedSize;
+            nodeInfoMap.erase(it->first);
+            partModels.erase(it->first);
+            partRevisions.erase(it->first);
+            sharedModels.erase(it->first);
+            typeUsage.erase(it);
+        }
+        // Keep the type list of the bagel gui in sync
+        bagelGui->updateNodeTypes();
+    }
+
+    // State of a resumable setModelInfo() (see beginModelInfo())
+    struct ComponentModelInterface::ModelLoadState
+    {
+        enum Stage
+        {
+            NODES,
+            EDGES,
+            NODE_CONFIGURATION,
+            EDGE_CONFIGURATION,
+            LAYOUT,
+            DONE
+        };
+        Stage stage = NODES;
+        // next item of the current stage
+        size_t next = 0;
+        size_t processed = 0;
+        size_t total = 0;
+        // The interfaces of the model are looked up by node name and the ports of each node by port name
+        BasicModelHelper::InterfaceIndex interfaces;
+        BasicModelHelper::PortIndex ports;
+    };
+
+    // Returns the number of items of the given component list of the basic model
+    static size_t componentCount(ConfigMap &model, const std::string &key, const std::string &subKey = "")
+    {
+        if (!model["versions"][0].hasKey("components"))
+            return 0;
+        ConfigItem &components = model["versions"][0]["components"];
+        if (!components.hasKey(key))
+            return 0;
+        if (subKey.empty())
+            return components[key].size();
+        if (!components[key].hasKey(subKey))
+            return 0;
+        return components[key][subKey].size();
+    }
+
     // This function gets called whenever the XRockGui has updates for the current model.
     // E.g. initially the loadComponentModel() function will pass all data to here.
     void ComponentModelInterface::setModelInfo(configmaps::ConfigMap &map)
+    {
+        beginModelInfo(map);
+        while (!continueModelInfo(0.0))
+        {
+        }
+    }
+
+    // Starts a resumable setModelInfo(). The model is then loaded by calling continueModelInfo() until it returns true.
+    void ComponentModelInterface::beginModelInfo(configmaps::ConfigMap &map)
     {
         // NOTE: basicModel holds the original data. So we just copy over.
         basicModel = map;
         // extract the gui information and store it in separate map
-        if (basicModel["versions"][0].hasKey("data") && basicModel["versions"][0]["data"].hasKey("gui"))
+        if (BasicModelHelper::decodeData(basicModel["versions"][0]) && basicModel["versions"][0]["data"].hasKey("gui"))
         {
             guiMap = basicModel["versions"][0]["data"]["gui"];
             ConfigMap &dataMap = basicModel["versions"][0]["data"];
             dataMap.erase("gui");
         }
 
-        fprintf(stderr, "load nodes...\n");
-        // We now use the basic model to setup the GUI
-        if (basicModel["versions"][0].hasKey("components") && basicModel["versions"][0]["components"].hasKey("nodes"))
+        loadState.reset(new ModelLoadState());
+        loadState->total = componentCount(basicModel, "nodes") + componentCount(basicModel, "edges") +
+                           componentCount(basicModel, "configuration", "nodes") +
+                           componentCount(basicModel, "configuration", "edges");
+        BasicModelHelper::buildInterfaceIndex(basicModel, loadState->interfaces);
+        XROCK_LOG(Debug, "load nodes...");
+    }
+
+    // Processes nodes, edges and configurations until the time budget (ms) is used up (<= 0: no limit).
+    // The layout is applied together with each chunk of nodes, so they appear at their final position.
+    // Returns true if the model is completely loaded.
+    bool ComponentModelInterface::continueModelInfo(double timeBudget)
+    {
+        if (!loadState)
+            return true;
+        ModelLoadState &state = *loadState;
+        const auto start = std::chrono::steady_clock::now();
+        auto budgetLeft = [&]()
+        {
+            if (timeBudget <= 0.0)
+                return true;
+            return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() < timeBudget;
+        };
+
+        if (state.stage == ModelLoadState::NODES)
         {
-            auto nodes = basicModel["versions"][0]["components"]["nodes"];
-            // At first, we have to create the nodes
-            for (auto it : nodes)
+            const size_t numNodes = componentCount(basicModel, "nodes");
+            std::vector<std::string> chunk;
+            while (state.next < numNodes && budgetLeft())
             {
-                const std::string &name(it["name"].getString());
-                if (bagelGui->getNodeMap(name))
-                    continue;
-                const std::string &modelName(it["model"]["name"].getString());
-                const std::string &modelDomain(it["model"]["domain"].getString());
-                const std::string &modelVersion(it["model"]["version"].getString());
-                // Unfortunately, the basicModel has no URI, so we have to construct a unique type id ourselves
-                const std::string &partType(deriveTypeFrom(modelDomain, modelName, modelVersion));
-                // Before we can add a node, we first have to check if the model is already known or
-                // has to be requested from the DB first
-                if (!registerComponentModel(modelDomain, modelName, modelVersion))
-                {
-                    std::cerr << "ComponentModelInterface::setModelInfo(): could not register " << partType << "\n";
-                    continue;
-                }
-                bagelGui->addNode(partType, name);
-
-                // Postprocessing
-                ConfigMap currentMap = *bagelGui->getNodeMap(name);
-                // Update alias
-                currentMap["alias"] = it.hasKey("alias") ? it["alias"].getString() : "";
-                // Update interface aliases
-                if (it.hasKey("interface_aliases"))
-                {
-                    ConfigMap &if_aliases = it["interface_aliases"];
-                    for (const auto [original_name, value] : if_aliases)
-                    {
-                        const std::string &alias(value.getString());
-                        // Update matching inputs
-                        if (currentMap.hasKey("inputs"))
-                        {
-                            for (auto input : currentMap["inputs"])
-                            {
-                                if (input["name"].getString() == original_name)
-                                    input["alias"] = alias;
-                            }
-                        }
-                        // Update matching outputs
-                        if (currentMap.hasKey("outputs"))
-                        {
-                            for (auto output : currentMap["outputs"])
-                            {
-                                if (output["name"].getString() == original_name)
-                                    output["alias"] = alias;
-                            }
-                        }
-                    }
-                }
-                BasicModelHelper::updateExportedInterfacesFromModel(currentMap, basicModel, xrockGui->handleAlias());
-                bagelGui->updateNodeMap(name, currentMap);
+                ConfigItem &it = basicModel["versions"][0]["components"]["nodes"][state.next++];
+                ++state.processed;
+                if (loadNode(it, state))
+                    chunk.push_back(it["name"].getString());
             }
-
+            applyPartLayout(chunk);
+            if (state.next < numNodes)
+                return false;
             // After we have done the nodes, we can wire their interfaces together
-            fprintf(stderr, "load edges...\n");
-            if (basicModel["versions"][0]["components"].hasKey("edges"))
+            XROCK_LOG(Debug, "load edges...");
+            state.stage = ModelLoadState::EDGES;
+            state.next = 0;
+        }
+        if (state.stage == ModelLoadState::EDGES)
+        {
+            const size_t numEdges = componentCount(basicModel, "edges");
+            while (state.next < numEdges && budgetLeft())
             {
-                auto edges = basicModel["versions"][0]["components"]["edges"];
-                for (auto it : edges)
-                {
-                    ConfigMap edge;
-                    edge["fromNode"] = it["from"]["name"];
-                    edge["fromNodeOutput"] = it["from"]["interface"];
-                    edge["toNode"] = it["to"]["name"];
-                    edge["toNodeInput"] = it["to"]["interface"];
+                ++state.processed;
+                loadEdge(basicModel["versions"][0]["components"]["edges"][state.next++]);
+            }
+            if (state.next < numEdges)
+                return false;
+            XROCK_LOG(Debug, "load configuration...");
+            state.stage = ModelLoadState::NODE_CONFIGURATION;
+            state.next = 0;
+        }
+        // Add configuration update to nodes and edges
+        if (state.stage == ModelLoadState::NODE_CONFIGURATION)
+        {
+            const size_t numConfigs = componentCount(basicModel, "configuration", "nodes");
+            while (state.next < numConfigs && budgetLeft())
+            {
+                ++state.processed;
+                loadNodeConfiguration(basicModel["versions"][0]["components"]["configuration"]["nodes"][state.next++]);
+            }
+            if (state.next < numConfigs)
+                return false;
+            state.stage = ModelLoadState::EDGE_CONFIGURATION;
+            state.next = 0;
+        }
+        if (state.stage == ModelLoadState::EDGE_CONFIGURATION)
+        {
+            const size_t numConfigs = componentCount(basicModel, "configuration", "edges");
+            while (state.next < numConfigs && budgetLeft())
+            {
+                ++state.processed;
+                loadEdgeConfiguration(basicModel["versions"][0]["components"]["configuration"]["edges"][state.next++]);
+            }
+            if (state.next < numConfigs)
+                return false;
+            state.stage = ModelLoadState::LAYOUT;
+        }
+        if (state.stage == ModelLoadState::LAYOUT)
+        {
+            XROCK_LOG(Debug, "apply part layout...");
+            // Once we are done creating the nodes, we update their layout.
+            // Models without a stored layout (e.g. imported ones) are placed automatically.
+            std::string defaultLayout = guiMap.hasKey("defaultLayout") ? guiMap["defaultLayout"].getString() : std::string();
+            if (!defaultLayout.empty() && guiMap.hasKey("layouts") && guiMap["layouts"].hasKey(defaultLayout) &&
+                !((ConfigMap &)guiMap["layouts"][defaultLayout]).empty())
+            {
+                applyPartLayout(basicModel);
+            }
+            else
+            {
+                autoLayout(false);
+            }
+            state.stage = ModelLoadState::DONE;
+        }
+        loadState.reset();
+        showAliasConflicts();
+        return true;
+    }
 
-                    if (!it.hasKey("name") || (it.hasKey("name") && (((std::string)it["name"]).empty() || (std::string)it["name"] == "UNKNOWN")))
-                    {
-                        // If no name exists, we derive a new name
-                        edge["name"] = edge["fromNode"].getString()
-                            + "_" + edge["fromNodeOutput"].getString()
-                            + "_" + edge["toNode"].getString()
-                            + "_" + edge["toNodeInput"].getString();
-                    } else {
-                        // Name already exist
-                        edge["name"] = it["name"];
-                    }
-                    if(it.hasKey("data"))
-                        edge["data"] = it["data"];
-                    if(it.hasKey("data") && it["data"].isMap() && it["data"].hasKey("decouple"))
-                    {
-                        edge["decouple"] = it["data"]["decouple"];
-                    }
-                    else
-                        edge["decouple"] = false;
+    // Stops a resumable setModelInfo(). Already loaded parts of the model remain in the view.
+    void ComponentModelInterface::cancelModelInfo()
+    {
+        if (loadState)
+        {
+            XROCK_LOG(Info, "load canceled after " << loadState->processed << " of " << loadState->total << " items");
+        }
+        loadState.reset();
+        showAliasConflicts();
+    }
 
-                    if(it.hasKey("data") && it["data"].isMap() && it["data"].hasKey("smooth"))
-                    {
-                        edge["smooth"] = it["data"]["smooth"];
-                    }
-                    else
-                        edge["smooth"] = true;
+    bool ComponentModelInterface::isLoadingModelInfo() const
+    {
+        return (bool)loadState;
+    }
 
-                    if(it.hasKey("data") && it["data"].isMap() && it["data"].hasKey("weight"))
-                    {
-                        edge["weight"] = it["data"]["weight"];
-                    }
+    void ComponentModelInterface::getModelInfoProgress(size_t *processed, size_t *total) const
+    {
+        *processed = loadState ? loadState->processed : 0;
+        *total = loadState ? loadState->total : 0;
+    }
 
-                    if (hasEdge(edge))
-                    {
-                        continue;
-                    }
-                    bagelGui->addEdge(edge);
-                }
+    // Creates the bagel node of a node entry of the basic model. Returns false if the node was not added.
+    bool ComponentModelInterface::loadNode(ConfigItem &it, ModelLoadState &state)
+    {
+        const std::string &name(it["name"].getString());
+        if (bagelGui->getNodeMap(name))
+            return false;
+        const std::string &modelName(it["model"]["name"].getString());
+        const std::string &modelDomain(it["model"]["domain"].getString());
+        const std::string &modelVersion(it["model"]["version"].getString());
+        // Unfortunately, the basicModel has no URI, so we have to construct a unique type id ourselves
+        const std::string &partType(deriveTypeFrom(modelDomain, modelName, modelVersion));
+        // Before we can add a node, we first have to check if the model is already known or
+        // has to be requested from the DB first
+        if (!registerComponentModel(modelDomain, modelName, modelVersion))
+        {
+            XROCK_LOG(Error, "ComponentModelInterface::setModelInfo(): could not register " << partType);
+            return false;
+        }
+        bagelGui->addNode(partType, name);
+
+        // Postprocessing
+        ConfigMap currentMap = *bagelGui->getNodeMap(name);
+        // Update alias, duplicates of the stored model are kept and reported by updateNode()
+        currentMap["alias"] = it.hasKey("alias") ? it["alias"].getString() : "";
+        BasicModelHelper::buildPortIndex(currentMap, state.ports);
+        // Update interface aliases
+        if (it.hasKey("interface_aliases"))
+        {
+            ConfigMap &if_aliases = it["interface_aliases"];
+            for (auto &[original_name, value] : if_aliases)
+            {
+                const std::string &alias(value.getString());
+                // Update matching inputs
+                auto input = state.ports.inputs.find(original_name);
+                if (input != state.ports.inputs.end())
+                    (*input->second)["alias"] = alias;
+                // Update matching outputs
+                auto output = state.ports.outputs.find(original_name);
+                if (output != state.ports.outputs.end())
+                    (*output->second)["alias"] = alias;
             }
+        }
+        BasicModelHelper::updateExportedInterfacesFromModel(currentMap, basicModel, state.interfaces, state.ports, xrockGui->handleAlias());
+        bagelGui->updateNodeMap(name, currentMap);
+        return true;
+    }
 
-            fprintf(stderr, "load configuration...\n");
-            // Add configuration update to nodes and edges
-            if (basicModel["versions"][0]["components"].hasKey("configuration"))
-            {
-                if (basicModel["versions"][0]["components"]["configuration"].hasKey("nodes"))
-                {
-                    auto nodeConfig = basicModel["versions"][0]["components"]["configuration"]["nodes"];
-                    for (auto it : nodeConfig)
-                    {
-                        const std::string &nodeName(it["name"].getString());
-                        ConfigMap currentMap = *bagelGui->getNodeMap(nodeName);
-                        if (it.hasKey("data"))
-                        {
-                            currentMap["configuration"]["data"] = it["data"];
-                        }
-                        if (it.hasKey("submodel"))
-                        {
-                            currentMap["configuration"]["submodel"] = it["submodel"];
-                        }
-                        bagelGui->updateNodeMap(nodeName, currentMap);
-                    }
-                }
-                if (basicModel["versions"][0]["components"]["configuration"].hasKey("edges"))
-                {
-                    auto edgeConfig = basicModel["versions"][0]["components"]["configuration"]["edges"];
-                    for (auto it : edgeConfig)
-                    {
-                        const std::string& edgeName(it["name"].getString());
-                        ConfigMap currentMap = *bagelGui->getEdgeMap(edgeName);
+    // Creates the bagel edge of an edge entry of the basic model
+    void ComponentModelInterface::loadEdge(ConfigItem &it)
+    {
+        BasicModelHelper::decodeData(it);
+        // Edges of imported models might address the nodes and ports by their aliases
+        std::string fromNode = it["from"]["name"].getString();
+        std::string fromNodeOutput = it["from"]["interface"].getString();
+        std::string toNode = it["to"]["name"].getString();
+        std::string toNodeInput = it["to"]["interface"].getString();
+        resolveEdgeEndpoint(fromNode, "outputs", fromNodeOutput);
+        resolveEdgeEndpoint(toNode, "inputs", toNodeInput);
+        ConfigMap edge;
+        edge["fromNode"] = fromNode;
+        edge["fromNodeOutput"] = fromNodeOutput;
+        edge["toNode"] = toNode;
+        edge["toNodeInput"] = toNodeInput;
+
+        if (!it.hasKey("name") || (it.hasKey("name") && (((std::string)it["name"]).empty() || (std::string)it["name"] == "UNKNOWN")))
+        {
+            // If no name exists, we derive a new name
+            edge["name"] = edge["fromNode"].getString()
+                + "_" + edge["fromNodeOutput"].getString()
+                + "_" + edge["toNode"].getString()
+                + "_" + edge["toNodeInput"].getString();
+        } else {
+            // Name already exist
+            edge["name"] = it["name"];
+        }
+        if(it.hasKey("data"))
+            edge["data"] = it["data"];
+        if(it.hasKey("data") && it["data"].isMap() && it["data"].hasKey("decouple"))
+        {
+            edge["decouple"] = it["data"]["decouple"];
+        }
+        else
+            edge["decouple"] = false;
 
-                        // Workaround: name within edge configuration is exported from xtypes for only one
-                        // purpose: to identify the edge when updating its configuration, so its role is done here.
-                        if (it.hasKey("name"))
-                            ((configmaps::ConfigMap&)it).erase("name");
+        if(it.hasKey("data") && it["data"].isMap() && it["data"].hasKey("smooth"))
+        {
+            edge["smooth"] = it["data"]["smooth"];
+        }
+        else
+            edge["smooth"] = true;
 
-                        currentMap["configuration"] = it;
-                        bagelGui->updateEdgeMap(edgeName, currentMap);
-                    }
-                }
-            }
+        if(it.hasKey("data") && it["data"].isMap() && it["data"].hasKey("weight"))
+        {
+            edge["weight"] = it["data"]["weight"];
         }
 
+        if (hasEdge(edge))
+        {
+            return;
+        }
+        bagelGui->addEdge(edge);
+    }
+
+    // Applies the configuration entry of the basic model to the node
+    void ComponentModelInterface::loadNodeConfiguration(ConfigItem &it)
+    {
+        BasicModelHelper::decodeData(it);
+        const std::string &nodeName(it["name"].getString());
+        const ConfigMap *nodeMapPtr = bagelGui->getNodeMap(nodeName);
+        if (!nodeMapPtr)
+            return;
+        ConfigMap currentMap = *nodeMapPtr;
+        if (it.hasKey("data"))
+        {
+            currentMap["configuration"]["data"] = it["data"];
+        }
+        if (it.hasKey("submodel"))
+        {
+            currentMap["configuration"]["submodel"] = it["submodel"];
+        }
+        bagelGui->updateNodeMap(nodeName, currentMap);
+    }
+
+    // Applies the configuration entry of the basic model to the edge
+    void ComponentModelInterface::loadEdgeConfiguration(ConfigItem &it)
+    {
+        BasicModelHelper::decodeData(it);
+        const std::string edgeName(it["name"].getString());
+        const ConfigMap *edgeMapPtr = bagelGui->getEdgeMap(edgeName);
+        if (!edgeMapPtr)
+            return;
+        ConfigMap currentMap = *edgeMapPtr;
+
+        // Workaround: name within edge configuration is exported from xtypes for only one
+        // purpose: to identify the edge when updating its configuration, so its role is done here.
+        ConfigMap configuration = it;
+        if (configuration.hasKey("name"))
+            configuration.erase("name");
 
+        currentMap["configuration"] = configuration;
+        bagelGui->updateEdgeMap(edgeName, currentMap);
+    }
 
-        fprintf(stderr, "apply part layout...\n");
-        // Once we are done creating the nodes, we update their layout
-        applyPartLayout(basicModel);
-        fprintf(stderr, "...done\n");
+    // Applies the layout of the given nodes only
+    void ComponentModelInterface::applyPartLayout(const std::vector<std::string> &nodeNames)
+    {
+        if (nodeNames.empty() || !guiMap.hasKey("layouts") || !guiMap.hasKey("defaultLayout"))
+            return;
+        std::string defaultLayout = guiMap["defaultLayout"];
+        if (!guiMap["layouts"].hasKey(defaultLayout))
+            return;
+        ConfigMap &layoutMap = guiMap["layouts"][defaultLayout];
+        ConfigMap chunkLayout;
+        for (const auto &name : nodeNames)
+        {
+            if (layoutMap.hasKey(name))
+                chunkLayout[name] = layoutMap[name];
+        }
+        if (!chunkLayout.empty())
+            bagelGui->applyLayout(chunkLayout);
     }
 
     void ComponentModelInterface::applyPartLayout(configmaps::ConfigMap &map)
@@ -732,6 +1476,100 @@ namespace xrock_gui_model
         bagelGui->applyLayout(layoutMap[defaultLayout]);
     }
 
+    void ComponentModelInterface::autoLayout(bool forceDirected)
+    {
+        if (nodeMap.empty())
+            return;
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::string> names;
+        std::unordered_map<std::string, size_t> index;
+        names.reserve(nodeMap.size());
+        // in id order, so the layout does not depend on the history of the nodes
+        for (unsigned long id : nodeMap.sortedIds())
+        {
+            const NodeRecord &record = *nodeMap.find(id);
+            index[record.name] = names.size();
+            names.push_back(record.name);
+        }
+        std::vector<GraphLayout::Edge> edges;
+        edges.reserve(edgeMap.size());
+        for (unsigned long id : edgeMap.sortedIds())
+        {
+            ConfigMap &edge = *edgeMap.find(id);
+            if (!edge.hasKey("fromNode") || !edge.hasKey("toNode"))
+                continue;
+            auto from = index.find(edge["fromNode"].getString());
+            auto to = index.find(edge["toNode"].getString());
+            if (from != index.end() && to != index.end())
+                edges.emplace_back(from->second, to->second);
+        }
+
+        std::vector<GraphLayout::Position> positions = GraphLayout::layered(names.size(), edges);
+        if (forceDirected)
+            positions = GraphLayout::forceDirected(positions, edges);
+
+        // keep the other layout properties of the nodes
+        ConfigMap layout = bagelGui->getLayout();
+        for (size_t i = 0; i < names.size(); ++i)
+        {
+            layout[names[i]]["x"] = positions[i].x;
+            layout[names[i]]["y"] = positions[i].y;
+        }
+        bagelGui->applyLayout(layout);
+        updateCurrentLayout();
+        XROCK_LOG(Info, (forceDirected ? "force directed" : "layered") << " layout of " << names.size() << " nodes in "
+                  << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << " ms");
+    }
+
+    void ComponentModelInterface::placeNodes(const std::vector<std::string> &nodeNames)
+    {
+        if (nodeNames.empty())
+            return;
+        std::unordered_set<std::string> newNodes(nodeNames.begin(), nodeNames.end());
+        ConfigMap layout = bagelGui->getLayout();
+        std::vector<GraphLayout::Position> placed;
+        std::unordered_map<std::string, size_t> placedIndex;
+        for (auto &it : layout)
+        {
+            if (newNodes.count(it.first) || !it.second.hasKey("x") || !it.second.hasKey("y"))
+                continue;
+            placedIndex[it.first] = placed.size();
+            placed.push_back(GraphLayout::Position{it.second["x"].getDouble(), it.second["y"].getDouble()});
+        }
+        // a new node is anchored at its first placed neighbor
+        std::unordered_map<std::string, std::string> neighbors;
+        for (unsigned long id : edgeMap.sortedIds())
+        {
+            ConfigMap &edge = *edgeMap.find(id);
+            if (!edge.hasKey("fromNode") || !edge.hasKey("toNode"))
+                continue;
+            const std::string from = edge["fromNode"], to = edge["toNode"];
+            if (newNodes.count(from) && placedIndex.count(to))
+                neighbors.emplace(from, to);
+            if (newNodes.count(to) && placedIndex.count(from))
+                neighbors.emplace(to, from);
+        }
+        std::vector<size_t> anchors(nodeNames.size(), GraphLayout::noAnchor);
+        for (size_t i = 0; i < nodeNames.size(); ++i)
+        {
+            auto neighbor = neighbors.find(nodeNames[i]);
+            if (neighbor != neighbors.end())
+                anchors[i] = placedIndex[neighbor->second];
+        }
+
+        std::vector<GraphLayout::Position> positions = GraphLayout::place(placed, anchors);
+        ConfigMap newLayout;
+        for (size_t i = 0; i < nodeNames.size(); ++i)
+        {
+            if (layout.hasKey(nodeNames[i]))
+                newLayout[nodeNames[i]] = layout[nodeNames[i]];
+            newLayout[nodeNames[i]]["x"] = positions[i].x;
+            newLayout[nodeNames[i]]["y"] = positions[i].y;
+        }
+        bagelGui->applyLayout(newLayout);
+        updateCurrentLayout();
+    }
+
     // This function gets called whenever the XRockGui wants to know the current status of the model.
     // It could be that the model has been altered by the bagelGui, so we have to perform inverse trafos here
     configmaps::ConfigMap &ComponentModelInterface::getModelInfo()
@@ -739,15 +1577,19 @@ namespace xrock_gui_model
         // NOTE: bagelInfo holds the data which might have been altered.
         ConfigMap mi(basicModel);
         BasicModelHelper::clearExportedInterfacesInModel(mi);
+        BasicModelHelper::InterfaceIndex interfaces;
+        BasicModelHelper::buildInterfaceIndex(mi, interfaces);
 
         // NOTE: The toplevel properties have already been updated at this point (see ComponentModelEditorWidget)
         // Update inner components & configuration based on nodeMap
         mi["versions"][0]["components"]["nodes"] = ConfigVector();
         mi["versions"][0]["components"]["configuration"]["nodes"] = ConfigVector();
-        for (auto &[id, node_] : nodeMap)
+        // The nodes are stored in id order like the order they were created in
+        for (unsigned long id : nodeMap.sortedIds())
         {
+            const NodeRecord &node_ = *nodeMap.find(id);
             // Update node entry
-            ConfigMap node = *bagelGui->getNodeMap(node_["name"]);
+            ConfigMap node = *bagelGui->getNodeMap(node_.name);
             ConfigMap n;
             n["name"] = node["name"];
             if (node.hasKey("alias"))
@@ -757,7 +1599,7 @@ namespace xrock_gui_model
             n["model"]["version"] = node["model"]["versions"][0]["name"];
 
             // update exported interfaces
-            BasicModelHelper::updateExportedInterfacesToModel(node, mi, xrockGui->handleAlias());
+            BasicModelHelper::updateExportedInterfacesToModel(node, mi, interfaces, xrockGui->handleAlias());
 
             // Update interface_aliases
             ConfigVector &inputs = node["inputs"];
@@ -786,6 +1628,8 @@ namespace xrock_gui_model
                 mi["versions"][0]["components"]["configuration"]["nodes"].push_back(c);
             }
         }
+        // Remove the interfaces of ports that are not exported anymore
+        BasicModelHelper::finishExportedInterfacesToModel(mi, interfaces);
 
         // Update edges & configuration based on edgeMap
         mi["versions"][0]["components"]["edges"] = ConfigVector();
@@ -897,7 +1741,16 @@ namespace xrock_gui_model
         if (map["model"]["versions"][0].hasKey("defaultConfiguration"))
         {
             // The node map already contains the default configuration
-            map["configuration"] = map["model"]["versions"][0]["defaultConfiguration"];
+            ConfigItem &defaultConfig = map["model"]["versions"][0]["defaultConfiguration"];
+            try
+            {
+                BasicModelHelper::decodeData(defaultConfig);
+            }
+            catch (...)
+            {
+                XROCK_LOG(Warning, "ComponentModelInterface::resetConfig(): invalid default configuration");
+            }
+            map["configuration"] = defaultConfig;
         }
     }
 
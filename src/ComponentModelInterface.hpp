@@ -6,10 +6,15 @@
 
 #pragma once
 #include <bagel_gui/ModelInterface.hpp>
+#include "utils/SlotMap.hpp"
+#include <chrono>
+#include <memory>
+#include <unordered_map>
 
 namespace xrock_gui_model
 {
     class XRockGUI;
+    class NodeInfoCache;
 
     class ComponentModelInterface : public bagel_gui::ModelInterface
     {
@@ -60,12 +65,40 @@ namespace xrock_gui_model
         // These functions set/get the original model and derive the bagel model from it internally.
         // setModelInfo() will also trigger an GUI update
         void setModelInfo(configmaps::ConfigMap &map); // PURE VIRTUAL
+        // Resumable variant of setModelInfo() to keep the GUI responsive while loading large models:
+        // beginModelInfo() sets the model and continueModelInfo() loads the next chunk within the given
+        // time budget (ms). It returns true once the model is completely loaded.
+        void beginModelInfo(configmaps::ConfigMap &map);
+        bool continueModelInfo(double timeBudget);
+        void cancelModelInfo();
+        bool isLoadingModelInfo() const;
+        void getModelInfoProgress(size_t *processed, size_t *total) const;
         configmaps::ConfigMap &getModelInfo(); // PURE VIRTUAL
         // This function will register a component model if it is not already registered.
         // If the model is unknown it will request it internally
         bool registerComponentModel(const std::string& domain, const std::string& name, const std::string& version);
+        // Returns the inner components (nodes, edges, configuration) of the part model of the node.
+        // The part models of the nodes are collapsed to their interface summary until this is called.
+        configmaps::ConfigMap getInnerComponents(configmaps::ConfigMap &node);
+        // Returns the complete component model of a part (including its inner components).
+        // Registered part models are used if available, otherwise the model is requested from the DB.
+        configmaps::ConfigMap getPartModel(const std::string &domain, const std::string &name, const std::string &version);
+        // Revisions of a node (entry and configuration) and of the part model returned by getPartModel(),
+        // they change with every change of the content (see CndExporter::setRevisions()). 0 means unknown,
+        // e.g. for part models which are not resident and are requested from the DB.
+        uint64_t getNodeRevision(const std::string &name) const;
+        uint64_t getPartModelRevision(const std::string &domain, const std::string &name, const std::string &version);
+        // Unique for every model instance and never reused, so a model can be recognized by asynchronous
+        // callbacks without keeping a pointer to it which may dangle or point to a new model at the same address
+        uint64_t getInstanceId() const { return instanceId; }
         // This function tries to find layout specific info in the given model and will update the layout/positions of the parts
         void applyPartLayout(configmaps::ConfigMap &map);
+        // Computes the positions of all nodes (layered, optionally refined by a force directed layout)
+        // and applies them to the current layout
+        void autoLayout(bool forceDirected);
+        // Places the given (new) nodes without moving the others: next to an already placed neighbor
+        // or in a free column right of the layout
+        void placeNodes(const std::vector<std::string> &nodeNames);
 
         // NOTE: If requested by the user, this function resets the node configuration to be the default config of the associated component model
         void resetConfig(configmaps::ConfigMap &map);
@@ -74,14 +107,49 @@ namespace xrock_gui_model
         void addLayout(std::string layout);
         void setSimpleTypeGen() { simpleTypeGen=true; }
 
+        // Alias lookups of the current model. isNodeAliasUnique() checks that no other node uses the alias as its
+        // display name.
+        // The resolve functions return the node/port name or an empty string if the alias is unknown.
+        // findNodeId() looks up the id of a node by its name or display name.
+        bool isNodeAliasUnique(const std::string &alias, unsigned long nodeId) const;
+        std::string resolveNodeAlias(const std::string &alias) const;
+        bool findNodeId(const std::string &name, unsigned long &nodeId) const;
+        std::string resolvePortAlias(const std::string &nodeName, const std::string &portType, const std::string &alias) const;
+
     private:
         // We need a reference to the XRockGUI for DB accesses
         XRockGUI* xrockGui;
 
         bool simpleTypeGen;
 
-        std::map<unsigned long, configmaps::ConfigMap> nodeMap;
-        std::map<unsigned long, configmaps::ConfigMap> edgeMap;
+        // Lightweight record of a node added by the bagel gui. It holds only the fields that updateNode()
+        // has to protect. The component model is immutable and shared between all nodes of the same type.
+        struct NodeRecord
+        {
+            std::string name;
+            std::string type;
+            bool hasUri = false;
+            std::string uri;
+            std::shared_ptr<const configmaps::ConfigMap> model;
+            std::vector<std::string> inputNames, outputNames;
+            // Aliases of the node and its ports. The alias indices map port names and aliases to port names.
+            std::string alias;
+            std::vector<std::string> inputAliases, outputAliases;
+            std::unordered_map<std::string, std::string> inputAliasIndex, outputAliasIndex;
+            // changes with every addNode()/updateNode() call
+            uint64_t revision = 0;
+        };
+        SlotMap<NodeRecord> nodeMap;
+        // Shared component models by node type (see NodeRecord::model). A model is kept while its type is
+        // registered, so removed and re-added nodes and clones of the interface reuse the same copy.
+        std::map<std::string, std::shared_ptr<const configmaps::ConfigMap>> sharedModels;
+        SlotMap<configmaps::ConfigMap> edgeMap;
+        // Name -> id index of the node store
+        std::unordered_map<std::string, unsigned long> nodeIds;
+        // Endpoints (see edgeEndpointKey()) -> number of edges connecting them, for hasEdge()
+        std::unordered_map<std::string, size_t> edgeEndpoints;
+        // Display name (alias or name if no alias is set) -> node ids
+        std::unordered_map<std::string, std::vector<unsigned long>> nodeAliases;
 
         // Map which holds a mixed and transformed version of the component models of the parts and the part itself (needed to show their interfaces etc.)
         // it is accessed by an unqiue identifier. The basic model uses domain, name, version keys as a unique identifier.
@@ -97,11 +165,59 @@ namespace xrock_gui_model
         // This map stores the ORIGINAL info of the compponent models of the parts.
         // TODO: This might not be needed anymore, because we store the complete model in the nodeInfoMap as well.
         std::map<std::string, configmaps::ConfigMap> partModels;
-
-        void loadNodeInfo(std::string path, bool orogen = false); // NOTE: Needed for bagel/shader stuff. Could be moved to XRockGui itself
+        // Revision of the part model of a type in partModels or nodeInfoMap (see getPartModelRevision())
+        std::map<std::string, uint64_t> partRevisions;
+        void touchPartModel(const std::string &type);
+        uint64_t instanceId;
+
+        // Usage counts of the types registered on demand by registerComponentModel().
+        // Types without an entry (e.g. preloaded from xrock_node_definitions) are pinned and never evicted.
+        struct TypeUsage
+        {
+            size_t refCount = 0;
+            size_t estimatedSize = 0;
+            std::chrono::steady_clock::time_point lastReleased;
+        };
+        std::map<std::string, TypeUsage> typeUsage;
+        // Unreferenced types are kept at least for this time (seconds). Nodes of an evicted type which are
+        // restored later, e.g. by an undo, register it again (see restoreType()).
+        double typeGracePeriod;
+        // Unreferenced types are only evicted if the registered types exceed this budget (bytes)
+        size_t typeMemoryBudget;
+
+        const NodeRecord *findNodeRecord(const std::string &name) const;
+        void indexAliases(unsigned long nodeId, NodeRecord &record);
+        void indexNodeAlias(unsigned long nodeId, const NodeRecord &record);
+        void unindexNodeAlias(unsigned long nodeId, const NodeRecord &record);
+        void resolveEdgeEndpoint(std::string &nodeName, const std::string &portType, std::string &portName) const;
+        void updatePortAliases(configmaps::ConfigVector &ports, const std::string &nodeName,
+                               const std::vector<std::string> &names, std::vector<std::string> &aliases,
+                               std::unordered_map<std::string, std::string> &aliasIndex);
+        // Duplicate names and aliases are shown to the user (see updateNode())
+        std::vector<std::string> aliasConflicts;
+        void reportAliasConflict(const std::string &message);
+        void showAliasConflicts();
+        bool hasNodePort(const std::string &nodeName, const std::string &portType, const std::string &portName);
+
+        void restoreType(const std::string &type, configmaps::ConfigMap &model);
+        void acquireType(const std::string &type);
+        void releaseType(const std::string &type);
+        void evictUnusedTypes();
+
+        void loadNodeInfo(std::string path, bool orogen = false, size_t numThreads = 0, NodeInfoCache *cache = NULL); // NOTE: Needed for bagel/shader stuff. Could be moved to XRockGui itself
         bool addOrogenInfo(configmaps::ConfigMap &model); // DEPRECATED
+        // Transforms the component model into the NodeInfo (interfaces to inputs/outputs etc.) shown by the bagel gui
+        osg_graph_viz::NodeInfo createNodeInfo(const std::string &type, configmaps::ConfigMap &model);
 
         void updateCurrentLayout();
+
+        struct ModelLoadState;
+        std::unique_ptr<ModelLoadState> loadState;
+        bool loadNode(configmaps::ConfigItem &it, ModelLoadState &state);
+        void loadEdge(configmaps::ConfigItem &it);
+        void loadNodeConfiguration(configmaps::ConfigItem &it);
+        void loadEdgeConfiguration(configmaps::ConfigItem &it);
+        void applyPartLayout(const std::vector<std::string> &nodeNames);
     };
 } // end of namespace xrock_gui_model
 
@@ -1,4 +1,11 @@
 #include "ConfigMapHelper.hpp"
+#include "Logger.hpp"
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <istream>
+#include <ostream>
+#include <sstream>
 
 using namespace configmaps;
 
@@ -22,7 +29,7 @@ namespace xrock_gui_model
                 }
                 catch (...)
                 {
-                    std::cerr << "ERROR: unpack submodel" << std::endl;
+                    XROCK_LOG(Error, "ConfigMapHelper: could not unpack submodel");
                 }
             }
             if (it.hasKey("submodel"))
@@ -58,7 +65,7 @@ namespace xrock_gui_model
                 }
                 catch (...)
                 {
-                    std::cerr << "ERROR: pack submodel" << std::endl;
+                    XROCK_LOG(Error, "ConfigMapHelper: could not pack submodel");
                 }
             }
             if (it.hasKey("submodel"))
@@ -69,36 +76,721 @@ namespace xrock_gui_model
         }
     }
 
-    // todo: add vector handling and then move to configmaps itself
-    configmaps::ConfigItem *ConfigMapHelper::getSubItem(configmaps::ConfigMap &map,
-                                                        std::vector<std::string> path)
+    ConfigPath::ConfigPath(const std::string &path, char separator)
+    {
+        size_t start = 0;
+        while (start <= path.size())
+        {
+            size_t end = path.find(separator, start);
+            if (end == std::string::npos)
+                end = path.size();
+            if (end > start)
+                append(path.substr(start, end - start));
+            start = end + 1;
+        }
+    }
+
+    ConfigPath::ConfigPath(const std::vector<std::string> &keys)
+    {
+        segments.reserve(keys.size());
+        for (auto &key : keys)
+            append(key);
+    }
+
+    ConfigPath &ConfigPath::append(const std::string &key)
+    {
+        segments.push_back(Segment{key, parseIndex(key)});
+        return *this;
+    }
+
+    long ConfigPath::parseIndex(const std::string &key)
+    {
+        if (key.empty() || key.size() > 18)
+            return -1;
+        long index = 0;
+        for (char c : key)
+        {
+            if (c < '0' || c > '9')
+                return -1;
+            index = index * 10 + (c - '0');
+        }
+        return index;
+    }
+
+    // Descends one level; returns NULL if the key or index does not exist
+    static ConfigItem *getChild(ConfigItem *item, const std::string &key, long index)
     {
-        if (map.hasKey(path[0]))
+        if (item->isMap())
         {
-            ConfigItem *ptr = map[path[0]];
-            path.erase(path.begin());
-            return getSubItem(ptr, path);
+            if (item->hasKey(key))
+                return (*item)[key];
+        }
+        else if (item->isVector())
+        {
+            if (index >= 0 && (size_t)index < item->size())
+                return (*item)[(size_t)index];
         }
         return NULL;
     }
 
+    // todo: move to configmaps itself
+    configmaps::ConfigItem *ConfigMapHelper::getSubItem(configmaps::ConfigMap &map,
+                                                        const std::vector<std::string> &path)
+    {
+        if (path.empty() || !map.hasKey(path[0]))
+            return NULL;
+        ConfigItem *ptr = map[path[0]];
+        for (size_t i = 1; ptr && i < path.size(); ++i)
+        {
+            ptr = getChild(ptr, path[i], ConfigPath::parseIndex(path[i]));
+        }
+        return ptr;
+    }
+
     configmaps::ConfigItem *ConfigMapHelper::getSubItem(configmaps::ConfigItem *item,
-                                                        std::vector<std::string> path)
+                                                        const std::vector<std::string> &path)
+    {
+        ConfigItem *ptr = item;
+        for (size_t i = 0; ptr && i < path.size(); ++i)
+        {
+            ptr = getChild(ptr, path[i], ConfigPath::parseIndex(path[i]));
+        }
+        return ptr;
+    }
+
+    configmaps::ConfigItem *ConfigMapHelper::getSubItem(configmaps::ConfigMap &map, const ConfigPath &path)
+    {
+        auto &segments = path.getSegments();
+        if (segments.empty() || !map.hasKey(segments[0].key))
+            return NULL;
+        ConfigItem *ptr = map[segments[0].key];
+        for (size_t i = 1; ptr && i < segments.size(); ++i)
+        {
+            ptr = getChild(ptr, segments[i].key, segments[i].index);
+        }
+        return ptr;
+    }
+
+    configmaps::ConfigItem *ConfigMapHelper::getSubItem(configmaps::ConfigItem *item, const ConfigPath &path)
     {
         ConfigItem *ptr = item;
-        for (auto key : path)
+        for (auto &segment : path.getSegments())
+        {
+            if (!ptr)
+                break;
+            ptr = getChild(ptr, segment.key, segment.index);
+        }
+        return ptr;
+    }
+
+    // configmaps has no const accessors. The const lookups below check every key and index
+    // before they descend, so they never insert anything and the tree is not modified.
+    const configmaps::ConfigItem *ConfigMapHelper::findItem(const configmaps::ConfigMap &map, const ConfigPath &path)
+    {
+        return getSubItem(const_cast<ConfigMap &>(map), path);
+    }
+
+    const configmaps::ConfigItem *ConfigMapHelper::findItem(const configmaps::ConfigItem &item, const ConfigPath &path)
+    {
+        return getSubItem(const_cast<ConfigItem *>(&item), path);
+    }
+
+    std::string ConfigMapHelper::getString(const configmaps::ConfigMap &map, const ConfigPath &path,
+                                           const std::string &defaultValue)
+    {
+        ConfigItem *found = getSubItem(const_cast<ConfigMap &>(map), path);
+        if (!found || !found->isAtom())
+            return defaultValue;
+        return found->toString();
+    }
+
+    std::string ConfigMapHelper::getString(const configmaps::ConfigItem &item, const ConfigPath &path,
+                                           const std::string &defaultValue)
+    {
+        ConfigItem *found = getSubItem(const_cast<ConfigItem *>(&item), path);
+        if (!found || !found->isAtom())
+            return defaultValue;
+        return found->toString();
+    }
+
+    size_t ConfigMapHelper::getSize(const configmaps::ConfigItem &item)
+    {
+        ConfigItem &mutableItem = const_cast<ConfigItem &>(item);
+        if (!mutableItem.isMap() && !mutableItem.isVector())
+            return 0;
+        return mutableItem.size();
+    }
+
+    bool ConfigMapHelper::getMap(const configmaps::ConfigMap &map, const ConfigPath &path, configmaps::ConfigMap &result)
+    {
+        ConfigItem *found = getSubItem(const_cast<ConfigMap &>(map), path);
+        if (!found || !found->isMap())
+            return false;
+        result = *found;
+        return true;
+    }
+
+    static bool isBlank(const std::string &value)
+    {
+        return value.find_first_not_of(" \t\r\n") == std::string::npos;
+    }
+
+    bool ConfigMapHelper::prune(configmaps::ConfigItem &item)
+    {
+        if (item.isAtom())
         {
-            if (ptr->isMap() and ptr->hasKey(key))
+            return isBlank(item.toString());
+        }
+        if (item.isMap())
+        {
+            ConfigMap &map = item;
+            ConfigMap::iterator it = map.begin();
+            while (it != map.end())
             {
-                ptr = (*ptr)[key];
+                ConfigMap::iterator next = it;
+                ++next;
+                if (prune(it->second))
+                    item.erase(it);
+                it = next;
             }
+            return map.empty();
+        }
+        if (item.isVector())
+        {
+            ConfigVector &vector = item;
+            size_t next = 0;
+            for (size_t i = 0; i < vector.size(); ++i)
+            {
+                if (prune(vector[i]))
+                    continue;
+                if (i != next)
+                    vector[next] = std::move(vector[i]);
+                ++next;
+            }
+            vector.erase(vector.begin() + next, vector.end());
+            return vector.empty();
+        }
+        // undefined items are removed as well
+        return true;
+    }
+
+    bool ConfigMapHelper::equals(const configmaps::ConfigItem &constA, const configmaps::ConfigItem &constB)
+    {
+        ConfigItem &a = const_cast<ConfigItem &>(constA);
+        ConfigItem &b = const_cast<ConfigItem &>(constB);
+        if (a.isMap())
+        {
+            return b.isMap() && equals((ConfigMap &)a, (ConfigMap &)b);
+        }
+        if (a.isVector())
+        {
+            if (!b.isVector() || a.size() != b.size())
+                return false;
+            for (size_t i = 0; i < a.size(); ++i)
+            {
+                if (!equals(a[i], b[i]))
+                    return false;
+            }
+            return true;
+        }
+        if (a.isAtom())
+        {
+            return b.isAtom() && a.toString() == b.toString();
+        }
+        return !b.isAtom() && !b.isMap() && !b.isVector();
+    }
+
+    bool ConfigMapHelper::equals(const configmaps::ConfigMap &constA, const configmaps::ConfigMap &constB)
+    {
+        ConfigMap &a = const_cast<ConfigMap &>(constA);
+        ConfigMap &b = const_cast<ConfigMap &>(constB);
+        if (a.size() != b.size())
+            return false;
+        for (auto &it : a)
+        {
+            auto found = b.find(it.first);
+            if (found == b.end() || !equals(it.second, found->second))
+                return false;
+        }
+        return true;
+    }
+
+    void ConfigMapHelper::merge(configmaps::ConfigItem &target, configmaps::ConfigItem &source)
+    {
+        if (target.isMap() && source.isMap())
+        {
+            merge((ConfigMap &)target, (ConfigMap &)source);
+        }
+        else
+        {
+            target = source;
+        }
+    }
+
+    void ConfigMapHelper::merge(configmaps::ConfigMap &target, configmaps::ConfigMap &source)
+    {
+        for (auto &it : source)
+        {
+            if (target.hasKey(it.first))
+                merge(target[it.first], it.second);
             else
+                target[it.first] = it.second;
+        }
+    }
+
+    size_t ConfigMapHelper::estimateSize(configmaps::ConfigItem &item)
+    {
+        size_t size = sizeof(ConfigItem);
+        if (item.isMap())
+        {
+            for (auto it = item.beginMap(); it != item.endMap(); ++it)
             {
-                std::cerr << "ERROR: accessing submap: " << key.c_str() << std::endl;
-                return NULL;
+                size += it->first.size() + estimateSize(it->second);
             }
         }
-        return ptr;
+        else if (item.isVector())
+        {
+            for (auto it = item.begin(); it != item.end(); ++it)
+            {
+                size += estimateSize(*it);
+            }
+        }
+        else if (item.isAtom())
+        {
+            size += item.toString().size();
+        }
+        return size;
+    }
+
+    size_t ConfigMapHelper::estimateSize(configmaps::ConfigMap &map)
+    {
+        size_t size = sizeof(ConfigMap);
+        for (auto &it : map)
+        {
+            size += it.first.size() + estimateSize(it.second);
+        }
+        return size;
+    }
+
+    namespace
+    {
+        enum BinaryTag : uint8_t
+        {
+            TAG_EMPTY = 0,
+            TAG_MAP,
+            TAG_VECTOR,
+            TAG_STRING,
+            TAG_INT,
+            TAG_UINT,
+            TAG_ULONG,
+            TAG_DOUBLE,
+            TAG_BOOL,
+            TAG_UNDEFINED
+        };
+
+        bool readMapEntries(std::istream &in, ConfigMap &map)
+        {
+            uint64_t size;
+            if (!ConfigMapHelper::readBinaryValue(in, size))
+                return false;
+            std::string key;
+            for (uint64_t i = 0; i < size; ++i)
+            {
+                if (!ConfigMapHelper::readBinaryString(in, key) || !ConfigMapHelper::readBinary(in, map[key]))
+                    return false;
+            }
+            return true;
+        }
+    }
+
+    void ConfigMapHelper::writeBinaryString(std::ostream &out, const std::string &value)
+    {
+        writeBinaryValue<uint64_t>(out, value.size());
+        out.write(value.data(), value.size());
+    }
+
+    bool ConfigMapHelper::readBinaryString(std::istream &in, std::string &value)
+    {
+        uint64_t size;
+        if (!readBinaryValue(in, size))
+            return false;
+        value.resize(size);
+        return size == 0 || (bool)in.read(&value[0], size);
+    }
+
+    void ConfigMapHelper::writeBinary(std::ostream &out, configmaps::ConfigMap &map)
+    {
+        writeBinaryValue<uint8_t>(out, TAG_MAP);
+        writeBinaryValue<uint64_t>(out, map.size());
+        for (auto &it : map)
+        {
+            writeBinaryString(out, it.first);
+            writeBinary(out, it.second);
+        }
+    }
+
+    bool ConfigMapHelper::readBinary(std::istream &in, configmaps::ConfigMap &map)
+    {
+        uint8_t tag;
+        if (!readBinaryValue(in, tag) || tag != TAG_MAP)
+            return false;
+        return readMapEntries(in, map);
+    }
+
+    void ConfigMapHelper::writeBinary(std::ostream &out, configmaps::ConfigItem &item)
+    {
+        if (item.isMap())
+        {
+            writeBinary(out, (ConfigMap &)item);
+        }
+        else if (item.isVector())
+        {
+            writeBinaryValue<uint8_t>(out, TAG_VECTOR);
+            writeBinaryValue<uint64_t>(out, item.size());
+            for (auto it = item.begin(); it != item.end(); ++it)
+            {
+                writeBinary(out, *it);
+            }
+        }
+        else if (item.isAtom())
+        {
+            ConfigAtom &atom = static_cast<ConfigAtom &>(item);
+            switch (atom.getType())
+            {
+            case ConfigAtom::ItemType::STRING_TYPE:
+                writeBinaryValue<uint8_t>(out, TAG_STRING);
+                writeBinaryString(out, atom.getString());
+                break;
+            case ConfigAtom::ItemType::INT_TYPE:
+                writeBinaryValue<uint8_t>(out, TAG_INT);
+                writeBinaryValue<int32_t>(out, atom.getInt());
+                break;
+            case ConfigAtom::ItemType::UINT_TYPE:
+                writeBinaryValue<uint8_t>(out, TAG_UINT);
+                writeBinaryValue<uint32_t>(out, atom.getUInt());
+                break;
+            case ConfigAtom::ItemType::ULONG_TYPE:
+                writeBinaryValue<uint8_t>(out, TAG_ULONG);
+                writeBinaryValue<uint64_t>(out, atom.getULong());
+                break;
+            case ConfigAtom::ItemType::DOUBLE_TYPE:
+                writeBinaryValue<uint8_t>(out, TAG_DOUBLE);
+                writeBinaryValue<double>(out, atom.getDouble());
+                break;
+            case ConfigAtom::ItemType::BOOL_TYPE:
+                writeBinaryValue<uint8_t>(out, TAG_BOOL);
+                writeBinaryValue<uint8_t>(out, atom.getBool());
+                break;
+            default:
+                writeBinaryValue<uint8_t>(out, TAG_UNDEFINED);
+                writeBinaryString(out, atom.toString());
+                break;
+            }
+        }
+        else
+        {
+            writeBinaryValue<uint8_t>(out, TAG_EMPTY);
+        }
+    }
+
+    bool ConfigMapHelper::readBinary(std::istream &in, configmaps::ConfigItem &item)
+    {
+        uint8_t tag;
+        if (!readBinaryValue(in, tag))
+            return false;
+        switch (tag)
+        {
+        case TAG_EMPTY:
+            return true;
+        case TAG_MAP:
+        {
+            item = ConfigMap();
+            return readMapEntries(in, item);
+        }
+        case TAG_VECTOR:
+        {
+            uint64_t size;
+            if (!readBinaryValue(in, size))
+                return false;
+            item = ConfigVector();
+            ConfigVector &vector = item;
+            for (uint64_t i = 0; i < size; ++i)
+            {
+                vector.push_back(ConfigItem());
+                if (!readBinary(in, vector.back()))
+                    return false;
+            }
+            return true;
+        }
+        case TAG_STRING:
+        case TAG_UNDEFINED:
+        {
+            std::string value;
+            if (!readBinaryString(in, value))
+                return false;
+            item = ConfigAtom(value);
+            return true;
+        }
+        case TAG_INT:
+        {
+            int32_t value;
+            if (!readBinaryValue(in, value))
+                return false;
+            item = ConfigAtom((int)value);
+            return true;
+        }
+        case TAG_UINT:
+        {
+            uint32_t value;
+            if (!readBinaryValue(in, value))
+                return false;
+            item = ConfigAtom((unsigned int)value);
+            return true;
+        }
+        case TAG_ULONG:
+        {
+            uint64_t value;
+            if (!readBinaryValue(in, value))
+                return false;
+            item = ConfigAtom((unsigned long)value);
+            return true;
+        }
+        case TAG_DOUBLE:
+        {
+            double value;
+            if (!readBinaryValue(in, value))
+                return false;
+            item = ConfigAtom(value);
+            return true;
+        }
+        case TAG_BOOL:
+        {
+            uint8_t value;
+            if (!readBinaryValue(in, value))
+                return false;
+            item = ConfigAtom(value != 0);
+            return true;
+        }
+        default:
+            return false;
+        }
+    }
+
+    size_t ConfigMapHelper::hash(configmaps::ConfigItem &item)
+    {
+        std::ostringstream out;
+        writeBinary(out, item);
+        return std::hash<std::string>()(out.str());
+    }
+
+    size_t ConfigMapHelper::hash(configmaps::ConfigMap &map)
+    {
+        std::ostringstream out;
+        writeBinary(out, map);
+        return std::hash<std::string>()(out.str());
+    }
+
+    void SubmodelView::unpack(ConfigMap &target, size_t depth)
+    {
+        target["submodel"] = ConfigVector();
+        unpack(target["submodel"], source, entries, depth);
+    }
+
+    size_t SubmodelView::pack(ConfigMap &edited)
+    {
+        if (!edited.hasKey("submodel") || !edited["submodel"].isVector())
+            return 0;
+        return pack(source, edited["submodel"], entries);
+    }
+
+    void SubmodelView::decode(ConfigItem &sourceEntry, Entry &entry)
+    {
+        if (entry.decoded)
+            return;
+        entry.decoded = true;
+        entry.hasData = sourceEntry.hasKey("data");
+        if (!entry.hasData)
+            return;
+        ConfigItem &data = sourceEntry["data"];
+        entry.stringData = !data.isMap();
+        try
+        {
+            if (entry.stringData)
+                entry.data = ConfigMap::fromYamlString(data.getString());
+            else
+                entry.data = data;
+        }
+        catch (...)
+        {
+            XROCK_LOG(Error, "ConfigMapHelper: could not unpack submodel");
+            entry.hasData = false;
+        }
+    }
+
+    void SubmodelView::unpack(ConfigVector &target, ConfigVector &source, std::vector<Entry> &entries, size_t depth)
+    {
+        entries.resize(source.size());
+        for (size_t i = 0; i < source.size(); ++i)
+        {
+            ConfigItem &it = source[i];
+            Entry &entry = entries[i];
+            target.push_back(ConfigMap());
+            ConfigItem &out = target.back();
+            out["name"] = it["name"];
+            if (depth > 0)
+            {
+                decode(it, entry);
+                if (entry.hasData)
+                    out["data"] = entry.data;
+            }
+            else if (it.hasKey("data"))
+            {
+                out["data"] = it["data"];
+            }
+            if (it.hasKey("submodel"))
+            {
+                if (depth > 1 && it["submodel"].isVector())
+                {
+                    out["submodel"] = ConfigVector();
+                    unpack(out["submodel"], it["submodel"], entry.children, depth - 1);
+                }
+                else
+                {
+                    out["submodel"] = it["submodel"];
+                }
+            }
+        }
+    }
+
+    size_t SubmodelView::pack(ConfigVector &source, ConfigVector &edited, std::vector<Entry> &entries)
+    {
+        size_t modified = 0;
+        if (entries.size() < edited.size())
+            entries.resize(edited.size());
+        for (size_t i = 0; i < edited.size(); ++i)
+        {
+            ConfigItem &it = edited[i];
+            Entry &entry = entries[i];
+            if (i >= source.size())
+            {
+                // new entry: store the data as map
+                source.push_back(ConfigMap());
+                entry.decoded = true;
+            }
+            ConfigItem &out = source[i];
+            bool changed = !out.hasKey("name") || out["name"].toString() != it["name"].toString();
+            if (changed)
+                out["name"] = it["name"];
+            if (it.hasKey("data") && !it["data"].isMap())
+            {
+                // Data below the unpacked depth is still in its stored encoding and only compared as text
+                if (!out.hasKey("data") || out["data"].isMap() || out["data"].toString() != it["data"].toString())
+                {
+                    out["data"] = it["data"];
+                    entry.decoded = false;
+                    changed = true;
+                }
+            }
+            else if (it.hasKey("data"))
+            {
+                decode(out, entry);
+                if (!entry.hasData || !ConfigMapHelper::equals(it["data"], entry.data))
+                {
+                    try
+                    {
+                        // keep the encoding of an existing data entry
+                        if (entry.hasData && entry.stringData)
+                            out["data"] = it["data"].toYamlString();
+                        else
+                            out["data"] = it["data"];
+                    }
+                    catch (...)
+                    {
+                        XROCK_LOG(Error, "ConfigMapHelper: could not pack submodel");
+                    }
+                    entry.hasData = true;
+                    entry.data = it["data"];
+                    changed = true;
+                }
+            }
+            if (changed)
+                ++modified;
+            if (it.hasKey("submodel") && it["submodel"].isVector())
+            {
+                if (!out.hasKey("submodel"))
+                    out["submodel"] = ConfigVector();
+                modified += pack(out["submodel"], it["submodel"], entry.children);
+            }
+        }
+        return modified;
+    }
+
+    static ConfigItem *findEntry(ConfigVector &entries, const std::string &name)
+    {
+        for (auto &entry : entries)
+        {
+            if (entry.hasKey("name") && entry["name"].toString() == name)
+                return &entry;
+        }
+        return NULL;
+    }
+
+    void SubmodelView::overlay(ConfigVector &target, ConfigVector &overrides)
+    {
+        for (auto &entry : overrides)
+        {
+            ConfigItem *found = findEntry(target, entry["name"].toString());
+            if (!found)
+            {
+                target.push_back(entry);
+                continue;
+            }
+            if (entry.hasKey("data"))
+                (*found)["data"] = entry["data"];
+            if (entry.hasKey("submodel") && entry["submodel"].isVector())
+            {
+                if (!found->hasKey("submodel") || !(*found)["submodel"].isVector())
+                    (*found)["submodel"] = ConfigVector();
+                overlay((*found)["submodel"], entry["submodel"]);
+            }
+        }
+    }
+
+    size_t SubmodelView::diff(ConfigVector &edited, ConfigVector &defaults, ConfigVector &changed)
+    {
+        size_t numChanged = 0;
+        for (auto &entry : edited)
+        {
+            ConfigItem *defaultEntry = findEntry(defaults, entry["name"].toString());
+            if (!defaultEntry)
+            {
+                changed.push_back(entry);
+                ++numChanged;
+                continue;
+            }
+            ConfigMap out;
+            out["name"] = entry["name"];
+            if (entry.hasKey("data") &&
+                (!defaultEntry->hasKey("data") || !ConfigMapHelper::equals(entry["data"], (*defaultEntry)["data"])))
+            {
+                out["data"] = entry["data"];
+                ++numChanged;
+            }
+            if (entry.hasKey("submodel") && entry["submodel"].isVector())
+            {
+                ConfigVector emptyDefaults;
+                ConfigVector submodel;
+                ConfigVector &innerDefaults = defaultEntry->hasKey("submodel") && (*defaultEntry)["submodel"].isVector()
+                                                  ? (ConfigVector &)(*defaultEntry)["submodel"]
+                                                  : emptyDefaults;
+                numChanged += diff(entry["submodel"], innerDefaults, submodel);
+                if (!submodel.empty())
+                    out["submodel"] = submodel;
+            }
+            if (out.hasKey("data") || out.hasKey("submodel"))
+                changed.push_back(out);
+        }
+        return numChanged;
     }
 
 } // end of namespace xrock_gui_model
@@ -6,10 +6,41 @@
 
 #pragma once
 #include <configmaps/ConfigData.h>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
 
 namespace xrock_gui_model
 {
 
+    // A path into a config tree which is parsed once and can be reused for many lookups,
+    // e.g. ConfigPath("configuration/data/interfaces"). Numeric segments address vector
+    // elements, on maps they are used as key.
+    class ConfigPath
+    {
+    public:
+        struct Segment
+        {
+            std::string key;
+            long index; // -1 if the segment is not numeric
+        };
+
+        ConfigPath() {}
+        explicit ConfigPath(const std::string &path, char separator = '/');
+        explicit ConfigPath(const std::vector<std::string> &keys);
+
+        ConfigPath &append(const std::string &key);
+        const std::vector<Segment> &getSegments() const { return segments; }
+        bool empty() const { return segments.empty(); }
+
+        static long parseIndex(const std::string &key);
+
+    private:
+        std::vector<Segment> segments;
+    };
+
     class ConfigMapHelper
     {
     public:
@@ -18,10 +49,109 @@ namespace xrock_gui_model
 
         static void packSubmodel(configmaps::ConfigMap &target, const configmaps::ConfigVector &source);
         static void unpackSubmodel(configmaps::ConfigMap &target, const configmaps::ConfigVector &source);
+        // Returns the item at the given path or NULL if the path does not exist
         static configmaps::ConfigItem *getSubItem(configmaps::ConfigMap &map,
-                                                  std::vector<std::string> path);
+                                                  const std::vector<std::string> &path);
         static configmaps::ConfigItem *getSubItem(configmaps::ConfigItem *item,
-                                                  std::vector<std::string> path);
+                                                  const std::vector<std::string> &path);
+        static configmaps::ConfigItem *getSubItem(configmaps::ConfigMap &map, const ConfigPath &path);
+        static configmaps::ConfigItem *getSubItem(configmaps::ConfigItem *item, const ConfigPath &path);
+        // Lookups in trees which are only available as const, e.g. the node maps of the BagelGui.
+        // findItem returns a pointer into the tree or NULL; nothing is copied and missing keys are never inserted.
+        static const configmaps::ConfigItem *findItem(const configmaps::ConfigMap &map, const ConfigPath &path);
+        static const configmaps::ConfigItem *findItem(const configmaps::ConfigItem &item, const ConfigPath &path);
+        static std::string getString(const configmaps::ConfigMap &map, const ConfigPath &path,
+                                     const std::string &defaultValue = "");
+        static std::string getString(const configmaps::ConfigItem &item, const ConfigPath &path,
+                                     const std::string &defaultValue = "");
+        // Number of entries of a map or vector item, 0 for atoms
+        static size_t getSize(const configmaps::ConfigItem &item);
+        // Copies the map at the given path into result, e.g. to edit a configuration. Returns false if there is no map.
+        static bool getMap(const configmaps::ConfigMap &map, const ConfigPath &path, configmaps::ConfigMap &result);
+        // Removes atoms which are empty or only contain whitespace and all maps and vectors
+        // which become empty by that. Each entry is visited once and vectors are compacted in place.
+        // Returns true if the item itself is empty afterwards.
+        static bool prune(configmaps::ConfigItem &item);
+        // Structural comparison; atoms are compared by their string representation. Nothing is inserted.
+        static bool equals(const configmaps::ConfigItem &a, const configmaps::ConfigItem &b);
+        static bool equals(const configmaps::ConfigMap &a, const configmaps::ConfigMap &b);
+        // Merges source into target: maps are merged recursively key by key, all other
+        // values of source replace the ones in target.
+        static void merge(configmaps::ConfigItem &target, configmaps::ConfigItem &source);
+        static void merge(configmaps::ConfigMap &target, configmaps::ConfigMap &source);
+        // Rough estimate of the memory (bytes) occupied by the given tree
+        static size_t estimateSize(configmaps::ConfigItem &item);
+        static size_t estimateSize(configmaps::ConfigMap &map);
+        // Compact binary (de)serialization of a tree, preserving the atom types.
+        // The format is only meant for local caches (native byte order).
+        static void writeBinary(std::ostream &out, configmaps::ConfigItem &item);
+        static void writeBinary(std::ostream &out, configmaps::ConfigMap &map);
+        static bool readBinary(std::istream &in, configmaps::ConfigItem &item);
+        static bool readBinary(std::istream &in, configmaps::ConfigMap &map);
+        // Primitives of the binary format for local caches storing further data next to trees
+        template <typename T>
+        static void writeBinaryValue(std::ostream &out, const T &value)
+        {
+            out.write(reinterpret_cast<const char *>(&value), sizeof(T));
+        }
+        template <typename T>
+        static bool readBinaryValue(std::istream &in, T &value)
+        {
+            return (bool)in.read(reinterpret_cast<char *>(&value), sizeof(T));
+        }
+        static void writeBinaryString(std::ostream &out, const std::string &value);
+        static bool readBinaryString(std::istream &in, std::string &value);
+        // Hash of the binary form (content and atom types), e.g. to detect changed subtrees
+        static size_t hash(configmaps::ConfigItem &item);
+        static size_t hash(configmaps::ConfigMap &map);
+    };
+
+    // Edit session on the recursive "submodel" configuration of a node. The data of an entry
+    // is only decoded when its level is unpacked and is remembered, so that pack() only writes
+    // back the entries which were changed in the edited tree. Unmodified entries keep their
+    // original encoding (yaml string or map) and are not serialized again.
+    class SubmodelView
+    {
+    public:
+        explicit SubmodelView(configmaps::ConfigVector &source) : source(source) {}
+
+        static const size_t allLevels = SIZE_MAX;
+
+        // Fills target["submodel"] with the entries (e.g. for the ConfigureDialog). The data of
+        // the first depth levels is decoded, deeper levels are copied in their stored encoding.
+        // Decoded entries are kept, so unpacking again only decodes levels which were not decoded yet.
+        void unpack(configmaps::ConfigMap &target, size_t depth = allLevels);
+        // Writes the changes of edited["submodel"] back to the source.
+        // Returns the number of entries which were modified or added.
+        size_t pack(configmaps::ConfigMap &edited);
+
+        // Helpers for unpacked submodel entries which are matched by name, e.g. to show the configuration
+        // of the inner nodes of a part and to store only what differs from the defaults of the part model.
+        // overlay replaces the data of the entries of target by the one of the entries in overrides
+        // (submodels are overlaid recursively) and appends entries which are not in target.
+        static void overlay(configmaps::ConfigVector &target, configmaps::ConfigVector &overrides);
+        // Adds the entries of edited which differ from defaults to changed: an entry keeps its complete
+        // data if it differs and only its changed submodel entries. Returns the number of changed entries.
+        static size_t diff(configmaps::ConfigVector &edited, configmaps::ConfigVector &defaults,
+                           configmaps::ConfigVector &changed);
+
+    private:
+        struct Entry
+        {
+            bool decoded = false;
+            bool hasData = false;
+            bool stringData = false; // data is stored as yaml string in the source
+            configmaps::ConfigItem data;
+            std::vector<Entry> children;
+        };
+
+        static void unpack(configmaps::ConfigVector &target, configmaps::ConfigVector &source, std::vector<Entry> &entries,
+                           size_t depth);
+        static void decode(configmaps::ConfigItem &sourceEntry, Entry &entry);
+        static size_t pack(configmaps::ConfigVector &source, configmaps::ConfigVector &edited, std::vector<Entry> &entries);
+
+        configmaps::ConfigVector &source;
+        std::vector<Entry> entries;
     };
 } // end of namespace xrock_gui_model
 
@@ -1,4 +1,5 @@
 #include "ConfigureDialog.hpp"
+#include "Logger.hpp"
 #include <mars/config_map_gui/DataWidget.h>
 #include <mars/utils/misc.h>
 
@@ -140,7 +141,7 @@ namespace xrock_gui_model
                     if (path.back() != '/')
                         path += "/";
                     path += type + ".yml";
-                    std::cerr << "check for config file: " << path.c_str() << std::endl;
+                    XROCK_LOG(Debug, "check for config file: " << path);
                     if (mars::utils::pathExists(path))
                     {
                         configFileName = path;
@@ -258,7 +259,7 @@ namespace xrock_gui_model
                 }
                 catch (...)
                 {
-                    std::cerr << "Error converting config into yaml map!" << std::endl;
+                    XROCK_LOG(Error, "could not convert the config into a yaml map");
                 }
             }
         }
@@ -0,0 +1,154 @@
+/**
+ * \file DeploymentGenerator.cpp
+ * \brief Creates the orogen deployment package of a component network description (CND)
+ **/
+
+#include "DeploymentGenerator.hpp"
+#include "YamlWriter.hpp"
+#include "utils/ParallelFor.hpp"
+
+#include <mars/utils/misc.h>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <unordered_map>
+#include <vector>
+
+using namespace configmaps;
+
+namespace xrock_gui_model
+{
+
+    bool DeploymentGenerator::generate(ConfigMap &cnd, const std::string &cndFileName,
+                                       const std::string &folder, size_t numThreads)
+    {
+        error.clear();
+        // project name and extension like python's os.path.splitext (leading dots are no extension)
+        std::string baseName = cndFileName;
+        const size_t slash = baseName.rfind('/');
+        if (slash != std::string::npos)
+            baseName = baseName.substr(slash + 1);
+        std::string projectName = baseName, extension;
+        const size_t dot = baseName.rfind('.');
+        const size_t firstNonDot = baseName.find_first_not_of('.');
+        if (dot != std::string::npos && firstNonDot < dot)
+        {
+            projectName = baseName.substr(0, dot);
+            extension = baseName.substr(dot);
+        }
+        if (cnd.hasKey("deployments") && !cnd["deployments"].isMap())
+        {
+            error = "invalid deployments section";
+            return false;
+        }
+
+        std::unordered_map<std::string, ConfigItem *> taskIndex;
+        if (cnd.hasKey("tasks") && cnd["tasks"].isMap())
+        {
+            ConfigMap &tasks = cnd["tasks"];
+            taskIndex.reserve(tasks.size());
+            for (auto &it : tasks)
+                taskIndex.emplace(it.first, &it.second);
+        }
+
+        // the deployments which are not orogen default deployments and their tasks (sorted like PyYAML writes them)
+        std::map<std::string, ConfigItem *> deployments, tasks;
+        ConfigMap noDeployments;
+        ConfigMap &allDeployments = cnd.hasKey("deployments") ? static_cast<ConfigMap &>(cnd["deployments"]) : noDeployments;
+        for (auto &it : allDeployments)
+        {
+            ConfigItem &deployment = it.second;
+            if (!deployment.isMap())
+                continue;
+            if (deployment.hasKey("process_name") &&
+                deployment["process_name"].getString().find("orogen_default_") != std::string::npos)
+            {
+                continue;
+            }
+            deployments[it.first] = &deployment;
+            if (!deployment.hasKey("taskList") || !deployment["taskList"].isMap())
+                continue;
+            ConfigMap &taskList = deployment["taskList"];
+            for (auto &task : taskList)
+            {
+                auto found = taskIndex.find(task.first);
+                if (found != taskIndex.end())
+                    tasks[task.first] = found->second;
+            }
+        }
+
+        // the entries are independent, so they are formatted in parallel and joined in order
+        std::vector<std::pair<const std::string *, ConfigItem *>> entries;
+        entries.reserve(deployments.size() + tasks.size());
+        for (auto &it : deployments)
+            entries.emplace_back(&it.first, it.second);
+        for (auto &it : tasks)
+            entries.emplace_back(&it.first, it.second);
+        std::vector<std::string> blocks(entries.size());
+        parallelFor(entries.size(), [&](size_t i)
+                    {
+            std::ostringstream out;
+            YamlWriter writer(out, YamlWriter::Style::PyYaml);
+            writer.writeEntry(*entries[i].first, *entries[i].second, 1);
+            blocks[i] = out.str(); },
+                    numThreads);
+
+        std::string cndContent = deployments.empty() ? "deployments: {}\n" : "deployments:\n";
+        for (size_t i = 0; i < deployments.size(); ++i)
+            cndContent += blocks[i];
+        cndContent += tasks.empty() ? "tasks: {}\n" : "tasks:\n";
+        for (size_t i = deployments.size(); i < blocks.size(); ++i)
+            cndContent += blocks[i];
+
+        mars::utils::createDirectory(folder);
+        if (!mars::utils::pathExists(folder))
+        {
+            error = "cannot create " + folder;
+            return false;
+        }
+        return writeFile(folder + "/" + baseName, cndContent) &&
+               writeFile(folder + "/CMakeLists.txt",
+                         "cmake_minimum_required(VERSION 3.1)\n"
+                         "project(" + projectName + " VERSION 0.0)\n"
+                         "\n"
+                         "set(CMAKE_MODULE_PATH \"${CMAKE_CURRENT_SOURCE_DIR}/.orogen/config\")\n"
+                         "include(" + projectName + "Base)\n"
+                         "\n") &&
+               writeFile(folder + "/manifest.xml",
+                         "<package>\n"
+                         "  <description brief=\"Autogenerated deployment named " + projectName + "\">\n"
+                         "    This is an autogenerated deployment\n"
+                         "  </description>\n"
+                         "<author>AUTO-GENERATED</author>\n"
+                         "<license></license>\n"
+                         "</package>\n") &&
+               writeFile(folder + "/" + projectName + ".orogen",
+                         "require 'cnd_orogen'\n"
+                         "\n"
+                         "name '" + projectName + "'\n"
+                         "cnd_model = ::CndOrogen.load_cnd_model('" + projectName + extension + "')\n"
+                         "::CndOrogen.load_orogen_project_from_cnd(self, cnd_model)\n");
+    }
+
+    bool DeploymentGenerator::writeFile(const std::string &fileName, const std::string &content)
+    {
+        const std::string tmpFile = fileName + ".tmp";
+        {
+            std::ofstream out(tmpFile, std::ios::trunc);
+            if (!out || !out.write(content.data(), content.size()))
+            {
+                error = "cannot write " + tmpFile;
+                return false;
+            }
+        }
+        if (std::rename(tmpFile.c_str(), fileName.c_str()) != 0)
+        {
+            std::remove(tmpFile.c_str());
+            error = "cannot replace " + fileName;
+            return false;
+        }
+        return true;
+    }
+
+} // end of namespace xrock_gui_model
@@ -0,0 +1,35 @@
+/**
+ * \file DeploymentGenerator.hpp
+ * \brief Creates the orogen deployment package of a component network description (CND)
+ **/
+
+#pragma once
+#include <configmaps/ConfigData.h>
+#include <string>
+
+namespace xrock_gui_model
+{
+
+    class DeploymentGenerator
+    {
+    public:
+        DeploymentGenerator() {}
+        ~DeploymentGenerator() {}
+
+        // Writes the deployment package of the cnd into folder (created if needed):
+        //  - <cndFileName>: the deployments which are not orogen default deployments and their tasks
+        //  - CMakeLists.txt, manifest.xml and <project>.orogen for the project named after cndFileName
+        // The files are the same as written by the former xrock-create-deployment python script
+        // (the cnd in PyYAML's format). The entries of the cnd are formatted on numThreads workers
+        // (0: one per core).
+        bool generate(configmaps::ConfigMap &cnd, const std::string &cndFileName,
+                      const std::string &folder, size_t numThreads = 0);
+        const std::string &getError() const { return error; }
+
+    private:
+        bool writeFile(const std::string &fileName, const std::string &content);
+
+        std::string error;
+    };
+
+} // end of namespace xrock_gui_model
@@ -1,5 +1,8 @@
 #include "FileDB.hpp"
 #include "BasicModelHelper.hpp"
+#include "YamlWriter.hpp"
+#include "utils/ParallelFor.hpp"
+#include "Logger.hpp"
 
 #include <mars/utils/misc.h>
 #include <configmaps/ConfigVector.hpp>
@@ -7,6 +10,7 @@
 #include <iostream>
 #include <iomanip>
 #include <ctime>
+#include <cstdio>
 #include<QMessageBox>
 using namespace configmaps;
 using namespace mars::utils;
@@ -14,10 +18,23 @@ using namespace mars::utils;
 namespace xrock_gui_model
 {
 
-    FileDB::FileDB() : dbAddress("")
+    FileDB::FileDB() : dbAddress(""), formatVersion(0)
     {
     }
 
+    // Models in the current format only carry the identity of the model in the "model" sub-map
+    static void setModelIdentity(ConfigMap &model)
+    {
+        ConfigMap identity;
+        identity["domain"] = model["domain"];
+        identity["name"] = model["name"];
+        if (model.hasKey("type"))
+            identity["type"] = model["type"];
+        if (model.hasKey("versions") && model["versions"].size() > 0)
+            identity["versions"][0]["name"] = model["versions"][0]["name"];
+        model["model"] = identity;
+    }
+
     FileDB::~FileDB()
     {
     }
@@ -138,20 +155,36 @@ namespace xrock_gui_model
                 break;
             }
         }
-        BasicModelHelper::convertFromLegacyModelFormat(result);
+        if (getFormatVersion() < currentFormatVersion)
+        {
+            BasicModelHelper::convertFromLegacyModelFormat(result);
+        }
+        else
+        {
+            BasicModelHelper::normalizeModelData(result);
+            setModelIdentity(result);
+        }
         return result;
     }
 
     bool FileDB::storeModel(const ConfigMap &map_)
     {
         ConfigMap map = map_;
-        BasicModelHelper::convertToLegacyModelFormat(map);
+        if (getFormatVersion() < currentFormatVersion)
+        {
+            BasicModelHelper::convertToLegacyModelFormat(map);
+        }
+        else
+        {
+            map.erase("model");
+        }
 
         std::string model = map["name"];
         std::string type = map["type"];
         std::string version = map["versions"][0]["name"];
 
         // add to indexing
+        std::string error;
         std::string file = "info.yml";
         handleFilenamePrefix(&file, dbAddress);
         ConfigMap info;
@@ -199,20 +232,170 @@ namespace xrock_gui_model
             ConfigMap modelMap;
             modelMap["name"] = version;
             info["models"][modelIndex]["versions"].push_back(modelMap);
-            info.toYamlFile(file);
+            if (!YamlWriter::writeFile(file, info, error))
+            {
+                XROCK_LOG(Error, "FileDB::storeModel: " << error);
+                return false;
+            }
         }
 
         std::string folder = model + "/" + version;
         handleFilenamePrefix(&folder, dbAddress);
         createDirectory(folder);
         file = folder + "/model.yml";
-        map.toYamlFile(file);
+        if (!YamlWriter::writeFile(file, map, error))
+        {
+            XROCK_LOG(Error, "FileDB::storeModel: " << error);
+            return false;
+        }
         return true;
     }
 
     void FileDB::setDbAddress(const std::string &db_Address)
     {
         dbAddress = db_Address;
+        formatVersion = 0;
+    }
+
+    int FileDB::getFormatVersion()
+    {
+        if (formatVersion == 0)
+        {
+            formatVersion = legacyFormatVersion;
+            std::string file = "info.yml";
+            handleFilenamePrefix(&file, dbAddress);
+            if (mars::utils::pathExists(file))
+            {
+                ConfigMap info = ConfigMap::fromYamlFile(file);
+                if (info.hasKey("format_version"))
+                {
+                    formatVersion = (int)info["format_version"];
+                }
+            }
+        }
+        return formatVersion;
+    }
+
+    bool FileDB::migrate(size_t numThreads)
+    {
+        std::string infoFile = "info.yml";
+        handleFilenamePrefix(&infoFile, dbAddress);
+        if (!mars::utils::pathExists(infoFile))
+        {
+            XROCK_LOG(Error, "FileDB::migrate: " << infoFile << " doesn't exist");
+            return false;
+        }
+        ConfigMap info = ConfigMap::fromYamlFile(infoFile);
+        if (info.hasKey("format_version") && (int)info["format_version"] >= currentFormatVersion)
+        {
+            XROCK_LOG(Info, "FileDB::migrate: " << dbAddress << " is already in the current format");
+            formatVersion = (int)info["format_version"];
+            return true;
+        }
+
+        std::vector<std::string> files;
+        if (info.hasKey("models"))
+        {
+            for (auto &it : info["models"])
+            {
+                if (!it.hasKey("versions"))
+                    continue;
+                for (auto &it2 : it["versions"])
+                {
+                    std::string file = it["name"].getString() + "/" + it2["name"].getString() + "/model.yml";
+                    handleFilenamePrefix(&file, dbAddress);
+                    if (mars::utils::pathExists(file))
+                    {
+                        files.push_back(file);
+                    }
+                }
+            }
+        }
+
+        // Convert into temporary files first, so a failure leaves the database untouched
+        std::vector<std::string> errors(files.size());
+        parallelFor(files.size(), [&](size_t i)
+                    {
+            try
+            {
+                ConfigMap map = ConfigMap::fromYamlFile(files[i]);
+                BasicModelHelper::convertFromLegacyModelFormat(map);
+                map.erase("model");
+                YamlWriter::writeFile(files[i] + ".migrating", map, errors[i]);
+            }
+            catch (const std::exception &e)
+            {
+                errors[i] = e.what();
+            }
+            catch (...)
+            {
+                errors[i] = "unknown error";
+            } }, numThreads);
+
+        bool success = true;
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            if (!errors[i].empty())
+            {
+                XROCK_LOG(Error, "FileDB::migrate: could not convert " << files[i] << ": " << errors[i]);
+                success = false;
+            }
+        }
+        if (!success)
+        {
+            for (const auto &file : files)
+            {
+                std::remove((file + ".migrating").c_str());
+            }
+            return false;
+        }
+        // Keep the original files until the database is completely migrated, so a failing rename
+        // or info.yml update restores the previous state instead of leaving a half migrated database
+        size_t replaced = 0;
+        auto rollback = [&]()
+        {
+            for (size_t i = 0; i < files.size(); ++i)
+            {
+                if (i < replaced)
+                {
+                    std::rename((files[i] + ".legacy").c_str(), files[i].c_str());
+                }
+                std::remove((files[i] + ".migrating").c_str());
+            }
+        };
+        for (; replaced < files.size(); ++replaced)
+        {
+            const std::string &file = files[replaced];
+            if (std::rename(file.c_str(), (file + ".legacy").c_str()) != 0)
+            {
+                XROCK_LOG(Error, "FileDB::migrate: could not back up " << file);
+                rollback();
+                return false;
+            }
+            if (std::rename((file + ".migrating").c_str(), file.c_str()) != 0)
+            {
+                XROCK_LOG(Error, "FileDB::migrate: could not replace " << file);
+                // the backup of this file has to be restored as well
+                ++replaced;
+                rollback();
+                return false;
+            }
+        }
+        info["format_version"] = currentFormatVersion;
+        std::string error;
+        if (!YamlWriter::writeFile(infoFile, info, error))
+        {
+            XROCK_LOG(Error, "FileDB::migrate: " << error);
+            rollback();
+            return false;
+        }
+        for (const auto &file : files)
+        {
+            std::remove((file + ".legacy").c_str());
+        }
+        formatVersion = currentFormatVersion;
+        XROCK_LOG(Info, "FileDB::migrate: converted " << files.size() << " model files of " << dbAddress);
+        return true;
     }
 
     configmaps::ConfigMap FileDB::getPropertiesOfComponentModel()
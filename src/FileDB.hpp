@@ -31,7 +31,18 @@ namespace xrock_gui_model
         virtual std::vector<std::string> getDomains() override;
         virtual configmaps::ConfigMap getEmptyComponentModel() override;
 
+        // On-disk format of the model files. It is stored as 'format_version' in info.yml,
+        // databases without this marker use the legacy format.
+        static const int legacyFormatVersion = 1;
+        static const int currentFormatVersion = 2;
+        int getFormatVersion();
+        // Rewrites all models of the database into the current format using numThreads workers (0: one per core).
+        // The model files are only replaced and the format marker is only set if all models could be converted.
+        bool migrate(size_t numThreads = 0);
+
     private:
         std::string dbAddress;
+        // cached format of the database (0: not read yet)
+        int formatVersion;
     };
 } // end of namespace xrock_gui_model
@@ -0,0 +1,449 @@
+/**
+ * \file GraphLayout.cpp
+ * \brief Automatic placement of the nodes of a graph
+ **/
+
+#include "GraphLayout.hpp"
+#include "utils/ParallelFor.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <unordered_set>
+
+namespace xrock_gui_model
+{
+
+    // Number of barycenter sweeps (down and up) to reduce crossings
+    static const int numSweeps = 4;
+    // Barnes-Hut opening criterion: cells with size / distance < theta are approximated by their center of mass
+    static const double theta = 0.8;
+    // Cells with at most this many nodes are not split. Their nodes are stored contiguously and
+    // interact in a branch free loop which the compiler can vectorize.
+    static const uint32_t leafSize = 16;
+    // Number of nodes processed by a worker at once
+    static const size_t forceBlockSize = 256;
+
+    namespace
+    {
+        // Quadtree over a permutation of the nodes: each cell covers the range [begin, end) of the
+        // sorted coordinate arrays
+        struct QuadTree
+        {
+            struct Cell
+            {
+                double x, y;    // center of mass
+                double size2;   // squared edge length
+                uint32_t begin, end;
+                int32_t child[4];
+            };
+            std::vector<Cell> cells;
+            std::vector<uint32_t> order;
+            std::vector<double> sx, sy;
+
+            void build(const std::vector<double> &x, const std::vector<double> &y)
+            {
+                const size_t n = x.size();
+                cells.clear();
+                order.resize(n);
+                for (size_t i = 0; i < n; ++i)
+                    order[i] = (uint32_t)i;
+                double minX = x[0], maxX = x[0], minY = y[0], maxY = y[0];
+                for (size_t i = 1; i < n; ++i)
+                {
+                    minX = std::min(minX, x[i]);
+                    maxX = std::max(maxX, x[i]);
+                    minY = std::min(minY, y[i]);
+                    maxY = std::max(maxY, y[i]);
+                }
+                const double size = std::max(maxX - minX, maxY - minY) + 1.0;
+                split(x, y, 0, (uint32_t)n, minX, minY, size, 0);
+                sx.resize(n);
+                sy.resize(n);
+                for (size_t i = 0; i < n; ++i)
+                {
+                    sx[i] = x[order[i]];
+                    sy[i] = y[order[i]];
+                }
+            }
+
+            int32_t split(const std::vector<double> &x, const std::vector<double> &y,
+                          uint32_t begin, uint32_t end, double left, double top, double size, int depth)
+            {
+                const int32_t index = (int32_t)cells.size();
+                cells.push_back(Cell{0.0, 0.0, size * size, begin, end, {-1, -1, -1, -1}});
+                double cx = 0.0, cy = 0.0;
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    cx += x[order[i]];
+                    cy += y[order[i]];
+                }
+                cells[index].x = cx / (end - begin);
+                cells[index].y = cy / (end - begin);
+                // the depth limit stops the recursion for (nearly) coincident nodes
+                if (end - begin <= leafSize || depth >= 24)
+                    return index;
+
+                const double half = 0.5 * size;
+                const double midX = left + half, midY = top + half;
+                auto first = order.begin() + begin, last = order.begin() + end;
+                auto midTop = std::partition(first, last, [&](uint32_t i)
+                                             { return y[i] < midY; });
+                auto q1 = std::partition(first, midTop, [&](uint32_t i)
+                                         { return x[i] < midX; });
+                auto q3 = std::partition(midTop, last, [&](uint32_t i)
+                                         { return x[i] < midX; });
+                const uint32_t bounds[5] = {begin, (uint32_t)(q1 - order.begin()), (uint32_t)(midTop - order.begin()),
+                                            (uint32_t)(q3 - order.begin()), end};
+                for (int q = 0; q < 4; ++q)
+                {
+                    if (bounds[q] == bounds[q + 1])
+                        continue;
+                    const int32_t child = split(x, y, bounds[q], bounds[q + 1], left + (q % 2) * half,
+                                                top + (q / 2) * half, half, depth + 1);
+                    cells[index].child[q] = child;
+                }
+                return index;
+            }
+        };
+    }
+
+    std::vector<GraphLayout::Position> GraphLayout::layered(size_t numNodes, const std::vector<Edge> &edges,
+                                                            double spacingX, double spacingY,
+                                                            size_t maxColumnSize)
+    {
+        std::vector<Position> positions(numNodes, Position{0.0, 0.0});
+        if (numNodes == 0)
+            return positions;
+        if (maxColumnSize == 0)
+            maxColumnSize = 1;
+
+        std::vector<std::vector<size_t>> successors(numNodes), predecessors(numNodes);
+        for (const Edge &edge : edges)
+        {
+            if (edge.first < numNodes && edge.second < numNodes && edge.first != edge.second)
+                successors[edge.first].push_back(edge.second);
+        }
+
+        // Break cycles: an iterative DFS ignores edges to nodes on the current path (back edges)
+        {
+            enum State : char
+            {
+                NEW,
+                ACTIVE,
+                DONE
+            };
+            std::vector<char> state(numNodes, NEW);
+            std::vector<std::pair<size_t, size_t>> stack;
+            for (size_t root = 0; root < numNodes; ++root)
+            {
+                if (state[root] != NEW)
+                    continue;
+                stack.emplace_back(root, 0);
+                state[root] = ACTIVE;
+                while (!stack.empty())
+                {
+                    size_t node = stack.back().first;
+                    size_t &next = stack.back().second;
+                    if (next < successors[node].size())
+                    {
+                        size_t target = successors[node][next++];
+                        if (state[target] == ACTIVE)
+                            continue;
+                        predecessors[target].push_back(node);
+                        if (state[target] == NEW)
+                        {
+                            state[target] = ACTIVE;
+                            stack.emplace_back(target, 0);
+                        }
+                    }
+                    else
+                    {
+                        state[node] = DONE;
+                        stack.pop_back();
+                    }
+                }
+            }
+        }
+
+        // Longest path layering in topological order (Kahn) of the acyclic graph
+        std::vector<size_t> layer(numNodes, 0), inDegree(numNodes, 0);
+        std::vector<std::vector<size_t>> forward(numNodes);
+        for (size_t node = 0; node < numNodes; ++node)
+        {
+            for (size_t source : predecessors[node])
+                forward[source].push_back(node);
+            inDegree[node] = predecessors[node].size();
+        }
+        std::vector<size_t> queue;
+        queue.reserve(numNodes);
+        for (size_t node = 0; node < numNodes; ++node)
+        {
+            if (inDegree[node] == 0)
+                queue.push_back(node);
+        }
+        size_t numLayers = 1;
+        for (size_t i = 0; i < queue.size(); ++i)
+        {
+            size_t node = queue[i];
+            numLayers = std::max(numLayers, layer[node] + 1);
+            for (size_t target : forward[node])
+            {
+                layer[target] = std::max(layer[target], layer[node] + 1);
+                if (--inDegree[target] == 0)
+                    queue.push_back(target);
+            }
+        }
+
+        std::vector<std::vector<size_t>> layers(numLayers);
+        for (size_t node = 0; node < numNodes; ++node)
+            layers[layer[node]].push_back(node);
+
+        // Barycenter ordering: sort each layer by the mean order of its neighbors in the previous layer
+        std::vector<double> order(numNodes, 0.0);
+        auto updateOrder = [&](const std::vector<size_t> &nodes)
+        {
+            for (size_t i = 0; i < nodes.size(); ++i)
+                order[nodes[i]] = (double)i;
+        };
+        for (auto &nodes : layers)
+            updateOrder(nodes);
+        std::vector<double> barycenter(numNodes, 0.0);
+        auto sortLayer = [&](std::vector<size_t> &nodes, const std::vector<std::vector<size_t>> &neighbors)
+        {
+            for (size_t node : nodes)
+            {
+                const std::vector<size_t> &adjacent = neighbors[node];
+                if (adjacent.empty())
+                {
+                    barycenter[node] = order[node];
+                    continue;
+                }
+                double sum = 0.0;
+                for (size_t other : adjacent)
+                    sum += order[other];
+                barycenter[node] = sum / adjacent.size();
+            }
+            std::stable_sort(nodes.begin(), nodes.end(), [&](size_t a, size_t b)
+                             { return barycenter[a] < barycenter[b]; });
+            updateOrder(nodes);
+        };
+        for (int sweep = 0; sweep < numSweeps; ++sweep)
+        {
+            for (size_t l = 1; l < numLayers; ++l)
+                sortLayer(layers[l], predecessors);
+            for (size_t l = numLayers - 1; l-- > 0;)
+                sortLayer(layers[l], forward);
+        }
+
+        // Coordinates: wrapped columns, each column centered vertically
+        double x = 0.0;
+        for (auto &nodes : layers)
+        {
+            for (size_t start = 0; start < nodes.size(); start += maxColumnSize)
+            {
+                const size_t count = std::min(maxColumnSize, nodes.size() - start);
+                const double offset = -0.5 * (count - 1) * spacingY;
+                for (size_t i = 0; i < count; ++i)
+                {
+                    positions[nodes[start + i]] = Position{x, offset + i * spacingY};
+                }
+                x += spacingX;
+            }
+        }
+        return positions;
+    }
+
+    std::vector<GraphLayout::Position> GraphLayout::forceDirected(const std::vector<Position> &initial,
+                                                                  const std::vector<Edge> &edges,
+                                                                  double spacing, int iterations,
+                                                                  size_t numThreads)
+    {
+        const size_t n = initial.size();
+        if (n < 2 || iterations <= 0)
+            return initial;
+
+        // Structure of arrays keeps the force loops contiguous
+        std::vector<double> x(n), y(n), fx(n), fy(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            // a small deterministic offset separates nodes which start at the same position
+            x[i] = initial[i].x + 1e-3 * (double)(i % 97);
+            y[i] = initial[i].y + 1e-3 * (double)(i % 89);
+        }
+
+        // Undirected adjacency in CSR format, so each worker only writes the forces of its own nodes
+        std::vector<size_t> offsets(n + 1, 0), neighbors;
+        for (const Edge &edge : edges)
+        {
+            if (edge.first < n && edge.second < n && edge.first != edge.second)
+            {
+                ++offsets[edge.first + 1];
+                ++offsets[edge.second + 1];
+            }
+        }
+        for (size_t i = 0; i < n; ++i)
+            offsets[i + 1] += offsets[i];
+        neighbors.resize(offsets[n]);
+        {
+            std::vector<size_t> fill(offsets.begin(), offsets.end() - 1);
+            for (const Edge &edge : edges)
+            {
+                if (edge.first < n && edge.second < n && edge.first != edge.second)
+                {
+                    neighbors[fill[edge.first]++] = edge.second;
+                    neighbors[fill[edge.second]++] = edge.first;
+                }
+            }
+        }
+
+        const double k2 = spacing * spacing;
+        const double theta2 = theta * theta;
+        // weak pull to the center keeps unconnected parts of the graph together
+        const double gravity = 0.05;
+        // the softening term avoids infinite forces between nearly coincident nodes
+        const double softening = 1e-2 * k2;
+        const double startTemperature = spacing * std::sqrt((double)n);
+        const size_t numBlocks = (n + forceBlockSize - 1) / forceBlockSize;
+        QuadTree tree;
+        for (int iteration = 0; iteration < iterations; ++iteration)
+        {
+            tree.build(x, y);
+            const double centerX = tree.cells[0].x, centerY = tree.cells[0].y;
+            parallelFor(numBlocks, [&](size_t block)
+                        {
+                std::vector<int32_t> stack;
+                stack.reserve(128);
+                const size_t end = std::min(n, (block + 1) * forceBlockSize);
+                for (size_t i = block * forceBlockSize; i < end; ++i)
+                {
+                    const double xi = x[i], yi = y[i];
+                    double forceX = 0.0, forceY = 0.0;
+                    // repulsion: f = k^2 / d along the connecting line
+                    stack.push_back(0);
+                    while (!stack.empty())
+                    {
+                        const QuadTree::Cell &cell = tree.cells[stack.back()];
+                        stack.pop_back();
+                        const double dx = xi - cell.x, dy = yi - cell.y;
+                        const double d2 = dx * dx + dy * dy + softening;
+                        const bool leaf = cell.child[0] < 0 && cell.child[1] < 0 && cell.child[2] < 0 && cell.child[3] < 0;
+                        if (!leaf && cell.size2 < theta2 * d2)
+                        {
+                            const double f = (cell.end - cell.begin) * k2 / d2;
+                            forceX += dx * f;
+                            forceY += dy * f;
+                        }
+                        else if (leaf)
+                        {
+                            // the node itself contributes nothing (dx = dy = 0)
+                            const double *sx = tree.sx.data(), *sy = tree.sy.data();
+                            double sumX = 0.0, sumY = 0.0;
+                            for (uint32_t j = cell.begin; j < cell.end; ++j)
+                            {
+                                const double ddx = xi - sx[j], ddy = yi - sy[j];
+                                const double f = k2 / (ddx * ddx + ddy * ddy + softening);
+                                sumX += ddx * f;
+                                sumY += ddy * f;
+                            }
+                            forceX += sumX;
+                            forceY += sumY;
+                        }
+                        else
+                        {
+                            for (int q = 0; q < 4; ++q)
+                            {
+                                if (cell.child[q] >= 0)
+                                    stack.push_back(cell.child[q]);
+                            }
+                        }
+                    }
+                    // attraction: f = d^2 / k along the edges
+                    for (size_t e = offsets[i]; e < offsets[i + 1]; ++e)
+                    {
+                        const size_t j = neighbors[e];
+                        const double dx = x[j] - xi, dy = y[j] - yi;
+                        const double f = std::sqrt(dx * dx + dy * dy) / spacing;
+                        forceX += dx * f;
+                        forceY += dy * f;
+                    }
+                    fx[i] = forceX - gravity * (xi - centerX);
+                    fy[i] = forceY - gravity * (yi - centerY);
+                } },
+                        numThreads);
+
+            // move the nodes at most by the temperature which cools down linearly
+            const double temperature = startTemperature * (1.0 - (double)iteration / iterations) + 0.05 * spacing;
+            for (size_t i = 0; i < n; ++i)
+            {
+                const double length = std::sqrt(fx[i] * fx[i] + fy[i] * fy[i]);
+                if (length > 0.0)
+                {
+                    const double step = std::min(length, temperature) / length;
+                    x[i] += fx[i] * step;
+                    y[i] += fy[i] * step;
+                }
+            }
+        }
+
+        // move the top left corner of the layout to the origin
+        const double minX = *std::min_element(x.begin(), x.end());
+        const double minY = *std::min_element(y.begin(), y.end());
+        std::vector<Position> positions(n);
+        for (size_t i = 0; i < n; ++i)
+            positions[i] = Position{x[i] - minX, y[i] - minY};
+        return positions;
+    }
+
+    std::vector<GraphLayout::Position> GraphLayout::place(const std::vector<Position> &placed,
+                                                          const std::vector<size_t> &anchors,
+                                                          double spacingX, double spacingY)
+    {
+        // occupied grid cells, a cell is packed into one key
+        auto cellKey = [](int64_t cx, int64_t cy)
+        { return ((uint64_t)(uint32_t)cx << 32) | (uint32_t)cy; };
+        auto cellX = [&](double x)
+        { return (int64_t)std::floor(x / spacingX + 0.5); };
+        auto cellY = [&](double y)
+        { return (int64_t)std::floor(y / spacingY + 0.5); };
+        std::unordered_set<uint64_t> occupied;
+        occupied.reserve(placed.size() + anchors.size());
+        int64_t maxCellX = -1, minCellY = 0;
+        for (size_t i = 0; i < placed.size(); ++i)
+        {
+            const int64_t cx = cellX(placed[i].x), cy = cellY(placed[i].y);
+            occupied.insert(cellKey(cx, cy));
+            if (i == 0 || cx > maxCellX)
+                maxCellX = cx;
+            if (i == 0 || cy < minCellY)
+                minCellY = cy;
+        }
+
+        std::vector<Position> positions(anchors.size());
+        int64_t freeCellY = minCellY;
+        for (size_t i = 0; i < anchors.size(); ++i)
+        {
+            int64_t cx, cy;
+            if (anchors[i] < placed.size())
+            {
+                // right of the anchor, alternating below and above it
+                cx = cellX(placed[anchors[i]].x) + 1;
+                const int64_t anchorY = cellY(placed[anchors[i]].y);
+                cy = anchorY;
+                for (int64_t step = 1; occupied.count(cellKey(cx, cy)); ++step)
+                    cy = anchorY + (step % 2 ? (step + 1) / 2 : -step / 2);
+            }
+            else
+            {
+                cx = maxCellX + 1;
+                while (occupied.count(cellKey(cx, freeCellY)))
+                    ++freeCellY;
+                cy = freeCellY;
+            }
+            occupied.insert(cellKey(cx, cy));
+            positions[i] = Position{cx * spacingX, cy * spacingY};
+        }
+        return positions;
+    }
+
+} // end of namespace xrock_gui_model
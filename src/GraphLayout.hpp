@@ -0,0 +1,47 @@
+/**
+ * \file GraphLayout.hpp
+ * \brief Automatic placement of the nodes of a graph
+ **/
+
+#pragma once
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace xrock_gui_model
+{
+
+    class GraphLayout
+    {
+    public:
+        struct Position
+        {
+            double x, y;
+        };
+        typedef std::pair<size_t, size_t> Edge;
+
+        // Layered (Sugiyama style) layout for data flow graphs: the nodes are assigned to columns by
+        // the longest path from the sources (cycles are broken at back edges), the order within a column
+        // is optimized with barycenter sweeps to reduce edge crossings. Columns with more than
+        // maxColumnSize nodes are wrapped into several columns. Runs in O((V + E) * sweeps).
+        static std::vector<Position> layered(size_t numNodes, const std::vector<Edge> &edges,
+                                             double spacingX = 300.0, double spacingY = 120.0,
+                                             size_t maxColumnSize = 40);
+
+        // Force directed (Fruchterman-Reingold) layout starting from the given positions, e.g. the result
+        // of layered(). The repulsive forces are approximated with a Barnes-Hut quadtree (O(V log V) per
+        // iteration) and computed in parallel on numThreads workers (0: one per core). spacing is the
+        // desired edge length.
+        static std::vector<Position> forceDirected(const std::vector<Position> &initial, const std::vector<Edge> &edges,
+                                                   double spacing = 250.0, int iterations = 150,
+                                                   size_t numThreads = 0);
+
+        // Places new nodes into an existing layout without moving the placed nodes. A new node with an
+        // anchor (index into placed, noAnchor otherwise) goes right of its anchor, the others into a column
+        // right of the layout. Occupied cells of a spacingX x spacingY grid are skipped. O(placed + new).
+        static constexpr size_t noAnchor = (size_t)-1;
+        static std::vector<Position> place(const std::vector<Position> &placed, const std::vector<size_t> &anchors,
+                                           double spacingX = 300.0, double spacingY = 120.0);
+    };
+
+} // end of namespace xrock_gui_model
@@ -4,29 +4,12 @@
 #include <QVBoxLayout>
 #include <QPushButton>
 #include <QDesktopServices>
-#include <array>
 #include "utils/WaitCursorRAII.hpp"
 
 using namespace configmaps;
 namespace xrock_gui_model
 {
 
-    std::string getHtml(const std::string &markdown)
-    {
-        std::string cmd = "echo \"" + markdown + "\" | python -m markdown";
-        std::array<char, 128> buffer;
-        std::string result;
-        std::shared_ptr<FILE> pipe(popen(cmd.c_str(), "r"), pclose);
-        if (!pipe)
-            throw std::runtime_error("popen() failed!");
-        while (!feof(pipe.get()))
-        {
-            if (fgets(buffer.data(), 128, pipe.get()) != nullptr)
-                result += buffer.data();
-        }
-        return result;
-    }
-
     std::string ImportDialog::lastDomain = "SOFTWARE";
     std::string ImportDialog::lastFilter = "";
 
@@ -213,7 +196,8 @@ namespace xrock_gui_model
                         if (dataMap["description"].hasKey("markdown"))
                         {
                             std::string md = dataMap["description"]["markdown"];
-                            doc->setHtml(getHtml(md).c_str());
+                            std::string key = selectedDomain + "/" + selectedModel + "/" + selectedVersion;
+                            doc->setHtml(QString::fromStdString(xrockGui->getDescriptionHtml(key, md)));
                         }
                     }
                 }
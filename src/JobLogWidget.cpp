@@ -0,0 +1,128 @@
+/**
+ * \file JobLogWidget.cpp
+ * \brief Dock widget showing the running external tools and their output
+ **/
+
+#include "JobLogWidget.hpp"
+#include "JobRunner.hpp"
+
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <vector>
+
+namespace xrock_gui_model
+{
+
+    // Number of lines kept in the log
+    static const int maxLogLines = 5000;
+
+    JobLogWidget::JobLogWidget(mars::cfg_manager::CFGManagerInterface *cfg, JobRunner *runner,
+                               QWidget *parent) : mars::main_gui::BaseWidget(parent, cfg, "JobLogWidget"),
+                                                  runner(runner)
+    {
+        setWindowTitle("Jobs");
+        QVBoxLayout *vLayout = new QVBoxLayout();
+        vLayout->addWidget(new QLabel("Running jobs:"));
+        jobList = new QListWidget();
+        jobList->setMaximumHeight(100);
+        vLayout->addWidget(jobList);
+        QHBoxLayout *hLayout = new QHBoxLayout();
+        QPushButton *b = new QPushButton("Cancel");
+        connect(b, SIGNAL(clicked()), this, SLOT(cancelSelected()));
+        hLayout->addWidget(b);
+        b = new QPushButton("Cancel All");
+        connect(b, SIGNAL(clicked()), this, SLOT(cancelAll()));
+        hLayout->addWidget(b);
+        hLayout->addStretch();
+        vLayout->addLayout(hLayout);
+        log = new QPlainTextEdit();
+        log->setReadOnly(true);
+        log->setMaximumBlockCount(maxLogLines);
+        vLayout->addWidget(log);
+        setLayout(vLayout);
+
+        connect(runner, SIGNAL(jobQueued(unsigned long, QString)), this, SLOT(jobQueued(unsigned long, QString)));
+        connect(runner, SIGNAL(jobStarted(unsigned long, QString)), this, SLOT(jobStarted(unsigned long, QString)));
+        connect(runner, SIGNAL(jobOutput(unsigned long, QString, bool)), this, SLOT(jobOutput(unsigned long, QString, bool)));
+        connect(runner, SIGNAL(jobFinished(unsigned long, QString, int, bool)), this, SLOT(jobFinished(unsigned long, QString, int, bool)));
+    }
+
+    JobLogWidget::~JobLogWidget()
+    {
+    }
+
+    void JobLogWidget::setJobState(unsigned long id, const QString &name, const QString &state)
+    {
+        QListWidgetItem *item;
+        auto it = items.find(id);
+        if (it == items.end())
+        {
+            item = new QListWidgetItem(jobList);
+            item->setData(Qt::UserRole, QVariant::fromValue((qulonglong)id));
+            items[id] = item;
+        }
+        else
+        {
+            item = it->second;
+        }
+        item->setText(name + " (" + state + ")");
+    }
+
+    void JobLogWidget::appendLog(const QString &text)
+    {
+        log->appendPlainText(text);
+    }
+
+    void JobLogWidget::jobQueued(unsigned long id, QString name)
+    {
+        setJobState(id, name, "queued");
+    }
+
+    void JobLogWidget::jobStarted(unsigned long id, QString name)
+    {
+        setJobState(id, name, "running");
+        appendLog("[" + name + "] started");
+    }
+
+    void JobLogWidget::jobOutput(unsigned long id, QString text, bool isError)
+    {
+        QString name = QString::fromStdString(runner->getJobName(id));
+        appendLog("[" + name + "]" + (isError ? "! " : " ") + text);
+    }
+
+    void JobLogWidget::jobFinished(unsigned long id, QString name, int exitCode, bool success)
+    {
+        auto it = items.find(id);
+        if (it != items.end())
+        {
+            delete it->second;
+            items.erase(it);
+        }
+        if (success)
+            appendLog("[" + name + "] finished");
+        else
+            appendLog("[" + name + "] failed (exit code " + QString::number(exitCode) + ")");
+    }
+
+    void JobLogWidget::cancelSelected()
+    {
+        // canceling removes the items of queued jobs immediately
+        std::vector<unsigned long> ids;
+        for (QListWidgetItem *item : jobList->selectedItems())
+        {
+            ids.push_back(item->data(Qt::UserRole).toULongLong());
+        }
+        for (unsigned long id : ids)
+        {
+            runner->cancel(id);
+        }
+    }
+
+    void JobLogWidget::cancelAll()
+    {
+        runner->cancelAll();
+    }
+
+} // end of namespace xrock_gui_model
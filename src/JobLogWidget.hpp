@@ -0,0 +1,43 @@
+/**
+ * \file JobLogWidget.hpp
+ * \brief Dock widget showing the running external tools and their output
+ **/
+
+#pragma once
+#include <mars/main_gui/BaseWidget.h>
+#include <QListWidget>
+#include <QPlainTextEdit>
+#include <QString>
+#include <map>
+
+namespace xrock_gui_model
+{
+    class JobRunner;
+
+    class JobLogWidget : public mars::main_gui::BaseWidget
+    {
+        Q_OBJECT
+
+    public:
+        JobLogWidget(mars::cfg_manager::CFGManagerInterface *cfg, JobRunner *runner, QWidget *parent = 0);
+        ~JobLogWidget();
+
+    public slots:
+        void jobQueued(unsigned long id, QString name);
+        void jobStarted(unsigned long id, QString name);
+        void jobOutput(unsigned long id, QString text, bool isError);
+        void jobFinished(unsigned long id, QString name, int exitCode, bool success);
+        void cancelSelected();
+        void cancelAll();
+
+    private:
+        JobRunner *runner;
+        QListWidget *jobList;
+        QPlainTextEdit *log;
+        std::map<unsigned long, QListWidgetItem *> items;
+
+        void setJobState(unsigned long id, const QString &name, const QString &state);
+        void appendLog(const QString &text);
+    };
+
+} // end of namespace xrock_gui_model
@@ -0,0 +1,287 @@
+/**
+ * \file JobRunner.cpp
+ * \brief Runs external tools asynchronously and reports their output and exit status
+ **/
+
+#include "JobRunner.hpp"
+#include "Logger.hpp"
+
+#include <QStringList>
+#include <algorithm>
+#include <string>
+
+namespace xrock_gui_model
+{
+
+    static std::string toString(const QByteArray &data)
+    {
+        return std::string(data.constData(), data.size());
+    }
+
+    JobRunner::JobRunner(size_t maxRunning, QObject *parent)
+        : QObject(parent), nextId(1), maxRunning(std::max<size_t>(1, maxRunning)), running(0)
+    {
+    }
+
+    JobRunner::~JobRunner()
+    {
+        for (auto &it : jobs)
+        {
+            QProcess *process = it.second.process;
+            if (process)
+            {
+                process->disconnect(this);
+                process->kill();
+                process->waitForFinished(1000);
+            }
+        }
+    }
+
+    JobRunner::JobId JobRunner::run(const Command &command, Callback done)
+    {
+        const JobId id = nextId++;
+        Job &job = jobs[id];
+        job.command = command;
+        job.done = done;
+        if (command.limited && running >= maxRunning)
+        {
+            queue.push_back(id);
+            emit jobQueued(id, QString::fromStdString(command.name));
+        }
+        else
+        {
+            start(id, job);
+        }
+        return id;
+    }
+
+    void JobRunner::start(JobId id, Job &job)
+    {
+        const Command &command = job.command;
+        if (!command.limited)
+        {
+            startDetached(id, job);
+            return;
+        }
+        QStringList args;
+        for (const auto &arg : command.args)
+            args << QString::fromStdString(arg);
+
+        QProcess *process = new QProcess(this);
+        job.process = process;
+        if (!command.environment.empty())
+        {
+            QProcessEnvironment environment = QProcessEnvironment::systemEnvironment();
+            for (const auto &it : command.environment)
+                environment.insert(QString::fromStdString(it.first), QString::fromStdString(it.second));
+            process->setProcessEnvironment(environment);
+        }
+        connect(process, SIGNAL(readyReadStandardOutput()), this, SLOT(readOutput()));
+        connect(process, SIGNAL(readyReadStandardError()), this, SLOT(readErrors()));
+        connect(process, SIGNAL(finished(int, QProcess::ExitStatus)), this, SLOT(processFinished(int, QProcess::ExitStatus)));
+        connect(process, SIGNAL(error(QProcess::ProcessError)), this, SLOT(processError(QProcess::ProcessError)));
+        ++running;
+        XROCK_LOG(Info, "execute: " << command.program << " " << args.join(" ").toStdString());
+        emit jobStarted(id, QString::fromStdString(command.name));
+        process->start(QString::fromStdString(command.program), args);
+        if (!command.input.empty())
+            process->write(QByteArray(command.input.c_str(), (int)command.input.size()));
+        process->closeWriteChannel();
+    }
+
+    // Detached programs are not children of the GUI process, so closing the GUI does not kill them.
+    // The environment is passed via env(1) because the static QProcess::startDetached() has no parameter for it.
+    void JobRunner::startDetached(JobId id, Job &job)
+    {
+        const Command &command = job.command;
+        QString program = QString::fromStdString(command.program);
+        QStringList args;
+        if (!command.environment.empty())
+        {
+            for (const auto &it : command.environment)
+                args << QString::fromStdString(it.first + "=" + it.second);
+            args << program;
+            program = "env";
+        }
+        for (const auto &arg : command.args)
+            args << QString::fromStdString(arg);
+        if (!command.input.empty())
+            XROCK_LOG(Warning, command.name << ": input is ignored for detached jobs");
+        XROCK_LOG(Info, "execute detached: " << program.toStdString() << " " << args.join(" ").toStdString());
+        emit jobStarted(id, QString::fromStdString(command.name));
+        qint64 pid = 0;
+        if (!QProcess::startDetached(program, args, QString(), &pid))
+        {
+            job.result.error += "cannot start " + command.program + "\n";
+            emit jobOutput(id, QString::fromStdString("cannot start " + command.program), true);
+            complete(id, false);
+            return;
+        }
+        emit jobOutput(id, QString::fromStdString("started with pid " + std::to_string(pid)), false);
+        job.result.exitCode = 0;
+        complete(id, true);
+    }
+
+    void JobRunner::startQueued()
+    {
+        while (!queue.empty() && running < maxRunning)
+        {
+            const JobId id = queue.front();
+            queue.pop_front();
+            auto it = jobs.find(id);
+            if (it != jobs.end())
+                start(id, it->second);
+        }
+    }
+
+    bool JobRunner::cancel(JobId id)
+    {
+        auto it = jobs.find(id);
+        if (it == jobs.end())
+            return false;
+        it->second.result.canceled = true;
+        if (it->second.process)
+        {
+            // processFinished() completes the job
+            it->second.process->kill();
+            return true;
+        }
+        for (auto q = queue.begin(); q != queue.end(); ++q)
+        {
+            if (*q == id)
+            {
+                queue.erase(q);
+                break;
+            }
+        }
+        complete(id, false);
+        return true;
+    }
+
+    void JobRunner::cancelAll()
+    {
+        std::vector<JobId> ids;
+        for (auto &it : jobs)
+            ids.push_back(it.first);
+        for (JobId id : ids)
+            cancel(id);
+    }
+
+    void JobRunner::setMaxRunning(size_t maxRunning_)
+    {
+        maxRunning = std::max<size_t>(1, maxRunning_);
+        startQueued();
+    }
+
+    std::string JobRunner::getJobName(JobId id) const
+    {
+        auto it = jobs.find(id);
+        return it == jobs.end() ? std::string() : it->second.command.name;
+    }
+
+    std::map<JobRunner::JobId, JobRunner::Job>::iterator JobRunner::findJob(QObject *process)
+    {
+        for (auto it = jobs.begin(); it != jobs.end(); ++it)
+        {
+            if (it->second.process == process)
+                return it;
+        }
+        return jobs.end();
+    }
+
+    // Emits the complete lines of data, the rest is kept in pending until the next data or flush
+    void JobRunner::emitLines(JobId id, std::string &pending, const std::string &data, bool isError, bool flush)
+    {
+        pending += data;
+        size_t start = 0, end;
+        while ((end = pending.find('\n', start)) != std::string::npos)
+        {
+            emit jobOutput(id, QString::fromStdString(pending.substr(start, end - start)), isError);
+            start = end + 1;
+        }
+        pending.erase(0, start);
+        if (flush && !pending.empty())
+        {
+            emit jobOutput(id, QString::fromStdString(pending), isError);
+            pending.clear();
+        }
+    }
+
+    void JobRunner::readOutput()
+    {
+        auto it = findJob(sender());
+        if (it == jobs.end())
+            return;
+        Job &job = it->second;
+        const std::string data = toString(job.process->readAllStandardOutput());
+        job.result.output += data;
+        if (job.command.logOutput)
+            emitLines(it->first, job.pendingOutput, data, false, false);
+    }
+
+    void JobRunner::readErrors()
+    {
+        auto it = findJob(sender());
+        if (it == jobs.end())
+            return;
+        Job &job = it->second;
+        const std::string data = toString(job.process->readAllStandardError());
+        job.result.error += data;
+        emitLines(it->first, job.pendingError, data, true, false);
+    }
+
+    void JobRunner::processFinished(int exitCode, QProcess::ExitStatus exitStatus)
+    {
+        auto it = findJob(sender());
+        if (it == jobs.end())
+            return;
+        Job &job = it->second;
+        // read what is left in the pipes
+        const std::string output = toString(job.process->readAllStandardOutput());
+        const std::string error = toString(job.process->readAllStandardError());
+        job.result.output += output;
+        job.result.error += error;
+        if (job.command.logOutput)
+            emitLines(it->first, job.pendingOutput, output, false, true);
+        emitLines(it->first, job.pendingError, error, true, true);
+        job.result.exitCode = exitCode;
+        complete(it->first, exitStatus == QProcess::NormalExit && exitCode == 0 && !job.result.canceled);
+    }
+
+    void JobRunner::processError(QProcess::ProcessError error)
+    {
+        // crashes are reported by finished()
+        if (error != QProcess::FailedToStart)
+            return;
+        auto it = findJob(sender());
+        if (it == jobs.end())
+            return;
+        it->second.result.error += "cannot start " + it->second.command.program + "\n";
+        emit jobOutput(it->first, QString::fromStdString("cannot start " + it->second.command.program), true);
+        complete(it->first, false);
+    }
+
+    void JobRunner::complete(JobId id, bool success)
+    {
+        auto it = jobs.find(id);
+        if (it == jobs.end())
+            return;
+        Job job = std::move(it->second);
+        jobs.erase(it);
+        if (job.process)
+        {
+            job.process->disconnect(this);
+            job.process->deleteLater();
+            --running;
+        }
+        job.result.success = success;
+        if (!success && !job.result.canceled)
+            XROCK_LOG(Warning, job.command.name << " failed with exit code " << job.result.exitCode);
+        emit jobFinished(id, QString::fromStdString(job.command.name), job.result.exitCode, success);
+        // the callback may run new jobs
+        if (job.done)
+            job.done(job.result);
+        startQueued();
+    }
+
+} // end of namespace xrock_gui_model
@@ -0,0 +1,108 @@
+/**
+ * \file JobRunner.hpp
+ * \brief Runs external tools asynchronously and reports their output and exit status
+ **/
+
+#pragma once
+#include <QObject>
+#include <QProcess>
+#include <QString>
+#include <deque>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace xrock_gui_model
+{
+
+    // Runs external programs with QProcess instead of blocking the event loop with std::system()/popen().
+    // The programs are started without a shell. Their stdout/stderr is collected and reported line by line
+    // via jobOutput(). At most maxRunning limited jobs run at the same time, further ones are queued.
+    class JobRunner : public QObject
+    {
+        Q_OBJECT
+
+    public:
+        typedef unsigned long JobId;
+
+        struct Command
+        {
+            // Name shown in the log
+            std::string name;
+            std::string program;
+            std::vector<std::string> args;
+            // Written to stdin of the program, which is closed afterwards
+            std::string input;
+            // Additional environment variables
+            std::map<std::string, std::string> environment;
+            // Unlimited jobs (e.g. interactive tools) are started immediately and detached: they do not count
+            // against the limit and keep running when the GUI exits. Their output is not collected and they
+            // are finished as soon as they are started.
+            bool limited = true;
+            // If false, stdout is only collected for the callback and not shown in the log
+            bool logOutput = true;
+        };
+
+        struct Result
+        {
+            bool success = false;
+            bool canceled = false;
+            int exitCode = -1;
+            std::string output;
+            std::string error;
+        };
+        // Called in the GUI thread once the job is finished, failed to start or was canceled
+        typedef std::function<void(const Result &result)> Callback;
+
+        explicit JobRunner(size_t maxRunning = 2, QObject *parent = nullptr);
+        // Kills the running limited jobs without calling their callbacks
+        ~JobRunner();
+
+        JobId run(const Command &command, Callback done = Callback());
+        // Stops a running or queued job. The callback is called with canceled set.
+        bool cancel(JobId id);
+        void cancelAll();
+        void setMaxRunning(size_t maxRunning);
+        size_t getMaxRunning() const { return maxRunning; }
+        size_t numRunning() const { return running; }
+        size_t numQueued() const { return queue.size(); }
+        std::string getJobName(JobId id) const;
+
+    signals:
+        void jobQueued(unsigned long id, QString name);
+        void jobStarted(unsigned long id, QString name);
+        void jobOutput(unsigned long id, QString text, bool isError);
+        void jobFinished(unsigned long id, QString name, int exitCode, bool success);
+
+    private slots:
+        void readOutput();
+        void readErrors();
+        void processFinished(int exitCode, QProcess::ExitStatus exitStatus);
+        void processError(QProcess::ProcessError error);
+
+    private:
+        struct Job
+        {
+            Command command;
+            Callback done;
+            QProcess *process = nullptr;
+            Result result;
+            // incomplete last lines of stdout/stderr
+            std::string pendingOutput, pendingError;
+        };
+        std::map<JobId, Job> jobs;
+        std::deque<JobId> queue;
+        JobId nextId;
+        size_t maxRunning;
+        size_t running;
+
+        void start(JobId id, Job &job);
+        void startDetached(JobId id, Job &job);
+        void startQueued();
+        void complete(JobId id, bool success);
+        void emitLines(JobId id, std::string &pending, const std::string &data, bool isError, bool flush);
+        std::map<JobId, Job>::iterator findJob(QObject *process);
+    };
+
+} // end of namespace xrock_gui_model
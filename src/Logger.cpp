@@ -0,0 +1,136 @@
+/**
+ * \file Logger.cpp
+ * \brief Leveled logging with a ring buffer which is written to stderr by a background thread
+ **/
+
+#include "Logger.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+
+namespace xrock_gui_model
+{
+
+    // Number of messages buffered until the writer catches up
+    static const size_t ringSize = 4096;
+
+    static const char *levelName(LogLevel level)
+    {
+        switch (level)
+        {
+        case LogLevel::Debug:
+            return "debug";
+        case LogLevel::Info:
+            return "info";
+        case LogLevel::Warning:
+            return "warning";
+        case LogLevel::Error:
+            return "error";
+        default:
+            return "none";
+        }
+    }
+
+    Logger &Logger::instance()
+    {
+        static Logger logger;
+        return logger;
+    }
+
+    Logger::Logger() : level(LogLevel::Info), ring(ringSize), head(0), count(0), dropped(0), writing(false), stop(false)
+    {
+        // The level can be set from the environment, it takes precedence over the log_level configuration
+        const char *env = getenv("XROCK_LOG_LEVEL");
+        if (env)
+        {
+            setLevel(std::string(env));
+        }
+        writer = std::thread(&Logger::run, this);
+    }
+
+    Logger::~Logger()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        wakeup.notify_one();
+        writer.join();
+    }
+
+    bool Logger::setLevel(const std::string &name)
+    {
+        for (LogLevel l : {LogLevel::Debug, LogLevel::Info, LogLevel::Warning, LogLevel::Error, LogLevel::None})
+        {
+            if (name == levelName(l))
+            {
+                level = l;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void Logger::log(LogLevel level, std::string message)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (count == ring.size())
+            {
+                // drop the oldest message
+                head = (head + 1) % ring.size();
+                --count;
+                ++dropped;
+            }
+            Entry &entry = ring[(head + count) % ring.size()];
+            entry.level = level;
+            entry.message = std::move(message);
+            ++count;
+        }
+        wakeup.notify_one();
+    }
+
+    void Logger::flush()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        written.wait(lock, [this]()
+                     { return (count == 0 && !writing) || stop; });
+    }
+
+    void Logger::run()
+    {
+        std::vector<Entry> batch;
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true)
+        {
+            wakeup.wait(lock, [this]()
+                        { return count > 0 || stop; });
+            if (count == 0 && stop)
+                break;
+            // take all pending messages and write them without holding the lock
+            batch.clear();
+            for (; count > 0; --count)
+            {
+                batch.push_back(std::move(ring[head]));
+                head = (head + 1) % ring.size();
+            }
+            size_t numDropped = dropped;
+            dropped = 0;
+            writing = true;
+            lock.unlock();
+            if (numDropped)
+            {
+                fprintf(stderr, "[warning] %zu log messages dropped\n", numDropped);
+            }
+            for (auto &entry : batch)
+            {
+                fprintf(stderr, "[%s] %s\n", levelName(entry.level), entry.message.c_str());
+            }
+            fflush(stderr);
+            lock.lock();
+            writing = false;
+            written.notify_all();
+        }
+    }
+
+} // end of namespace xrock_gui_model
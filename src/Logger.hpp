@@ -0,0 +1,81 @@
+/**
+ * \file Logger.hpp
+ * \brief Leveled logging with a ring buffer which is written to stderr by a background thread
+ **/
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace xrock_gui_model
+{
+
+    // The names are not upper case since DEBUG and ERROR are often defined as macros
+    enum class LogLevel
+    {
+        Debug = 0,
+        Info,
+        Warning,
+        Error,
+        None
+    };
+
+    class Logger
+    {
+    public:
+        static Logger &instance();
+
+        void setLevel(LogLevel level) { this->level = level; }
+        // Accepts "debug", "info", "warning", "error" or "none"
+        bool setLevel(const std::string &level);
+        LogLevel getLevel() const { return level; }
+        bool isEnabled(LogLevel level) const { return level >= this->level && level != LogLevel::None; }
+
+        // Queues the message for the background writer. If the buffer is full the oldest messages are dropped.
+        void log(LogLevel level, std::string message);
+        // Blocks until all queued messages are written
+        void flush();
+
+    private:
+        Logger();
+        ~Logger();
+        Logger(const Logger &) = delete;
+        Logger &operator=(const Logger &) = delete;
+
+        void run();
+
+        struct Entry
+        {
+            LogLevel level;
+            std::string message;
+        };
+        std::atomic<LogLevel> level;
+        std::vector<Entry> ring;
+        size_t head, count, dropped;
+        bool writing, stop;
+        std::mutex mutex;
+        std::condition_variable wakeup, written;
+        std::thread writer;
+    };
+
+} // end of namespace xrock_gui_model
+
+// The message is only formatted if the level is enabled, e.g.
+// XROCK_LOG(Info, "loaded " << n << " nodes");
+// The message is variadic so that it may contain template arguments with commas.
+#define XROCK_LOG(level, ...)                                                                     \
+    do                                                                                            \
+    {                                                                                             \
+        if (xrock_gui_model::Logger::instance().isEnabled(xrock_gui_model::LogLevel::level))      \
+        {                                                                                         \
+            std::ostringstream xrockLogStream_;                                                   \
+            xrockLogStream_ << __VA_ARGS__;                                                       \
+            xrock_gui_model::Logger::instance().log(xrock_gui_model::LogLevel::level,             \
+                                                    xrockLogStream_.str());                       \
+        }                                                                                         \
+    } while (0)
@@ -0,0 +1,580 @@
+/**
+ * \file MarkdownRenderer.cpp
+ * \brief Converts the markdown descriptions of the component models to html
+ **/
+
+#include "MarkdownRenderer.hpp"
+
+#include <cctype>
+
+namespace xrock_gui_model
+{
+
+    namespace
+    {
+        size_t indentOf(const std::string &line)
+        {
+            size_t i = 0;
+            while (i < line.size() && line[i] == ' ')
+                ++i;
+            return i;
+        }
+
+        bool isBlank(const std::string &line)
+        {
+            return line.find_first_not_of(" \t") == std::string::npos;
+        }
+
+        std::string trim(const std::string &text)
+        {
+            size_t begin = text.find_first_not_of(" \t");
+            if (begin == std::string::npos)
+                return std::string();
+            size_t end = text.find_last_not_of(" \t");
+            return text.substr(begin, end - begin + 1);
+        }
+
+        // Removes up to count leading spaces
+        std::string unindent(const std::string &line, size_t count)
+        {
+            return line.substr(std::min(count, indentOf(line)));
+        }
+
+        bool isFence(const std::string &line)
+        {
+            std::string t = trim(line);
+            return indentOf(line) < 4 && (t.compare(0, 3, "```") == 0 || t.compare(0, 3, "~~~") == 0);
+        }
+
+        // Returns the level of an atx heading (# ...) or 0
+        int headingLevel(const std::string &line)
+        {
+            if (indentOf(line) >= 4)
+                return 0;
+            std::string t = trim(line);
+            int level = 0;
+            while (level < (int)t.size() && t[level] == '#')
+                ++level;
+            if (level == 0 || level > 6 || (level < (int)t.size() && t[level] != ' '))
+                return 0;
+            return level;
+        }
+
+        bool isRule(const std::string &line)
+        {
+            if (indentOf(line) >= 4)
+                return false;
+            char marker = 0;
+            int count = 0;
+            for (char c : line)
+            {
+                if (c == ' ' || c == '\t')
+                    continue;
+                if (c != '*' && c != '-' && c != '_')
+                    return false;
+                if (marker && c != marker)
+                    return false;
+                marker = c;
+                ++count;
+            }
+            return count >= 3;
+        }
+
+        bool isQuote(const std::string &line)
+        {
+            size_t indent = indentOf(line);
+            return indent < 4 && indent < line.size() && line[indent] == '>';
+        }
+
+        // Returns the length of the list marker including the following space(s) or 0
+        size_t listMarker(const std::string &line, bool *ordered = nullptr)
+        {
+            size_t i = indentOf(line);
+            size_t start = i;
+            if (i < line.size() && (line[i] == '*' || line[i] == '+' || line[i] == '-'))
+            {
+                if (ordered)
+                    *ordered = false;
+                ++i;
+            }
+            else
+            {
+                while (i < line.size() && isdigit((unsigned char)line[i]))
+                    ++i;
+                if (i == start || i >= line.size() || line[i] != '.')
+                    return 0;
+                if (ordered)
+                    *ordered = true;
+                ++i;
+            }
+            if (i >= line.size() || (line[i] != ' ' && line[i] != '\t'))
+                return 0;
+            while (i < line.size() && line[i] == ' ')
+                ++i;
+            return i;
+        }
+
+        bool isHtmlBlock(const std::string &line)
+        {
+            return indentOf(line) == 0 && line.size() > 1 && line[0] == '<' &&
+                   (isalpha((unsigned char)line[1]) || line[1] == '/' || line[1] == '!');
+        }
+
+        // Returns true if the line ends a paragraph without a blank line. Like python-markdown, a list only
+        // interrupts a paragraph inside of a list item (nested list), otherwise it needs a blank line.
+        bool startsBlock(const std::string &line, bool lists = true)
+        {
+            return isFence(line) || headingLevel(line) || isRule(line) || isQuote(line) ||
+                   (lists && indentOf(line) < 4 && listMarker(line));
+        }
+
+        std::string escapeAttribute(const std::string &text)
+        {
+            std::string result;
+            for (char c : text)
+            {
+                if (c == '"')
+                    result += "&quot;";
+                else
+                    result += MarkdownRenderer::escapeHtml(std::string(1, c));
+            }
+            return result;
+        }
+
+        // Parses "(url "title")" at pos, returns the position after ')' or npos
+        size_t parseLinkTarget(const std::string &text, size_t pos, std::string &url, std::string &title)
+        {
+            if (pos >= text.size() || text[pos] != '(')
+                return std::string::npos;
+            int depth = 0;
+            size_t end = pos;
+            for (; end < text.size(); ++end)
+            {
+                if (text[end] == '(')
+                    ++depth;
+                else if (text[end] == ')' && --depth == 0)
+                    break;
+            }
+            if (end >= text.size())
+                return std::string::npos;
+            std::string inner = trim(text.substr(pos + 1, end - pos - 1));
+            size_t space = inner.find_first_of(" \t");
+            url = inner.substr(0, space);
+            title.clear();
+            if (space != std::string::npos)
+            {
+                std::string rest = trim(inner.substr(space));
+                if (rest.size() >= 2 && (rest[0] == '"' || rest[0] == '\'') && rest.back() == rest[0])
+                    title = rest.substr(1, rest.size() - 2);
+            }
+            if (url.size() >= 2 && url[0] == '<' && url.back() == '>')
+                url = url.substr(1, url.size() - 2);
+            return end + 1;
+        }
+
+        // Returns the position of the ']' matching the '[' at pos or npos
+        size_t matchBracket(const std::string &text, size_t pos)
+        {
+            int depth = 0;
+            for (size_t i = pos; i < text.size(); ++i)
+            {
+                if (text[i] == '\\')
+                    ++i;
+                else if (text[i] == '[')
+                    ++depth;
+                else if (text[i] == ']' && --depth == 0)
+                    return i;
+            }
+            return std::string::npos;
+        }
+    }
+
+    std::string MarkdownRenderer::escapeHtml(const std::string &text)
+    {
+        std::string result;
+        result.reserve(text.size());
+        for (char c : text)
+        {
+            switch (c)
+            {
+            case '&':
+                result += "&amp;";
+                break;
+            case '<':
+                result += "&lt;";
+                break;
+            case '>':
+                result += "&gt;";
+                break;
+            default:
+                result += c;
+            }
+        }
+        return result;
+    }
+
+    std::string MarkdownRenderer::toHtml(const std::string &markdown)
+    {
+        std::vector<std::string> lines;
+        std::string line;
+        for (size_t i = 0; i <= markdown.size(); ++i)
+        {
+            if (i == markdown.size() || markdown[i] == '\n')
+            {
+                lines.push_back(line);
+                line.clear();
+            }
+            else if (markdown[i] == '\t')
+            {
+                line.append(4 - line.size() % 4, ' ');
+            }
+            else if (markdown[i] != '\r')
+            {
+                line += markdown[i];
+            }
+        }
+        std::string html;
+        renderBlocks(lines, html);
+        return html;
+    }
+
+    void MarkdownRenderer::renderBlocks(const std::vector<std::string> &lines, std::string &html, bool tight, bool listItem)
+    {
+        size_t i = 0;
+        while (i < lines.size())
+        {
+            const std::string &line = lines[i];
+            if (isBlank(line))
+            {
+                ++i;
+                continue;
+            }
+            if (isFence(line))
+            {
+                std::string fence = trim(line).substr(0, 3);
+                std::string language = trim(trim(line).substr(3));
+                std::string code;
+                for (++i; i < lines.size() && trim(lines[i]).compare(0, 3, fence) != 0; ++i)
+                    code += escapeHtml(lines[i]) + "\n";
+                ++i;
+                html += language.empty() ? "<pre><code>" : "<pre><code class=\"language-" + escapeAttribute(language) + "\">";
+                html += code + "</code></pre>\n";
+                continue;
+            }
+            if (indentOf(line) >= 4)
+            {
+                std::vector<std::string> code;
+                while (i < lines.size() && (isBlank(lines[i]) || indentOf(lines[i]) >= 4))
+                    code.push_back(unindent(lines[i++], 4));
+                while (!code.empty() && isBlank(code.back()))
+                    code.pop_back();
+                html += "<pre><code>";
+                for (const auto &c : code)
+                    html += escapeHtml(c) + "\n";
+                html += "</code></pre>\n";
+                continue;
+            }
+            if (int level = headingLevel(line))
+            {
+                std::string text = trim(trim(line).substr(level));
+                size_t end = text.find_last_not_of('#');
+                if (end != std::string::npos && end + 1 < text.size() && (text[end] == ' ' || text[end] == '\t'))
+                    text = trim(text.substr(0, end + 1));
+                else if (end == std::string::npos)
+                    text.clear();
+                html += "<h" + std::to_string(level) + ">" + renderInline(text) + "</h" + std::to_string(level) + ">\n";
+                ++i;
+                continue;
+            }
+            if (isRule(line))
+            {
+                html += "<hr />\n";
+                ++i;
+                continue;
+            }
+            if (isQuote(line))
+            {
+                std::vector<std::string> quoted;
+                while (i < lines.size() && !isBlank(lines[i]))
+                {
+                    std::string q = lines[i++];
+                    if (isQuote(q))
+                    {
+                        q = q.substr(indentOf(q) + 1);
+                        if (!q.empty() && q[0] == ' ')
+                            q.erase(0, 1);
+                    }
+                    quoted.push_back(q);
+                    // a blank line continues the quote if the next line is quoted again
+                    if (i + 1 < lines.size() && isBlank(lines[i]) && isQuote(lines[i + 1]))
+                        quoted.push_back(lines[i++]);
+                }
+                html += "<blockquote>\n";
+                renderBlocks(quoted, html);
+                html += "</blockquote>\n";
+                continue;
+            }
+            if (listMarker(line))
+            {
+                i = renderList(lines, i, html);
+                continue;
+            }
+            if (isHtmlBlock(line))
+            {
+                while (i < lines.size() && !isBlank(lines[i]))
+                    html += lines[i++] + "\n";
+                continue;
+            }
+
+            // paragraph, possibly a setext heading
+            std::string text;
+            int setext = 0;
+            while (i < lines.size() && !isBlank(lines[i]))
+            {
+                if (!text.empty() && startsBlock(lines[i], listItem))
+                {
+                    // an underline of = or - turns the paragraph into a heading
+                    std::string t = trim(lines[i]);
+                    if (t.find_first_not_of('-') == std::string::npos)
+                        setext = 2;
+                    else
+                        break;
+                    ++i;
+                    break;
+                }
+                std::string t = trim(lines[i]);
+                if (!text.empty() && t.find_first_not_of('=') == std::string::npos)
+                {
+                    setext = 1;
+                    ++i;
+                    break;
+                }
+                if (!text.empty())
+                    text += "\n";
+                // two trailing spaces are a line break
+                if (lines[i].size() >= 2 && lines[i].compare(lines[i].size() - 2, 2, "  ") == 0)
+                    text += t + "\x01";
+                else
+                    text += t;
+                ++i;
+            }
+            std::string content = renderInline(text);
+            for (size_t pos = 0; (pos = content.find('\x01', pos)) != std::string::npos;)
+                content.replace(pos, 1, "<br />");
+            if (setext)
+                html += "<h" + std::to_string(setext) + ">" + content + "</h" + std::to_string(setext) + ">\n";
+            else if (tight)
+                html += content + "\n";
+            else
+                html += "<p>" + content + "</p>\n";
+        }
+    }
+
+    // Renders the list starting at lines[start] and returns the index of the first line after it
+    size_t MarkdownRenderer::renderList(const std::vector<std::string> &lines, size_t start, std::string &html)
+    {
+        bool ordered = false;
+        listMarker(lines[start], &ordered);
+        const size_t baseIndent = indentOf(lines[start]);
+        std::vector<std::vector<std::string>> items;
+        bool loose = false;
+        size_t i = start;
+        while (i < lines.size())
+        {
+            const std::string &line = lines[i];
+            bool itemOrdered;
+            size_t marker = listMarker(line, &itemOrdered);
+            if (marker && indentOf(line) <= baseIndent + 3 && itemOrdered == ordered)
+            {
+                items.emplace_back();
+                items.back().push_back(line.substr(marker));
+                ++i;
+                continue;
+            }
+            if (isBlank(line))
+            {
+                // the list continues if the next non blank line is indented or another item
+                size_t next = i;
+                while (next < lines.size() && isBlank(lines[next]))
+                    ++next;
+                if (next >= lines.size())
+                    break;
+                bool nextOrdered;
+                bool nextItem = listMarker(lines[next], &nextOrdered) && indentOf(lines[next]) <= baseIndent + 3 &&
+                                nextOrdered == ordered;
+                if (!nextItem && indentOf(lines[next]) <= baseIndent)
+                    break;
+                loose = true;
+                for (; i < next; ++i)
+                    items.back().push_back(std::string());
+                continue;
+            }
+            if (indentOf(line) > baseIndent)
+            {
+                // content of the item (e.g. a nested list), indented relative to the marker
+                items.back().push_back(unindent(line, baseIndent + 4 <= indentOf(line) ? baseIndent + 4 : indentOf(line)));
+                ++i;
+                continue;
+            }
+            if (!items.back().empty() && !isBlank(items.back().back()) && !startsBlock(line))
+            {
+                // lazy continuation of the paragraph
+                items.back().push_back(line);
+                ++i;
+                continue;
+            }
+            break;
+        }
+        html += ordered ? "<ol>\n" : "<ul>\n";
+        for (const auto &item : items)
+        {
+            html += "<li>";
+            std::string content;
+            renderBlocks(item, content, !loose, true);
+            if (!content.empty() && content.back() == '\n')
+                content.pop_back();
+            html += content + "</li>\n";
+        }
+        html += ordered ? "</ol>\n" : "</ul>\n";
+        return i;
+    }
+
+    std::string MarkdownRenderer::renderInline(const std::string &text)
+    {
+        std::string html;
+        html.reserve(text.size() + text.size() / 4);
+        size_t i = 0;
+        while (i < text.size())
+        {
+            char c = text[i];
+            if (c == '\\' && i + 1 < text.size() && ispunct((unsigned char)text[i + 1]))
+            {
+                html += escapeHtml(std::string(1, text[i + 1]));
+                i += 2;
+                continue;
+            }
+            if (c == '`')
+            {
+                size_t run = text.find_first_not_of('`', i) == std::string::npos ? text.size() - i : text.find_first_not_of('`', i) - i;
+                std::string delimiter(run, '`');
+                size_t end = text.find(delimiter, i + run);
+                if (end != std::string::npos)
+                {
+                    html += "<code>" + escapeHtml(trim(text.substr(i + run, end - i - run))) + "</code>";
+                    i = end + run;
+                    continue;
+                }
+                html += delimiter;
+                i += run;
+                continue;
+            }
+            if ((c == '[' || (c == '!' && i + 1 < text.size() && text[i + 1] == '[')))
+            {
+                const bool image = c == '!';
+                const size_t open = image ? i + 1 : i;
+                size_t close = matchBracket(text, open);
+                std::string url, title;
+                size_t end = close == std::string::npos ? std::string::npos : parseLinkTarget(text, close + 1, url, title);
+                if (end != std::string::npos)
+                {
+                    std::string label = text.substr(open + 1, close - open - 1);
+                    std::string titleAttribute = title.empty() ? std::string() : " title=\"" + escapeAttribute(title) + "\"";
+                    if (image)
+                        html += "<img alt=\"" + escapeAttribute(label) + "\" src=\"" + escapeAttribute(url) + "\"" + titleAttribute + " />";
+                    else
+                        html += "<a href=\"" + escapeAttribute(url) + "\"" + titleAttribute + ">" + renderInline(label) + "</a>";
+                    i = end;
+                    continue;
+                }
+                html += c;
+                ++i;
+                continue;
+            }
+            if (c == '<')
+            {
+                size_t end = text.find('>', i);
+                if (end != std::string::npos)
+                {
+                    std::string inner = text.substr(i + 1, end - i - 1);
+                    if (inner.find("://") != std::string::npos && inner.find(' ') == std::string::npos)
+                    {
+                        html += "<a href=\"" + escapeAttribute(inner) + "\">" + escapeHtml(inner) + "</a>";
+                        i = end + 1;
+                        continue;
+                    }
+                    if (inner.find('@') != std::string::npos && inner.find(' ') == std::string::npos)
+                    {
+                        html += "<a href=\"mailto:" + escapeAttribute(inner) + "\">" + escapeHtml(inner) + "</a>";
+                        i = end + 1;
+                        continue;
+                    }
+                    // inline html is passed through
+                    if (!inner.empty() && (isalpha((unsigned char)inner[0]) || inner[0] == '/' || inner[0] == '!'))
+                    {
+                        html += text.substr(i, end - i + 1);
+                        i = end + 1;
+                        continue;
+                    }
+                }
+                html += "&lt;";
+                ++i;
+                continue;
+            }
+            if (c == '&')
+            {
+                // entities are passed through
+                size_t end = text.find(';', i);
+                bool entity = end != std::string::npos && end > i + 1 && end - i < 10;
+                for (size_t j = i + 1; entity && j < end; ++j)
+                    entity = isalnum((unsigned char)text[j]) || (j == i + 1 && text[j] == '#');
+                html += entity ? "&" : "&amp;";
+                ++i;
+                continue;
+            }
+            if (c == '*' || c == '_')
+            {
+                size_t run = 1;
+                while (i + run < text.size() && text[i + run] == c && run < 3)
+                    ++run;
+                const bool intraword = c == '_' && i > 0 && isalnum((unsigned char)text[i - 1]);
+                const bool canOpen = i + run < text.size() && !isspace((unsigned char)text[i + run]) && !intraword;
+                if (canOpen)
+                {
+                    // find a closing run of the same length which is not preceded by a space
+                    std::string delimiter(run, c);
+                    size_t end = i + run;
+                    while ((end = text.find(delimiter, end + 1)) != std::string::npos)
+                    {
+                        const bool closes = !isspace((unsigned char)text[end - 1]) &&
+                                            (end + run >= text.size() || text[end + run] != c) &&
+                                            (c != '_' || end + run >= text.size() || !isalnum((unsigned char)text[end + run]));
+                        if (closes)
+                            break;
+                    }
+                    if (end != std::string::npos)
+                    {
+                        std::string inner = renderInline(text.substr(i + run, end - i - run));
+                        if (run == 1)
+                            html += "<em>" + inner + "</em>";
+                        else if (run == 2)
+                            html += "<strong>" + inner + "</strong>";
+                        else
+                            html += "<strong><em>" + inner + "</em></strong>";
+                        i = end + run;
+                        continue;
+                    }
+                }
+                html.append(run, c);
+                i += run;
+                continue;
+            }
+            if (c == '>')
+                html += "&gt;";
+            else
+                html += c;
+            ++i;
+        }
+        return html;
+    }
+
+} // end of namespace xrock_gui_model
@@ -0,0 +1,30 @@
+/**
+ * \file MarkdownRenderer.hpp
+ * \brief Converts the markdown descriptions of the component models to html
+ **/
+
+#pragma once
+#include <string>
+#include <vector>
+
+namespace xrock_gui_model
+{
+
+    // Renders the markdown syntax supported by python-markdown (headings, paragraphs, lists, block quotes,
+    // code blocks, horizontal rules, emphasis, code spans, links, images and inline html) plus fenced code
+    // blocks. Reference style links are not resolved.
+    class MarkdownRenderer
+    {
+    public:
+        static std::string toHtml(const std::string &markdown);
+        static std::string escapeHtml(const std::string &text);
+
+    private:
+        // tight: paragraphs without <p> (items of tight lists), listItem: the lines are the content of a list item
+        static void renderBlocks(const std::vector<std::string> &lines, std::string &html, bool tight = false,
+                                 bool listItem = false);
+        static size_t renderList(const std::vector<std::string> &lines, size_t start, std::string &html);
+        static std::string renderInline(const std::string &text);
+    };
+
+} // end of namespace xrock_gui_model
@@ -0,0 +1,172 @@
+/**
+ * \file NodeInfoCache.cpp
+ * \brief Persistent cache of the NodeInfo entries derived from the node definition files
+ **/
+
+#include "NodeInfoCache.hpp"
+#include "ConfigMapHelper.hpp"
+#include "Logger.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <cstdio>
+
+using namespace configmaps;
+
+namespace xrock_gui_model
+{
+
+    // Increase the version whenever the format or the NodeInfo derivation changes
+    static const char cacheMagic[8] = {'X', 'R', 'N', 'I', 'C', 'A', 'C', 'H'};
+    static const uint32_t cacheVersion = 2;
+
+    bool NodeInfoCache::load(const std::string &filename)
+    {
+        entries.clear();
+        modified = false;
+        std::ifstream in(filename, std::ios::binary);
+        if (!in)
+            return false;
+
+        char magic[sizeof(cacheMagic)];
+        uint32_t version;
+        uint64_t numEntries;
+        if (!in.read(magic, sizeof(magic)) ||
+            !std::equal(magic, magic + sizeof(magic), cacheMagic) ||
+            !ConfigMapHelper::readBinaryValue(in, version) || version != cacheVersion ||
+            !ConfigMapHelper::readBinaryValue(in, numEntries))
+        {
+            XROCK_LOG(Info, "NodeInfoCache: ignore outdated cache " << filename);
+            modified = true;
+            return false;
+        }
+
+        for (uint64_t i = 0; i < numEntries; ++i)
+        {
+            std::string path;
+            Entry entry;
+            uint64_t numInfos;
+            if (!ConfigMapHelper::readBinaryString(in, path) || !ConfigMapHelper::readBinaryValue(in, entry.mtime) ||
+                !ConfigMapHelper::readBinaryValue(in, entry.size) || !ConfigMapHelper::readBinaryValue(in, numInfos))
+            {
+                break;
+            }
+            entry.infos.resize(numInfos);
+            bool valid = true;
+            for (auto &info : entry.infos)
+            {
+                int32_t numInputs, numOutputs;
+                if (!ConfigMapHelper::readBinaryString(in, info.type) || !ConfigMapHelper::readBinaryValue(in, numInputs) ||
+                    !ConfigMapHelper::readBinaryValue(in, numOutputs) || !ConfigMapHelper::readBinary(in, info.map))
+                {
+                    valid = false;
+                    break;
+                }
+                info.numInputs = numInputs;
+                info.numOutputs = numOutputs;
+            }
+            if (!valid)
+            {
+                // drop the corrupt rest of the cache, the files will be parsed again
+                XROCK_LOG(Warning, "NodeInfoCache: corrupt cache " << filename);
+                modified = true;
+                break;
+            }
+            entries[path] = std::move(entry);
+        }
+        return true;
+    }
+
+    bool NodeInfoCache::store(const std::string &filename)
+    {
+        const std::string tmpFile = filename + ".tmp";
+        {
+            std::ofstream out(tmpFile, std::ios::binary | std::ios::trunc);
+            if (!out)
+            {
+                XROCK_LOG(Warning, "NodeInfoCache: cannot write " << tmpFile);
+                return false;
+            }
+            uint64_t numEntries = 0;
+            for (auto &it : entries)
+            {
+                if (it.second.used)
+                    ++numEntries;
+            }
+            out.write(cacheMagic, sizeof(cacheMagic));
+            ConfigMapHelper::writeBinaryValue(out, cacheVersion);
+            ConfigMapHelper::writeBinaryValue(out, numEntries);
+            for (auto &it : entries)
+            {
+                Entry &entry = it.second;
+                if (!entry.used)
+                    continue;
+                ConfigMapHelper::writeBinaryString(out, it.first);
+                ConfigMapHelper::writeBinaryValue(out, entry.mtime);
+                ConfigMapHelper::writeBinaryValue(out, entry.size);
+                ConfigMapHelper::writeBinaryValue<uint64_t>(out, entry.infos.size());
+                for (auto &info : entry.infos)
+                {
+                    ConfigMapHelper::writeBinaryString(out, info.type);
+                    ConfigMapHelper::writeBinaryValue<int32_t>(out, info.numInputs);
+                    ConfigMapHelper::writeBinaryValue<int32_t>(out, info.numOutputs);
+                    ConfigMapHelper::writeBinary(out, info.map);
+                }
+            }
+            if (!out)
+            {
+                XROCK_LOG(Warning, "NodeInfoCache: error writing " << tmpFile);
+                return false;
+            }
+        }
+        // replace the old cache only if the new one is complete
+        if (std::rename(tmpFile.c_str(), filename.c_str()) != 0)
+        {
+            std::remove(tmpFile.c_str());
+            return false;
+        }
+        modified = false;
+        return true;
+    }
+
+    bool NodeInfoCache::needsStore() const
+    {
+        if (modified)
+            return true;
+        for (auto &it : entries)
+        {
+            // entries of removed definition files have to be dropped
+            if (!it.second.used)
+                return true;
+        }
+        return false;
+    }
+
+    const std::vector<osg_graph_viz::NodeInfo> *NodeInfoCache::lookup(const std::string &path, int64_t mtime, uint64_t size) const
+    {
+        auto it = entries.find(path);
+        if (it == entries.end() || it->second.mtime != mtime || it->second.size != size)
+            return NULL;
+        return &it->second.infos;
+    }
+
+    void NodeInfoCache::touch(const std::string &path)
+    {
+        auto it = entries.find(path);
+        if (it != entries.end())
+            it->second.used = true;
+    }
+
+    void NodeInfoCache::update(const std::string &path, int64_t mtime, uint64_t size,
+                               const std::vector<osg_graph_viz::NodeInfo> &infos)
+    {
+        Entry &entry = entries[path];
+        entry.mtime = mtime;
+        entry.size = size;
+        entry.used = true;
+        entry.infos = infos;
+        modified = true;
+    }
+
+} // end of namespace xrock_gui_model
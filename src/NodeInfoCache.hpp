@@ -0,0 +1,51 @@
+/**
+ * \file NodeInfoCache.hpp
+ * \brief Persistent cache of the NodeInfo entries derived from the node definition files
+ **/
+
+#pragma once
+#include <osg_graph_viz/Node.hpp>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace xrock_gui_model
+{
+
+    class NodeInfoCache
+    {
+    public:
+        NodeInfoCache() : modified(false) {}
+        ~NodeInfoCache() {}
+
+        // Reads the binary cache file. Returns false if the file does not exist or has an unknown format.
+        bool load(const std::string &filename);
+        // Writes all entries which were used or updated since load() to the binary cache file
+        bool store(const std::string &filename);
+        // Returns true if store() would change the content of the cache file
+        bool needsStore() const;
+
+        // Returns the cached infos of the given definition file or NULL if the file changed
+        // (mtime in nanoseconds or size, see FileStat).
+        // This function does not modify the cache and can be called from multiple threads.
+        const std::vector<osg_graph_viz::NodeInfo> *lookup(const std::string &path, int64_t mtime, uint64_t size) const;
+        // Marks the entry of the given definition file as used
+        void touch(const std::string &path);
+        // Replaces the entry of the given definition file
+        void update(const std::string &path, int64_t mtime, uint64_t size,
+                    const std::vector<osg_graph_viz::NodeInfo> &infos);
+
+    private:
+        struct Entry
+        {
+            int64_t mtime = 0;
+            uint64_t size = 0;
+            bool used = false;
+            std::vector<osg_graph_viz::NodeInfo> infos;
+        };
+        std::map<std::string, Entry> entries;
+        bool modified;
+    };
+
+} // end of namespace xrock_gui_model
@@ -0,0 +1,142 @@
+/**
+ * \file PortResolver.cpp
+ * \brief Asynchronous resolution of the dynamic ports of ROCK task models with a result cache
+ **/
+
+#include "PortResolver.hpp"
+#include "JobRunner.hpp"
+#include "Logger.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+
+namespace xrock_gui_model
+{
+
+    // On macOS the tools are started by their interpreter with the library path of autoproj
+    static void prepareCommand(JobRunner::Command &command, const std::string &interpreter)
+    {
+#ifdef __APPLE__
+        const char *root = getenv("AUTOPROJ_CURRENT_ROOT");
+        const char *libraryPath = getenv("MYLD_LIBRARY_PATH");
+        command.args.insert(command.args.begin(), std::string(root ? root : "") + "/install/bin/" + command.program);
+        command.program = interpreter;
+        command.environment["DYLD_LIBRARY_PATH"] = libraryPath ? libraryPath : "";
+#endif
+    }
+
+    PortResolver::PortResolver(JobRunner *runner) : runner(runner)
+    {
+    }
+
+    PortResolver::~PortResolver()
+    {
+    }
+
+    static std::string configHash(const PortResolver::Request &request)
+    {
+        std::string config = request.config;
+        if (config.empty())
+        {
+            config = "config_names:";
+            for (const auto &name : request.configNames)
+                config += " " + name;
+        }
+        char hash[32];
+        snprintf(hash, sizeof(hash), "%zx", std::hash<std::string>()(config));
+        return hash;
+    }
+
+    std::string PortResolver::cacheKey(const Request &request)
+    {
+        // the resolved version only exists in the database it was stored to
+        return request.dbPath + "|" + request.dbGraph + "|" + request.taskModel + "/" + request.taskVersion + "/" + configHash(request);
+    }
+
+    std::string PortResolver::versionName(const Request &request)
+    {
+        return request.newVersion + "_" + configHash(request);
+    }
+
+    void PortResolver::resolve(const Request &request, Callback done)
+    {
+        const std::string key = cacheKey(request);
+        auto cached = cache.find(key);
+        if (cached != cache.end())
+        {
+            XROCK_LOG(Info, "PortResolver: use resolved version " << cached->second << " of " << request.taskModel);
+            done(true, cached->second);
+            return;
+        }
+        auto running = pending.find(key);
+        if (running != pending.end())
+        {
+            running->second.push_back(done);
+            return;
+        }
+        pending[key].push_back(done);
+
+        // the model is written to stdout if no output file is given
+        JobRunner::Command command;
+        command.name = "resolve ports of " + request.taskModel;
+        command.program = "xrock-resolve-ports";
+        command.logOutput = false;
+        if (!request.config.empty())
+        {
+            command.args = {"-c", "/dev/stdin", request.taskModel, "default"};
+            command.input = "--- name:default\n" + request.config;
+        }
+        else
+        {
+            command.args.push_back(request.taskModel);
+            command.args.insert(command.args.end(), request.configNames.begin(), request.configNames.end());
+        }
+        prepareCommand(command, "ruby");
+        runner->run(command, [this, key, request](const JobRunner::Result &result)
+                    {
+            if (!result.success)
+                finish(key, false, result.canceled ? "canceled" : "xrock-resolve-ports failed");
+            else if (result.output.find_first_not_of(" \t\r\n") == std::string::npos)
+                finish(key, false, "xrock-resolve-ports returned no model");
+            else
+                importModel(key, request, result.output); });
+    }
+
+    void PortResolver::importModel(const std::string &key, const Request &request, const std::string &model)
+    {
+        const std::string version = versionName(request);
+        JobRunner::Command command;
+        command.name = "import " + request.taskModel + " " + version;
+        command.program = "xrock-orogen-to-xrock";
+        command.args = {"--model_name", request.taskModel, "--model_file", "/dev/stdin",
+                        "--model_version", version, "-a", request.dbPath, "-g", request.dbGraph};
+        command.input = model;
+        prepareCommand(command, "python");
+        runner->run(command, [this, key, version](const JobRunner::Result &result)
+                    {
+            if (!result.success)
+            {
+                finish(key, false, result.canceled ? "canceled" : "xrock-orogen-to-xrock failed");
+                return;
+            }
+            cache[key] = version;
+            finish(key, true, version); });
+    }
+
+    void PortResolver::finish(const std::string &key, bool success, const std::string &result)
+    {
+        auto it = pending.find(key);
+        if (it == pending.end())
+            return;
+        // the callbacks may start new requests
+        std::vector<Callback> callbacks;
+        callbacks.swap(it->second);
+        pending.erase(it);
+        if (!success)
+            XROCK_LOG(Error, "PortResolver: " << result);
+        for (auto &callback : callbacks)
+            callback(success, result);
+    }
+
+} // end of namespace xrock_gui_model
@@ -0,0 +1,57 @@
+/**
+ * \file PortResolver.hpp
+ * \brief Asynchronous resolution of the dynamic ports of ROCK task models with a result cache
+ **/
+
+#pragma once
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace xrock_gui_model
+{
+    class JobRunner;
+
+    // Runs xrock-resolve-ports and xrock-orogen-to-xrock as jobs of the JobRunner to create a new version of
+    // a task model with the ports resulting from a configuration. The configuration and the resolved model are
+    // passed through the pipes of the processes. Resolved versions are cached by database, task model, version
+    // and configuration, so applying the same configuration again (also in another model) does not start the tools.
+    class PortResolver
+    {
+    public:
+        struct Request
+        {
+            std::string taskModel, taskVersion;
+            // Either the yaml configuration (section "default") or the names of the configuration sections
+            std::string config;
+            std::vector<std::string> configNames;
+            // Prefix of the name of the version to create and the database to store it. The created version
+            // is named newVersion + "_" + the hash of the configuration, so different configurations of the
+            // same task model in one model do not overwrite each other (see versionName()).
+            std::string newVersion;
+            std::string dbPath, dbGraph;
+        };
+        // Called with the resolved version or with the error message if success is false
+        typedef std::function<void(bool success, const std::string &result)> Callback;
+
+        explicit PortResolver(JobRunner *runner);
+        ~PortResolver();
+
+        // Calls done immediately if the request was resolved before, otherwise once the tools are finished.
+        // Requests with the same key as a running one wait for its result.
+        void resolve(const Request &request, Callback done);
+        static std::string cacheKey(const Request &request);
+        static std::string versionName(const Request &request);
+
+    private:
+        JobRunner *runner;
+        // resolved versions and the callbacks of the running requests by cache key
+        std::map<std::string, std::string> cache;
+        std::map<std::string, std::vector<Callback>> pending;
+
+        void importModel(const std::string &key, const Request &request, const std::string &model);
+        void finish(const std::string &key, bool success, const std::string &result);
+    };
+
+} // end of namespace xrock_gui_model
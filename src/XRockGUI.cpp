@@ -16,6 +16,15 @@
 #include "BuildModuleDialog.hpp"
 #include "ConfigureDialog.hpp"
 #include "ConfigMapHelper.hpp"
+#include "Logger.hpp"
+#include "CndExporter.hpp"
+#include "YamlWriter.hpp"
+#include "CndImporter.hpp"
+#include "PortResolver.hpp"
+#include "JobRunner.hpp"
+#include "JobLogWidget.hpp"
+#include "MarkdownRenderer.hpp"
+#include "DeploymentGenerator.hpp"
 
 #include "plugins/MARSIMUConfig.hpp"
 #include "plugins/ROCKTASKConfig.hpp"
@@ -27,13 +36,16 @@
 #include <QFileDialog>
 #include <QFileInfo>
 #include <QMessageBox>
+#include <QProgressDialog>
+#include <QApplication>
 #include <mars/utils/misc.h>
 #include <QWebView>
 #include <QUuid>
-#include <QDateTime>
 #include <iostream>
 #include <fstream>
 #include <iomanip> // for std::put_time()
+#include <chrono>
+#include <algorithm>
 
 #include "utils/WaitCursorRAII.hpp"
 #include <smurf_parser/SMURFParser.h>
@@ -45,25 +57,27 @@ using namespace mars::utils;
 
 namespace xrock_gui_model
 {
-    std::string getHtml2(const std::string &markdown)
-    {
-        std::string cmd = "echo \"" + markdown + "\" | python -m markdown";
-        std::array<char, 128> buffer;
-        std::string result;
-        std::shared_ptr<FILE> pipe(popen(cmd.c_str(), "r"), pclose);
-        if (!pipe)
-            throw std::runtime_error("popen() failed!");
-        while (!feof(pipe.get()))
-        {
-            if (fgets(buffer.data(), 128, pipe.get()) != nullptr)
-                result += buffer.data();
-        }
-        return result;
-    }
-
-    XRockGUI::XRockGUI(lib_manager::LibManager *theManager) : lib_manager::LibInterface(theManager), ioLibrary(NULL)
+    // Time (ms) spent loading a model before the GUI events are processed again
+    static const double loadTimeSlice = 30.0;
+    // Number of rendered model descriptions kept in memory
+    static const size_t descriptionCacheSize = 128;
+
+    // Node map entries read by the context handlers without copying the whole node
+    static const ConfigPath modelNamePath("model/name");
+    static const ConfigPath modelDomainPath("model/domain");
+    static const ConfigPath modelVersionPath("model/versions/0/name");
+
+    XRockGUI::XRockGUI(lib_manager::LibManager *theManager) : lib_manager::LibInterface(theManager), ioLibrary(NULL), jobLogWidget(NULL),
+                                                                          descriptionCache(descriptionCacheSize), descriptionView(NULL)
     {
         initConfig();
+        size_t maxJobs = 2;
+        if (env.hasKey("max_jobs"))
+        {
+            // at least one job has to run, otherwise the queue never drains
+            maxJobs = std::max((int)env["max_jobs"], 1);
+        }
+        jobRunner.reset(new JobRunner(maxJobs));
         initBagelGui();
         initMainGui();
 
@@ -110,6 +124,12 @@ namespace xrock_gui_model
                 env.append(ConfigMap::fromYamlFile(confDir + "/config.yml"));
             }
             env["ConfigDir"] = confDir;
+            // The XROCK_LOG_LEVEL environment variable takes precedence over the configuration
+            if (!getenv("XROCK_LOG_LEVEL") && env.hasKey("log_level") &&
+                !Logger::instance().setLevel(env["log_level"].getString()))
+            {
+                XROCK_LOG(Warning, "XRockGUI: unknown log_level " << env["log_level"].getString());
+            }
             std::string defaultAddress = "../../../bagel/bagel_db";
             mars::utils::handleFilenamePrefix(&defaultAddress, confDir);
             if (env.hasKey("dbType"))
@@ -148,7 +168,7 @@ namespace xrock_gui_model
                 ConfigMap dbConfig = ioLibrary->getDefaultConfig();
                 if(!dbConfig.empty())
                 {
-                    fprintf(stderr, "---    default config\n%s", dbConfig.toYamlString().c_str());
+                    XROCK_LOG(Debug, "default config\n" << dbConfig.toYamlString());
                     std::string dbType = dbConfig.begin()->first;
                     ConfigMap &config = dbConfig.begin()->second;
                     env["backend"] = dbType;
@@ -170,7 +190,7 @@ namespace xrock_gui_model
                         env["dbType"] = "MultiDbClient";
                         env["multiDBConfig"] = config.toJsonString();
                         db.reset(ioLibrary->getDB(env));
-                        fprintf(stderr, "---    Set MultiDB from default config\n");
+                        XROCK_LOG(Info, "Set MultiDB from default config");
                     }
                     else
                     {
@@ -198,7 +218,7 @@ namespace xrock_gui_model
             }
         }
         else
-            std::cerr << "Error: Failed to load library cfg_manager!" << std::endl;
+            XROCK_LOG(Error, "XRockGUI: failed to load library cfg_manager");
     }
 
     void XRockGUI::initBagelGui()
@@ -229,7 +249,7 @@ namespace xrock_gui_model
         }
         else
         {
-            std::cerr << "ERROR: XRockGUI: was not able to get bagel_gui!" << std::endl;
+            XROCK_LOG(Error, "XRockGUI: was not able to get bagel_gui");
         }
     }
 
@@ -244,11 +264,15 @@ namespace xrock_gui_model
             gui->addGenericMenuAction("../File/Export/Model", static_cast<int>(MenuActions::SAVE_MODEL), this);
             gui->addGenericMenuAction("../File/Export/CNDModel", static_cast<int>(MenuActions::EXPORT_CND), this);
             gui->addGenericMenuAction("../File/Export/CNDModel With tf_enhance", static_cast<int>(MenuActions::EXPORT_CND_TFENHANCE), this);
+            gui->addGenericMenuAction("../File/Export/Deployment", static_cast<int>(MenuActions::EXPORT_DEPLOYMENT), this);
+            gui->addGenericMenuAction("../File/Export/CND Partitions by Host", static_cast<int>(MenuActions::EXPORT_CND_PARTITIONS_BY_HOST), this);
+            gui->addGenericMenuAction("../File/Export/CND Partitions by Deployment", static_cast<int>(MenuActions::EXPORT_CND_PARTITIONS_BY_DEPLOYMENT), this);
             gui->addGenericMenuAction("../Database/New Model", static_cast<int>(MenuActions::NEW_MODEL), this);
             gui->addGenericMenuAction("../Database/Add Component", static_cast<int>(MenuActions::ADD_COMPONENT_FROM_DB), this);
             gui->addGenericMenuAction("../Database/Store Model", static_cast<int>(MenuActions::STORE_MODEL_TO_DB), this);
             gui->addGenericMenuAction("../Database/Load Model", static_cast<int>(MenuActions::LOAD_MODEL_FROM_DB), this);
             gui->addGenericMenuAction("../Windows/ComponentModelEditorWidget", static_cast<int>(MenuActions::TOGGLE_MODEL_WIDGET), this);
+            gui->addGenericMenuAction("../Windows/Jobs", static_cast<int>(MenuActions::TOGGLE_JOB_LOG), this);
             gui->addGenericMenuAction("../Expert/Edit Description", static_cast<int>(MenuActions::EDIT_MODEL_DESCRIPTION), this);
             gui->addGenericMenuAction("../Expert/Edit Local Map", static_cast<int>(MenuActions::EDIT_LOCAL_MAP), this);
             gui->addGenericMenuAction("../Expert/Create Bagel Model", static_cast<int>(MenuActions::CREATE_BAGEL_MODEL), this);
@@ -267,6 +291,8 @@ namespace xrock_gui_model
                                       icon + "remove.png", true);
             gui->addGenericMenuAction("../Actions/Build", static_cast<int>(MenuActions::BUILD_MODULE_TO_DB), this, 0,
                                       icon + "build.png", true);
+            gui->addGenericMenuAction("../Actions/Layout/Layered", static_cast<int>(MenuActions::LAYOUT_LAYERED), this);
+            gui->addGenericMenuAction("../Actions/Layout/Force Directed", static_cast<int>(MenuActions::LAYOUT_FORCE_DIRECTED), this);
             gui->addGenericMenuAction("../Implements/Abstract_gui", static_cast<int>(MenuActions::RUN_ABSTRACT_GUI), this, 0,
                                       icon + "abstract.png", true);
             gui->addGenericMenuAction("../Edit/Global Variabls/Edit", static_cast<int>(MenuActions::EDIT_GLOBAL_VARIABLES), this, 0, "", true);
@@ -288,6 +314,11 @@ namespace xrock_gui_model
                 gui->addDockWidget((void *)widget, 1);
                 bagelGui->updateViewSize();
             }
+            jobLogWidget = new JobLogWidget(cfg, jobRunner.get());
+            if (!jobLogWidget->getHiddenCloseState())
+            {
+                gui->addDockWidget((void *)jobLogWidget, 1);
+            }
             //std::string loadGraph;
             //cfg->getPropertyValue("Config", "model", "value", &loadGraph);
             //if (!loadGraph.empty())
@@ -298,12 +329,13 @@ namespace xrock_gui_model
         }
         else
         {
-            std::cerr << "XRockGUI: was not able to get main_gui" << std::endl;
+            XROCK_LOG(Error, "XRockGUI: was not able to get main_gui");
         }
     }
 
     XRockGUI::~XRockGUI()
     {
+        delete descriptionView;
         widget->deinit();
         if (gui)
             libManager->releaseLibrary("main_gui");
@@ -350,7 +382,7 @@ namespace xrock_gui_model
             }
             else
             {
-                std::cerr << "loadStartModel: no model given" << std::endl;
+                XROCK_LOG(Warning, "loadStartModel: no model given");
             }
         }
     }
@@ -373,7 +405,7 @@ namespace xrock_gui_model
             }
             else
             {
-                std::cerr << "loadStartModel: no model given" << std::endl;
+                XROCK_LOG(Warning, "loadStartModel: no model given");
             }
         }
     }
@@ -406,9 +438,7 @@ namespace xrock_gui_model
         }
         catch (...)
         {
-            std::stringstream ss;
-            ss << "loadSettingsFromFile: ERROR while loading: " << workspace << '/' << filename;
-            std::cerr << ss.str() << std::endl;
+            XROCK_LOG(Error, "loadSettingsFromFile: error while loading: " << workspace << '/' << filename);
         }
     }
 
@@ -441,8 +471,12 @@ namespace xrock_gui_model
                 fileName = QFileDialog::getSaveFileName(NULL, QObject::tr("Select Model File"),
                                                         fileName, QObject::tr("YAML syntax (*.yml)"), 0,
                                                         QFileDialog::DontUseNativeDialog);
+                if (fileName.isNull())
+                    break;
                 BasicModelHelper::convertToLegacyModelFormat(map);
-                map.toYamlFile(fileName.toStdString());
+                std::string error;
+                if (!YamlWriter::writeFile(fileName.toStdString(), map, error))
+                    QMessageBox::critical(nullptr, "Save Model", QString::fromStdString("Failed to save model: " + error), QMessageBox::Ok);
                 break;
             }
             case MenuActions::TOGGLE_MODEL_WIDGET:
@@ -457,6 +491,18 @@ namespace xrock_gui_model
                 }
                 break;
             }
+            case MenuActions::TOGGLE_JOB_LOG:
+            {
+                if (jobLogWidget->isHidden())
+                {
+                    gui->addDockWidget((void *)jobLogWidget, 1);
+                }
+                else
+                {
+                    gui->removeDockWidget((void *)jobLogWidget, 1);
+                }
+                break;
+            }
             case MenuActions::STORE_MODEL_TO_DB: // store model
             {
                 if (!storeComponentModel())
@@ -608,7 +654,7 @@ namespace xrock_gui_model
                 std::string path = getPathOfFile(filename);
                 path = pathJoin(getCurrentWorkingDir(), path);
                 removeFilenamePrefix(&filename);
-                fprintf(stderr, "load frames from: %s - %s\n", path.c_str(), filename.c_str());
+                XROCK_LOG(Info, "load frames from: " << path << " - " << filename);
                 model = smurf_parser::parseFile(&entityconfig, path, filename, true);
                 std::map<std::string, urdf::LinkSharedPtr >::iterator it;
                 ConfigMap frames;
@@ -626,7 +672,7 @@ namespace xrock_gui_model
                     }
                     frames["frameNames"].push_back(frame);
                 }
-                //fprintf(stderr, "frames:\n%s\n", frames.toYamlString().c_str());
+                XROCK_LOG(Debug, "frames:\n" << frames.toYamlString());
                 ConfigMap globalConfig = bagelGui->getGlobalConfig();
                 globalConfig["frameNames"] = frames["frameNames"];
                 bagelGui->setGlobalConfig(globalConfig);                
@@ -717,6 +763,17 @@ namespace xrock_gui_model
                 }
                 break;
             }
+            case MenuActions::LAYOUT_LAYERED:
+            case MenuActions::LAYOUT_FORCE_DIRECTED:
+            {
+                ComponentModelInterface *model = dynamic_cast<ComponentModelInterface *>(bagelGui->getCurrentModel());
+                if (model)
+                {
+                    WaitCursorRAII _;
+                    model->autoLayout(action == static_cast<int>(MenuActions::LAYOUT_FORCE_DIRECTED));
+                }
+                break;
+            }
             case MenuActions::CREATE_BAGEL_MODEL:
             {
                 // 20221102 MS: Why is this here? Has nothing todo with XROCK.
@@ -862,13 +919,35 @@ namespace xrock_gui_model
                 QString fileName = QFileDialog::getSaveFileName(NULL, QObject::tr("Select Model"),
                                                                 "export.cnd", QObject::tr("YAML syntax (*.cnd)"), 0,
                                                                 QFileDialog::DontUseNativeDialog);
-                if (!urdf_file.isNull())
+                if (!urdf_file.isNull() && !fileName.isNull())
                 {
                     ConfigMap map = bagelGui->createConfigMap();
                     exportCnd(map, fileName.toStdString(), urdf_file.toStdString());
                 }
                 break;
             }
+            case MenuActions::EXPORT_DEPLOYMENT:
+            {
+                QString folder = QFileDialog::getExistingDirectory(NULL, QObject::tr("Select Deployment Folder"), ".",
+                                                                   QFileDialog::ShowDirsOnly | QFileDialog::DontUseNativeDialog);
+                if (!folder.isNull())
+                {
+                    createDeployment(folder.toStdString());
+                }
+                break;
+            }
+            case MenuActions::EXPORT_CND_PARTITIONS_BY_HOST:
+            case MenuActions::EXPORT_CND_PARTITIONS_BY_DEPLOYMENT:
+            {
+                QString folder = QFileDialog::getExistingDirectory(NULL, QObject::tr("Select Export Folder"), ".",
+                                                                   QFileDialog::ShowDirsOnly | QFileDialog::DontUseNativeDialog);
+                if (!folder.isNull())
+                {
+                    exportCndPartitions(folder.toStdString(),
+                                        action == static_cast<int>(MenuActions::EXPORT_CND_PARTITIONS_BY_HOST) ? "hostID" : "deployment");
+                }
+                break;
+            }
             case MenuActions::RUN_ABSTRACT_GUI:
             {
                 runAbstractGui();
@@ -991,8 +1070,7 @@ namespace xrock_gui_model
                     }
                 }
                 ConfigVector::iterator it = motorMap["motors"].begin();
-                double step = 22.0;
-                double n = (motorMap["motors"].size() * 1.) * step;
+                std::vector<std::string> addedMotors;
                 for (; it != motorMap["motors"].end(); ++it)
                 {
                     std::string motorName = (*it)["name"];
@@ -1016,9 +1094,14 @@ namespace xrock_gui_model
                         nodeMap["outputs"][0]["interface"] = 1;
                         nodeMap["outputs"][0]["interfaceExportName"] = motorName + "/des_angle";
                         bagelGui->updateNodeMap(motorName, nodeMap);
+                        addedMotors.push_back(motorName);
                     }
-
-                    n -= step;
+                }
+                // the motor nodes are added at the same position and are not connected yet, place them in a free column
+                ComponentModelInterface *componentModel = dynamic_cast<ComponentModelInterface *>(bagelGui->getCurrentModel());
+                if (!addedMotors.empty() && componentModel)
+                {
+                    componentModel->placeNodes(addedMotors);
                 }
             }
             //widget->loadType("SOFTWARE", "PIPE", "v1.0.0");
@@ -1074,7 +1157,7 @@ namespace xrock_gui_model
         const std::string& type(model->deriveTypeFrom(domain, modelName, version));
         if (!model->registerComponentModel(domain, modelName, version))
         {
-            std::cerr << "XRockGUI::addComponent(): Could not register component model " << type << "\n";
+            XROCK_LOG(Error, "XRockGUI::addComponent(): could not register component model " << type);
             return;
         }
         if (nodeName.empty())
@@ -1091,13 +1174,37 @@ namespace xrock_gui_model
         bagelGui->createView("xrock", map["name"]);
         ComponentModelInterface *model = dynamic_cast<ComponentModelInterface *>(bagelGui->getCurrentModel());
 
+        if (!BasicModelHelper::decodeData(map["versions"][0]))
+            map["versions"][0]["data"] = ConfigMap();
         if (!map["versions"][0]["data"].hasKey("gui"))
             map["versions"][0]["data"]["gui"] = ConfigMap();
         if (!map["versions"][0]["data"]["gui"].hasKey("defaultLayout"))
             map["versions"][0]["data"]["gui"]["defaultLayout"] = "software";
 
-        // Set the model info of the ComponentModelInterface
-        model->setModelInfo(map);
+        // Set the model info of the ComponentModelInterface. The model is loaded in time slices between
+        // which the Qt events are processed, so the view is updated and the load can be canceled.
+        const auto loadStart = std::chrono::steady_clock::now();
+        model->beginModelInfo(map);
+        size_t processed, total;
+        model->getModelInfoProgress(&processed, &total);
+        QProgressDialog progress("Loading " + QString::fromStdString(map["name"].getString() + "..."), "Cancel", 0, (int)total);
+        progress.setWindowModality(Qt::ApplicationModal);
+        progress.setMinimumDuration(500);
+        while (!model->continueModelInfo(loadTimeSlice))
+        {
+            model->getModelInfoProgress(&processed, &total);
+            progress.setValue((int)processed);
+            QApplication::processEvents();
+            if (progress.wasCanceled())
+            {
+                model->cancelModelInfo();
+                bagelGui->closeCurrentTab();
+                return;
+            }
+        }
+        progress.setValue((int)total);
+        XROCK_LOG(Info, "loaded " << map["name"].getString() << ": " << total << " items in "
+                  << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart).count() << " ms");
         // Afterwards we have to (re-)trigger the currentModelChanged() function
         currentModelChanged(model);
     }
@@ -1139,36 +1246,42 @@ namespace xrock_gui_model
     void XRockGUI::changeNodeVersion(const std::string &name)
     {
         versionChangeName = name;
-        const ConfigMap *node_ = bagelGui->getNodeMap(name);
-        if (!node_)
+        const ConfigMap *node = bagelGui->getNodeMap(name);
+        if (!node)
             return;
-        ConfigMap node = *node_;
         VersionDialog vd(this);
         // When we request to change the version of a node, we have to search for alternative component models
-        std::string domain = node["model"]["domain"];
-        std::string type = node["model"]["name"];
+        std::string domain = ConfigMapHelper::getString(*node, modelDomainPath);
+        std::string type = ConfigMapHelper::getString(*node, modelNamePath);
         vd.requestComponent(domain, type);
         vd.exec();
     }
 
     void XRockGUI::configureNode(const std::string &name)
     {
-        ConfigMap node = *(bagelGui->getNodeMap(name));
+        const ConfigMap *nodePtr = bagelGui->getNodeMap(name);
+        if (!nodePtr)
+            return;
         ConfigMap config;
-        if(node.hasKey("configuration"))
+        // Preload the current configuration
+        static const ConfigPath dataPath("configuration/data");
+        ConfigMapHelper::getMap(*nodePtr, dataPath, config);
+        ConfigMap loadedConfig = config;
         {
-            // Preload the current configuration
-            if(node["configuration"].hasKey("data"))
+            std::string modelName = ConfigMapHelper::getString(*nodePtr, modelNamePath);
+            std::string nodeName = ConfigMapHelper::getString(*nodePtr, ConfigPath("alias"));
+            if (nodeName.empty())
+                nodeName = name;
+
+            bool isTask = false;
+            static const ConfigPath typesPath("model/types");
+            static const ConfigPath typeNamePath("name");
+            const ConfigItem *types = ConfigMapHelper::findItem(*nodePtr, typesPath);
+            for (size_t i = 0; types && !isTask && i < ConfigMapHelper::getSize(*types); ++i)
             {
-                config = node["configuration"]["data"];
+                const ConfigItem *type = ConfigMapHelper::findItem(*types, ConfigPath(std::to_string(i)));
+                isTask = ConfigMapHelper::getString(*type, typeNamePath) == "Rock::Task";
             }
-        }
-        {
-            std::string modelName = node["model"]["name"];
-            std::string nodeName = node.hasKey("alias") && node["alias"] != "" ? (std::string)node["alias"] : name;
-
-            bool isTask = std::any_of(node["model"]["types"].begin(), node["model"]["types"].end(), [](configmaps::ConfigItem &type)
-                                      { return type["name"] == "Rock::Task"; });
 
             std::map<std::string, ConfigureDialogLoader *>::iterator it;
             // first check if we find the node type (model name) in the configPlugis
@@ -1194,28 +1307,33 @@ namespace xrock_gui_model
                 }
                 else
                 {
-                    ConfigureDialog cd(&config, env, node["model"]["name"], true, true);
+                    ConfigureDialog cd(&config, env, modelName, true, true);
                     cd.setWindowTitle(QString::fromStdString("Configure Node " + nodeName));
                     cd.resize(400, 400);
                     cd.exec();
                 }
             }
         }
-        // Update the node configuration
-        node["configuration"]["data"] = config;
-        bagelGui->updateNodeMap(name, node);
+        // Update the node configuration; the node is only copied if the configuration changed
+        // (the node is looked up again since the dialog runs an event loop)
+        nodePtr = bagelGui->getNodeMap(name);
+        if (nodePtr && !ConfigMapHelper::equals(loadedConfig, config))
+        {
+            ConfigMap node = *nodePtr;
+            node["configuration"]["data"] = config;
+            bagelGui->updateNodeMap(name, node);
+        }
     }
     
     void XRockGUI::configureEdge(const std::string &name)
     {
-        ConfigMap edge = *(bagelGui->getEdgeMap(name));
+        const ConfigMap *edgePtr = bagelGui->getEdgeMap(name);
+        if (!edgePtr)
+            return;
         ConfigMap config;
-        if (edge.hasKey("configuration"))
-        {
-            // Preload the current configuration
-            config = edge["configuration"];
-
-        }
+        // Preload the current configuration
+        ConfigMapHelper::getMap(*edgePtr, ConfigPath("configuration"), config);
+        ConfigMap loadedConfig = config;
 
         {
             ConfigureDialog cd(&config, env, name, true, true);
@@ -1223,15 +1341,21 @@ namespace xrock_gui_model
             cd.resize(400, 400);
             cd.exec();
         }
-        // Update the edge configuration
-        edge["configuration"] = config;
-        bagelGui->updateEdgeMap(name, edge);
+        // Update the edge configuration; the edge is only copied if the configuration changed
+        edgePtr = bagelGui->getEdgeMap(name);
+        if (edgePtr && !ConfigMapHelper::equals(loadedConfig, config))
+        {
+            ConfigMap edge = *edgePtr;
+            edge["configuration"] = config;
+            bagelGui->updateEdgeMap(name, edge);
+        }
     }
 
     void XRockGUI::openConfigFile(const std::string &name)
     {
-        ConfigMap node = *(bagelGui->getNodeMap(name));
-        ConfigMap config;
+        const ConfigMap *node = bagelGui->getNodeMap(name);
+        if (!node)
+            return;
         // check for selected bundle
         char *envs = getenv("ROCK_BUNDLE");
         if (envs)
@@ -1243,7 +1367,7 @@ namespace xrock_gui_model
             {
                 std::string bundlePath = envs;
                 // only if both is set we continue
-                std::string configFile = node["model"]["name"];
+                std::string configFile = ConfigMapHelper::getString(*node, modelNamePath);
                 configFile += ".yml";
                 std::string path = mars::utils::pathJoin(bundlePath, bundleName);
                 path = mars::utils::pathJoin(path, "config");
@@ -1251,44 +1375,85 @@ namespace xrock_gui_model
                 path = mars::utils::pathJoin(path, configFile);
                 if (mars::utils::pathExists(path))
                 {
-                    printf("found config file: %s\n", path.c_str());
-                    ConfigureDialog cd(NULL, env, node["modelName"], true, true, NULL, NULL, path);
+                    XROCK_LOG(Info, "found config file: " << path);
+                    ConfigureDialog cd(NULL, env, ConfigMapHelper::getString(*node, ConfigPath("modelName")), true, true, NULL, NULL, path);
                     cd.resize(400, 400);
                     cd.exec();
                 }
             }
             else
             {
-                printf("No bundle path set in env: ROCK_BUNDLE_PATH\n");
+                XROCK_LOG(Warning, "no bundle path set in env: ROCK_BUNDLE_PATH");
             }
         }
         else
         {
-            printf("No bundle selected in env: ROCK_BUNDLE\n  Use bundle-sel to select one!\n");
+            XROCK_LOG(Warning, "no bundle selected in env: ROCK_BUNDLE, use bundle-sel to select one");
         }
     }
 
     void XRockGUI::configureComponents(const std::string &name)
     {
-        ConfigMap node = *(bagelGui->getNodeMap(name));
-        ConfigMap config;
-        if(!node.hasKey("configuration"))
+        const ConfigMap *nodePtr = bagelGui->getNodeMap(name);
+        if (!nodePtr)
+            return;
+        ConfigMap node = *nodePtr;
+        // The dialog shows the configuration of the inner nodes defined by the part model, overlaid
+        // by the entries stored in the node. Only the entries which differ from the part model are stored.
+        ConfigMap defaults, config;
+        ComponentModelInterface *model = dynamic_cast<ComponentModelInterface *>(bagelGui->getCurrentModel());
+        if (model)
         {
-            node["configuration"] = ConfigMap();
+            ConfigMap components = model->getInnerComponents(node);
+            if (components.hasKey("configuration") && components["configuration"].hasKey("nodes"))
+            {
+                ConfigVector innerNodes;
+                for (auto &inner : components["configuration"]["nodes"])
+                {
+                    ConfigMap entry;
+                    entry["name"] = inner["name"];
+                    if (inner.hasKey("data"))
+                        entry["data"] = inner["data"];
+                    if (inner.hasKey("submodel"))
+                        entry["submodel"] = inner["submodel"];
+                    innerNodes.push_back(entry);
+                }
+                // The data fields in there may be strings, so the view converts them to ConfigMaps on all assembly levels
+                SubmodelView(innerNodes).unpack(defaults);
+            }
         }
-        if(!node["configuration"].hasKey("submodel"))
+        if (!defaults.hasKey("submodel"))
+            defaults["submodel"] = ConfigVector();
+        ConfigMap stored;
+        if (node.hasKey("configuration") && node["configuration"].hasKey("submodel") &&
+            node["configuration"]["submodel"].isVector())
         {
-            node["configuration"]["submodel"] = ConfigVector();
+            SubmodelView(node["configuration"]["submodel"]).unpack(stored);
         }
-        // Since the data fields in there are strings, we have convert them to ConfigMaps
-        ConfigMapHelper::unpackSubmodel(config, node["configuration"]["submodel"]);
+        config = defaults;
+        if (stored.hasKey("submodel"))
+            SubmodelView::overlay(config["submodel"], stored["submodel"]);
         {
             ConfigureDialog cd(&config, env, node["model"]["name"], true, true);
             cd.resize(400, 400);
             cd.exec();
         }
-        // Afterwards we have to repack them into strings
-        ConfigMapHelper::packSubmodel(node["configuration"], config["submodel"]);
+        ConfigVector changed;
+        SubmodelView::diff(config["submodel"], defaults["submodel"], changed);
+        // The node is only updated if the stored entries change
+        ConfigMap changedMap;
+        changedMap["submodel"] = changed;
+        if (stored.hasKey("submodel") ? ConfigMapHelper::equals(changedMap, stored) : changed.empty())
+            return;
+        if (changed.empty())
+        {
+            ConfigMap &configuration = node["configuration"];
+            configuration.erase("submodel");
+        }
+        else
+        {
+            node["configuration"]["submodel"] = changed;
+        }
         bagelGui->updateNodeMap(name, node);
     }
 
@@ -1310,7 +1475,7 @@ namespace xrock_gui_model
         if (portType != "outputs" &&
             portType != "inputs")
         {
-            std::cout << "XRockGUI::openConfigureInterfaceDialog: wrong portType!" << std::endl;
+            XROCK_LOG(Error, "XRockGUI::openConfigureInterfaceDialog: wrong portType " << portType);
             return;
         }
         ConfigMap node = *(bagelGui->getNodeMap(nodeName));
@@ -1328,7 +1493,7 @@ namespace xrock_gui_model
                 {
                     if (bagelType)
                     {
-                        std::cerr << "configure bagel port" << std::endl;
+                        XROCK_LOG(Debug, "configure bagel port");
                         std::vector<std::string> keys = {"configuration", "data", "interfaces", contextPortName};
                         subMap = ConfigMapHelper::getSubItem(node, keys);
                         if (portType == "inputs" and subMap and subMap->isMap())
@@ -1342,7 +1507,7 @@ namespace xrock_gui_model
                         else if(node["model"]["versions"][0].hasKey("defaultConfiguration"))
                         {
                             ConfigMap &defaultConfig = node["model"]["versions"][0]["defaultConfiguration"];
-                            if(defaultConfig.hasKey("data") && defaultConfig["data"].hasKey("interfaces"))
+                            if(BasicModelHelper::decodeData(defaultConfig) && defaultConfig["data"].hasKey("interfaces"))
                             {
                                 for(auto &[key, value]: (ConfigMap)defaultConfig["data"]["interfaces"])
                                 {
@@ -1370,7 +1535,7 @@ namespace xrock_gui_model
                         if(node["model"]["versions"][0].hasKey("defaultConfiguration"))
                         {
                             ConfigMap &defaultConfig = node["model"]["versions"][0]["defaultConfiguration"];
-                            if(defaultConfig.hasKey("data") && defaultConfig["data"].hasKey("interfaces"))
+                            if(BasicModelHelper::decodeData(defaultConfig) && defaultConfig["data"].hasKey("interfaces"))
                             {
                                 for(auto &[key, value]: (ConfigMap)defaultConfig["data"]["interfaces"])
                                 {
@@ -1452,10 +1617,12 @@ namespace xrock_gui_model
                     edgeList.push_back(it);
                 }
             }
-            ConfigMap node = *(bagelGui->getNodeMap(versionChangeName));
+            const ConfigMap *node = bagelGui->getNodeMap(versionChangeName);
+            if (!node)
+                return;
+            std::string domain = ConfigMapHelper::getString(*node, modelDomainPath);
+            std::string name = ConfigMapHelper::getString(*node, modelNamePath);
             bagelGui->removeNode(versionChangeName);
-            std::string domain = node["model"]["domain"];
-            std::string name = node["model"]["name"];
             std::string versionName = version;
             std::string type = model->deriveTypeFrom(domain, name, version);
             if (!model->hasNodeInfo(type))
@@ -1472,231 +1639,145 @@ namespace xrock_gui_model
         }
     }
 
-    void trimMap(ConfigItem &item)
+    void XRockGUI::exportCnd(const configmaps::ConfigMap &map_,
+                             const std::string &filename, const std::string &urdf_file)
     {
-        if (item.isMap())
+        ComponentModelInterface *model = dynamic_cast<ComponentModelInterface *>(bagelGui->getCurrentModel());
+        if (!model)
+            return;
+        // The export works on the model in memory; the part models are taken from the registered ones
+        ConfigMap map = model->getModelInfo();
+        CndExporter &exporter = getCndExporter(model, map.hasKey("name") ? map["name"].getString() : std::string());
+        bool exported;
         {
-            ConfigMap::iterator it = item.beginMap();
-            while (it != item.endMap())
-            {
-                if (it->second.isAtom())
-                {
-                    std::string value = mars::utils::trim(it->second.toString());
-                    if (value.empty())
-                    {
-                        item.erase(it);
-                        it = item.beginMap();
-                    }
-                    else
-                    {
-                        ++it;
-                    }
-                }
-                else if (it->second.isMap() || it->second.isVector())
-                {
-                    // todo: handle empty map
-                    trimMap(it->second);
-                    if (it->second.size() == 0)
-                    {
-                        item.erase(it);
-                        it = item.beginMap();
-                    }
-                    else
-                    {
-                        ++it;
-                    }
-                }
-                else
-                {
-                    item.erase(it);
-                    it = item.beginMap();
-                }
-            }
+            WaitCursorRAII _;
+            const auto start = std::chrono::steady_clock::now();
+            exported = exporter.exportCnd(map, filename, urdf_file);
+            XROCK_LOG(Info, "export cnd " << filename << ": "
+                      << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << " ms");
         }
-        else if (item.isVector())
-        {
+        if (exported)
+            QMessageBox::information(nullptr, "Export", "Successfully exported", QMessageBox::Ok);
+        else
+            QMessageBox::critical(nullptr, "Export", QString::fromStdString("Failed to export cnd: " + exporter.getError()), QMessageBox::Ok);
+    }
 
-            ConfigVector::iterator it = item.begin();
-            while (it != item.end())
-            {
-                if (it->isAtom())
-                {
-                    std::string value = mars::utils::trim(it->toString());
-                    if (value.empty())
-                    {
-                        item.erase(it);
-                        it = item.begin();
-                    }
-                    else
-                    {
-                        ++it;
-                    }
-                }
-                else if (it->isMap() || it->isVector())
-                {
-                    trimMap(*it);
-                    if (it->size() == 0)
-                    {
-                        item.erase(it);
-                        it = item.begin();
-                    }
-                    else
-                    {
-                        ++it;
-                    }
-                }
-                else
-                {
-                    item.erase(it);
-                    it = item.begin();
-                }
-            }
+    void XRockGUI::exportCndPartitions(const std::string &folder, const std::string &partitionKey)
+    {
+        ComponentModelInterface *model = dynamic_cast<ComponentModelInterface *>(bagelGui->getCurrentModel());
+        if (!model)
+            return;
+        ConfigMap map = model->getModelInfo();
+        CndExporter &exporter = getCndExporter(model, map.hasKey("name") ? map["name"].getString() : std::string());
+        bool exported;
+        {
+            WaitCursorRAII _;
+            const auto start = std::chrono::steady_clock::now();
+            exported = exporter.exportPartitions(map, folder, partitionKey);
+            XROCK_LOG(Info, "export cnd partitions " << folder << ": "
+                      << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << " ms");
         }
+        if (exported)
+            QMessageBox::information(nullptr, "Export", "Successfully exported", QMessageBox::Ok);
+        else
+            QMessageBox::critical(nullptr, "Export", QString::fromStdString("Failed to export cnd partitions: " + exporter.getError()), QMessageBox::Ok);
     }
 
-    void XRockGUI::exportCnd(const configmaps::ConfigMap &map_,
-                             const std::string &filename, const std::string &urdf_file)
+    CndExporter &XRockGUI::getCndExporter(ComponentModelInterface *model, const std::string &modelName)
     {
-        // ask user to pick a urdf file
+        std::unique_ptr<CndExporter> &exporter = cndExporters[modelName];
+        CndExporter::ModelResolver resolver = [model](const std::string &domain, const std::string &name, const std::string &version)
+        { return model->getPartModel(domain, name, version); };
+        if (!exporter)
+            exporter.reset(new CndExporter(resolver));
+        else
+            exporter->setResolver(resolver);
+        // unchanged nodes and part models are detected by their revision instead of hashing their content
+        exporter->setRevisions([model](const std::string &name)
+                               { return model->getNodeRevision(name); },
+                               [model](const std::string &domain, const std::string &name, const std::string &version)
+                               { return model->getPartModelRevision(domain, name, version); });
+        return *exporter;
+    }
 
-        ConfigMap map = bagelGui->getCurrentModel()->getModelInfo();
-        std::stringstream cnd_export;
-        cnd_export << "xrock-export-cnd -m " << map["name"].getString()
-                   << " -v " << map["versions"][0]["name"].getString()
-                   << " -o " << filename;
-        if (!urdf_file.empty())
-        {
-            cnd_export << " -t --tf_enhance -u " << urdf_file;
-        }
-        cnd_export << " -b " << (std::string)env["dbType"];
-        if (env["dbType"] == "Serverless")
-        {
-            cnd_export << " --db_address " << toolbarBackend->getDbPath();
-        }
-        else if (env["dbType"] == "Client")
+    void XRockGUI::createDeployment(const std::string &folder)
+    {
+        ComponentModelInterface *model = dynamic_cast<ComponentModelInterface *>(bagelGui->getCurrentModel());
+        if (!model)
+            return;
+        // The deployment is created from the cnd of the model in memory; no cnd file is read
+        ConfigMap map = model->getModelInfo();
+        const std::string modelName = map.hasKey("name") ? map["name"].getString() : std::string();
+        const std::string projectName = modelName.empty() ? "deployment" : modelName;
+        CndExporter &exporter = getCndExporter(model, modelName);
+        DeploymentGenerator generator;
+        ConfigMap cnd;
+        std::string error;
         {
-            cnd_export << " --db_address " << toolbarBackend->getDbAddress();  
-        }
-        cnd_export << " --db_graph " <<  toolbarBackend->getGraph();
-      
-        int ret = std::system(cnd_export.str().c_str());
-        if (ret == EXIT_SUCCESS)
-            QMessageBox::information(nullptr, "Export", "Successfully exported", QMessageBox::Ok);
+            WaitCursorRAII _;
+            const auto start = std::chrono::steady_clock::now();
+            if (!exporter.createCnd(map, cnd))
+                error = exporter.getError();
+            else if (!generator.generate(cnd, projectName + ".cnd", folder))
+                error = generator.getError();
+            XROCK_LOG(Info, "create deployment " << folder << ": "
+                      << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count() << " ms");
+        }
+        if (error.empty())
+            QMessageBox::information(nullptr, "Export", "Successfully created deployment", QMessageBox::Ok);
         else
-            QMessageBox::critical(nullptr, "Export", QString::fromStdString("Failed to export cnd with code: " + std::to_string(ret)), QMessageBox::Ok);
+            QMessageBox::critical(nullptr, "Export", QString::fromStdString("Failed to create deployment: " + error), QMessageBox::Ok);
     }
 
     // this function runs the executable of python abstract gui which helps to perform implements relation
     void XRockGUI::runAbstractGui()
     {
-        std::stringstream abstract_gui;
-        abstract_gui << "abstract_gui_cli --backend " << (std::string)env["dbType"] ;
-
+        JobRunner::Command command;
+        command.name = "abstract_gui";
+        command.program = "abstract_gui_cli";
+        // the gui keeps running, so it must not block other jobs
+        command.limited = false;
+        command.args = {"--backend", env["dbType"].getString()};
         if (env["dbType"] == "Serverless")
         {
-            abstract_gui << " --path " << toolbarBackend->getDbPath();
-            abstract_gui << " --graph " <<  toolbarBackend->getGraph();
+            command.args.insert(command.args.end(), {"--path", toolbarBackend->getDbPath(), "--graph", toolbarBackend->getGraph()});
         }
         else if (env["dbType"] == "Client")
         {
-            abstract_gui << " --url " << toolbarBackend->getDbAddress();  
-        abstract_gui << " --graph " <<  toolbarBackend->getGraph();
+            command.args.insert(command.args.end(), {"--url", toolbarBackend->getDbAddress(), "--graph", toolbarBackend->getGraph()});
         }
         else if (env["dbType"] == "MultiDbClient")
         {
-            std::string multidb_config_path = bagelGui->getConfigDir() + "/MultiDBConfig.yml";
-            abstract_gui << " --multi_db_config_path " <<  multidb_config_path;  
+            command.args.insert(command.args.end(), {"--multi_db_config_path", bagelGui->getConfigDir() + "/MultiDBConfig.yml"});
         }
-        abstract_gui << " &";
-        std::cout << "CMD: " << abstract_gui.str() << std::endl;
-        std::system(abstract_gui.str().c_str());
+        jobRunner->run(command);
+    }
+
+    const std::string &XRockGUI::getDescriptionHtml(const std::string &key, const std::string &markdown)
+    {
+        // the hash detects changed descriptions of the same version (e.g. edited in a local db)
+        const size_t hash = std::hash<std::string>()(markdown);
+        std::pair<size_t, std::string> *entry = descriptionCache.find(key);
+        if (entry && entry->first == hash)
+            return entry->second;
+        return descriptionCache.insert(key, std::make_pair(hash, MarkdownRenderer::toHtml(markdown))).second;
     }
 
     void XRockGUI::importCND(const std::string &fileName)
     {
         ConfigMap map;
-        ConfigMap cnd = ConfigMap::fromYamlFile(fileName);
-        std::string name = fileName;
-        mars::utils::removeFilenamePrefix(&name);
-        mars::utils::removeFilenameSuffix(&name);
-        map["name"] = name;
-        map["domain"] = "SOFTWARE";
-        map["type"] = "CND";
-        map["versions"][0]["name"] = "v0.0.1";
-        map["versions"][0]["projectName"] = "";
-        map["versions"][0]["designedBy"] = "";
-        map["versions"][0]["date"] = QDateTime::currentDateTime().toString(Qt::ISODate).toStdString();
-        map["versions"][0]["components"]["nodes"] = ConfigVector();
-        map["versions"][0]["components"]["edges"] = ConfigVector();
-        map["versions"][0]["data"]["gui"] = ConfigMap();
-
-        std::map<std::string, std::pair<int, int>> nodePositions;
-        int minX = 0;
-        int minY = 0;
-        int maxX = 2000;
-        int maxY = 2000;
-        for (auto it : (ConfigMap)cnd["tasks"])
-        {
-            int x = rand() % (maxX - minX) + minX;
-            int y = rand() % (maxY - minY) + minY;
-            nodePositions[it.first.c_str()] = std::make_pair(x, y);
-
-            std::cerr << "task name: " << it.first.c_str() << std::endl;
-            ConfigMap node;
-            node["name"] = it.first.c_str();
-            node["model"]["domain"] = "SOFTWARE";
-            node["model"]["version"] = "v0.0.1";
-            node["model"]["name"] = it.second["type"];
-            map["versions"][0]["components"]["nodes"].push_back(node);
-            ConfigMap config;
-            config["data"] = it.second.toYamlString();
-            config["name"] = node["name"];
-            map["versions"][0]["components"]["configuration"]["nodes"].push_back(config);
-        }
-        if (cnd.hasKey("connections"))
-        {
-            // Iterate through the connections and create edges
-            for (auto &connection : (ConfigMap)cnd["connections"])
-            {
-                ConfigMap edge;
-                ConfigMap newFromSection;
-                ConfigMap fromSection = connection.second["from"];
-                newFromSection["domain"] = "SOFTWARE";
-                newFromSection["interface"] = fromSection["port_name"];
-                newFromSection["name"] = fromSection["task_id"];
-                edge["from"] = newFromSection;
-                edge["data"] = connection.second["data"];
-                edge["name"] = connection.first;
-                ConfigMap newToSection;
-                ConfigMap toSection = connection.second["to"];
-                newToSection["domain"] = "SOFTWARE";
-                newToSection["interface"] = toSection["port_name"];
-                newToSection["name"] = toSection["task_id"];
-                edge["to"] = newToSection;
-                // Push the edge into the "edges" array
-                map["versions"][0]["components"]["edges"].push_back(edge);
-            }
-        }
-
-        ConfigMap &guiData = map["versions"][0]["data"]["gui"];
-        for (const auto &it : nodePositions)
+        CndImporter importer;
         {
-            const std::string &nodeName = it.first;
-            int x = it.second.first;
-            int y = it.second.second;
-
-            if (!guiData["layouts"]["software"].hasKey(nodeName))
+            WaitCursorRAII _;
+            auto start = std::chrono::steady_clock::now();
+            if (!importer.importCnd(fileName, map))
             {
-                // Create a layout entry if it doesn't exist
-                guiData["layouts"]["software"][nodeName] = ConfigMap();
+                QMessageBox::critical(nullptr, "Error", QString::fromStdString(importer.getError()), QMessageBox::Ok);
+                return;
             }
-
-            guiData["layouts"]["software"][nodeName]["x"] = std::to_string(x);
-            guiData["layouts"]["software"][nodeName]["y"] = std::to_string(y);
+            XROCK_LOG(Info, "parsed " << fileName << " in "
+                      << std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - start).count() << " ms");
         }
-        // TODO: The next lines have to be refactored
-        map["modelPath"] = mars::utils::getPathOfFile(fileName);
-        map.toYamlFile("da.yml");
         loadComponentModelFrom(map);
     }
 
@@ -1731,27 +1812,35 @@ namespace xrock_gui_model
         }
         else if (name == "open model")
         {
-            ConfigMap node = *(bagelGui->getNodeMap(contextNodeName));
-            std::string domain = node["model"]["domain"];
-            std::string model_name = node["model"]["name"];
-            std::string version = node["model"]["versions"][0]["name"];
-            loadComponentModel(domain, model_name, version); 
+            const ConfigMap *node = bagelGui->getNodeMap(contextNodeName);
+            if (!node)
+                return;
+            std::string domain = ConfigMapHelper::getString(*node, modelDomainPath);
+            std::string model_name = ConfigMapHelper::getString(*node, modelNamePath);
+            std::string version = ConfigMapHelper::getString(*node, modelVersionPath);
+            loadComponentModel(domain, model_name, version);
         }
         // TODO: We should add a property called 'description' to the xtypes
         else if (name == "show description")
         {
-            ConfigMap node = *(bagelGui->getNodeMap(contextNodeName));
-            std::string domain = node["model"]["domain"];
-            std::string version = node["model"]["versions"][0]["name"];
-            std::string model_name = node["model"]["name"];
-            QWebView *doc = new QWebView();
-            doc->page()->setLinkDelegationPolicy(QWebPage::DelegateAllLinks);
-            widget->connect(doc, SIGNAL(linkClicked(const QUrl &)), widget, SLOT(openUrl(const QUrl &)));
+            const ConfigMap *node = bagelGui->getNodeMap(contextNodeName);
+            if (!node)
+                return;
+            std::string domain = ConfigMapHelper::getString(*node, modelDomainPath);
+            std::string version = ConfigMapHelper::getString(*node, modelVersionPath);
+            std::string model_name = ConfigMapHelper::getString(*node, modelNamePath);
+            if (!descriptionView)
+            {
+                descriptionView = new QWebView();
+                descriptionView->page()->setLinkDelegationPolicy(QWebPage::DelegateAllLinks);
+                widget->connect(descriptionView, SIGNAL(linkClicked(const QUrl &)), widget, SLOT(openUrl(const QUrl &)));
+            }
             ConfigMap modelMap;
             {
                 WaitCursorRAII _;
                 modelMap = db->requestModel(domain, model_name, version, true);
             }
+            std::string html;
             if (modelMap["versions"][0].hasKey("data"))
             {
                 {
@@ -1765,12 +1854,15 @@ namespace xrock_gui_model
                         if (dataMap["description"].hasKey("markdown"))
                         {
                             std::string md = dataMap["description"]["markdown"];
-                            doc->setHtml(getHtml2(md).c_str());
+                            html = getDescriptionHtml(domain + "/" + model_name + "/" + version, md);
                         }
                     }
                 }
             }
-            doc->show();
+            descriptionView->setWindowTitle(QString::fromStdString(model_name + " " + version));
+            descriptionView->setHtml(QString::fromStdString(html));
+            descriptionView->show();
+            descriptionView->raise();
         }
         else if (name == "apply configuration")
         {
@@ -1838,18 +1930,20 @@ namespace xrock_gui_model
     std::vector<std::string> XRockGUI::getNodeContextStrings(const std::string &name)
     {
         // Get the node map to show context dependent on node properties (see below)
-        ConfigMap map = *(bagelGui->getNodeMap(name));
+        const ConfigMap *map = bagelGui->getNodeMap(name);
         std::vector<std::string> r;
+        if (!map)
+            return r;
         r.push_back("change version");
         r.push_back("configure node");
         // Make configure nodes only visible if the component actually has inner parts
-        if (map["model"]["versions"][0].hasKey("components") && map["model"]["versions"][0]["components"].hasKey("nodes"))
+        if (BasicModelHelper::nodeHasComponents(*map))
         {
             r.push_back("configure components");
         }
         r.push_back("reset configuration");
         // Only software nodes can have a ROCK config file and can have 'apply configuration'
-        if (map["model"]["domain"] == "SOFTWARE")
+        if (ConfigMapHelper::getString(*map, modelDomainPath) == "SOFTWARE")
         {
             r.push_back("open ROCK config file");
             r.push_back("apply configuration");
@@ -1880,8 +1974,8 @@ namespace xrock_gui_model
         contextPortName = portName;
         std::vector<std::string> r;
         r.push_back("configure interface");
-        ConfigMap node = *(bagelGui->getNodeMap(nodeName));
-        std::string type = node["xrock_type"];
+        const ConfigMap *node = bagelGui->getNodeMap(nodeName);
+        std::string type = node ? ConfigMapHelper::getString(*node, ConfigPath("xrock_type")) : "";
         if (matchPattern("bagel::*", type))
         {
             r.push_back("SUM merge");
@@ -1915,77 +2009,66 @@ namespace xrock_gui_model
         ConfigMap modelMap = model->getModelInfo();
         std::string modelName = modelMap["name"].getString() + "_" + modelMap["versions"][0]["name"].getString();
 
-        versionChangeName << map["name"];
+        std::string nodeName = map["name"];
         if(map.hasKey("alias") and map["alias"] != "")
         {
-            versionChangeName << map["alias"];
+            nodeName << map["alias"];
         }
-        std::string configFile = "temp_task_config.yml";
-        std::string modelFile = map["model"]["name"].getString()+".yml";
-        // 1. get configuration from map
-        // 2. store configuration in temp yaml file
-        std::string cmd = "xrock-resolve-ports";
-#ifdef __APPLE__
-        {
-            std::string c = getenv("AUTOPROJ_CURRENT_ROOT");
-            c += "/install/bin/";
-            cmd = "DYLD_LIBRARY_PATH=$MYLD_LIBRARY_PATH ruby " + c + cmd;
-        }
-#endif
+        PortResolver::Request request;
+        request.taskModel = map["model"]["name"].getString();
+        request.taskVersion = map["model"]["versions"][0]["name"].getString();
         if (map.hasKey("configuration") and
             map["configuration"].hasKey("data") and
             map["configuration"]["data"].hasKey("config"))
         {
-            std::string yaml = "--- name:default\n" + map["configuration"]["data"]["config"].toYamlString();
-            std::ofstream file;
-            file.open(configFile);
-            file << yaml;
-            file.close();
-            cmd += " -c " + configFile;
-            cmd += " -o " + modelFile + " ";
-            cmd += map["model"]["name"].getString();
-            cmd += " default";
+            request.config = map["configuration"]["data"]["config"].toYamlString();
         }
         else if (map.hasKey("configuration") and
                  map["configuration"].hasKey("data") and
                  map["configuration"]["data"].hasKey("config_names"))
         {
-            cmd += " -o " + modelFile + " ";
-            cmd += map["model"]["name"].getString();
             for (auto it : map["configuration"]["data"]["config_names"])
             {
-                cmd += " " + (std::string)it;
+                request.configNames.push_back(it);
             }
         }
         else
         {
             return;
         }
-        // 3. execute rock-instantiate -c temp_file.yml -o temp_model.yml modelname default
-        printf("execute: %s\n", cmd.c_str());
-        system(cmd.c_str());
-        // 4. load orogen model as new version of modelname
-        if (!mars::utils::pathExists(modelFile))
+        // The resolver appends a hash of the configuration (see PortResolver::Request::newVersion)
+        request.newVersion = request.taskVersion + "_" + modelName;
+        const char *root = getenv("AUTOPROJ_CURRENT_ROOT");
+        ConfigMap dbConfig = ConfigMap::fromYamlString(env["multiDBConfig"]);
+        request.dbPath = pathJoin(root ? root : "", dbConfig["main_server"]["path"].getString());
+        request.dbGraph = dbConfig["main_server"]["graph"].getString();
+        if (!portResolver)
         {
-            printf("ERROR: executing rock-instantiate\n");
-            return;
+            portResolver.reset(new PortResolver(jobRunner.get()));
         }
-        std::string new_version = map["model"]["versions"][0]["name"].getString() + "_" + modelName;
-        std::string c = getenv("AUTOPROJ_CURRENT_ROOT");
-        ConfigMap dbConfig = ConfigMap::fromYamlString(env["multiDBConfig"]);
-        std::string dbPath = pathJoin(c, dbConfig["main_server"]["path"].getString());
-        std::string dbGraph = dbConfig["main_server"]["graph"];
-        cmd = "xrock-orogen-to-xrock --model_name " + map["model"]["name"].getString() + " --model_file " + modelFile + " --model_version " + new_version + " -a " + dbPath + " -g " + dbGraph;
-#ifdef __APPLE__
-        {
-            c += "/install/bin/";
-            cmd = "DYLD_LIBRARY_PATH=$MYLD_LIBRARY_PATH python " + c + cmd;
-        }
-#endif
-        printf("execute: %s\n", cmd.c_str());
-        system(cmd.c_str());
-        // 5. switch node to new version
-        selectVersion(new_version);
+        // The tools run in the background, the node is switched to the new version once it is in the database.
+        // The result is dropped if the user switched to another model or the node was removed meanwhile.
+        // The model is recognized by its instance id since it may be deleted until the tools are finished.
+        unsigned long nodeId = 0;
+        if (!model->findNodeId(nodeName, nodeId))
+            return;
+        const uint64_t modelId = model->getInstanceId();
+        portResolver->resolve(request, [this, modelId, nodeId, nodeName](bool success, const std::string &result)
+                              {
+            if (!success)
+            {
+                QMessageBox::warning(nullptr, "Warning", QString::fromStdString("Could not apply configuration to " + nodeName + ": " + result), QMessageBox::Ok);
+                return;
+            }
+            ComponentModelInterface *current = dynamic_cast<ComponentModelInterface *>(bagelGui->getCurrentModel());
+            unsigned long currentId = 0;
+            if (!current || current->getInstanceId() != modelId || !current->findNodeId(nodeName, currentId) || currentId != nodeId)
+            {
+                XROCK_LOG(Info, "resolved version " << result << " of " << nodeName << " is not applied, the node is no longer in the current model");
+                return;
+            }
+            versionChangeName = nodeName;
+            selectVersion(result); });
     }
 
     void XRockGUI::cfgUpdateProperty(mars::cfg_manager::cfgPropertyStruct property)
@@ -19,17 +19,24 @@
 #include "ToolbarBackend.hpp"
 #include "XRockIOLibrary.hpp"
 #include "ConfigureDialogLoader.hpp"
+#include "utils/LruCache.hpp"
 
 namespace bagel_gui
 {
     class BagelModel;
 }
 
+class QWebView;
+
 namespace xrock_gui_model
 {
 
     class ComponentModelInterface;
     class ComponentModelEditorWidget;
+    class PortResolver;
+    class JobRunner;
+    class JobLogWidget;
+    class CndExporter;
 
     enum struct MenuActions : int
     {
@@ -62,6 +69,12 @@ namespace xrock_gui_model
         EDIT_LOAD_FRAMES = 38,
         EDIT_LOAD_FRAMES_FROM_SMURF = 39,
         EDIT_STORE_FRAMES = 40,
+        LAYOUT_LAYERED = 41,
+        LAYOUT_FORCE_DIRECTED = 42,
+        TOGGLE_JOB_LOG = 43,
+        EXPORT_DEPLOYMENT = 44,
+        EXPORT_CND_PARTITIONS_BY_HOST = 45,
+        EXPORT_CND_PARTITIONS_BY_DEPLOYMENT = 46,
         BUILD_MODULE_TO_DB = 51,
     };
 
@@ -108,7 +121,14 @@ namespace xrock_gui_model
         void selectVersion(const std::string &version);
         void exportCnd(const configmaps::ConfigMap &map_, const std::string &filename, const std::string &urdf_file = "");
         void importCND(const std::string &fileName);
+        // Writes one cnd per partition of the current model and the partitions.yml manifest into the folder,
+        // partitioned by the given deployment entry (e.g. "hostID") or "deployment"
+        void exportCndPartitions(const std::string &folder, const std::string &partitionKey);
+        // Writes the orogen deployment package of the current model into the folder
+        void createDeployment(const std::string &folder);
         void runAbstractGui();
+        // Returns the html of a model description. The rendered html is cached by the key (domain/name/version).
+        const std::string &getDescriptionHtml(const std::string &key, const std::string &markdown);
 
         // drop down menu functions on nodes and node interfaces
         // these are triggered by right-clicking in the GUI
@@ -159,6 +179,10 @@ namespace xrock_gui_model
         {
             return toolbarBackend;
         }
+        JobRunner *getJobRunner() const
+        {
+            return jobRunner.get();
+        }
 
     private:
         bagel_gui::BagelGui *bagelGui;
@@ -173,6 +197,16 @@ namespace xrock_gui_model
         std::string resourcesPath;
         ToolbarBackend *toolbarBackend;
         std::map<std::string, ConfigureDialogLoader *> configPlugins;
+        // Runs the external tools in the background, shown in the job log dock
+        std::unique_ptr<JobRunner> jobRunner;
+        JobLogWidget *jobLogWidget;
+        // Runs the port resolution of applyConfiguration() and caches its results
+        std::unique_ptr<PortResolver> portResolver;
+        // Rendered model descriptions (hash of the markdown, html) and the view reused to show them
+        LruCache<std::string, std::pair<size_t, std::string>> descriptionCache;
+        QWebView *descriptionView;
+        // The cnd exporters by model name; they keep the state of the last export to redo only changed parts
+        std::map<std::string, std::unique_ptr<CndExporter>> cndExporters;
 
         void loadStartModel();
         void loadModelFromParameter();
@@ -182,6 +216,7 @@ namespace xrock_gui_model
                                           const std::string &portName,
                                           const std::string &portType);
         void configureComponents(const std::string &name);
+        CndExporter &getCndExporter(ComponentModelInterface *model, const std::string &modelName);
 
         // This function creates a new ROCK Task out of an bagel graph
         // TODO: This function is deprecated and should be moved to a script
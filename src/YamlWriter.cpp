@@ -0,0 +1,878 @@
+/**
+ * \file YamlWriter.cpp
+ * \brief Streaming yaml emitter for config map trees
+ **/
+
+#include "YamlWriter.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <ostream>
+#include <regex>
+#include <vector>
+
+using namespace configmaps;
+
+namespace xrock_gui_model
+{
+
+    // Plain scalars which yaml would read as something else than a string
+    static bool isReservedScalar(const std::string &value)
+    {
+        static const char *reserved[] = {"~", "null", "Null", "NULL", "true", "True", "TRUE", "false", "False", "FALSE",
+                                         "yes", "Yes", "YES", "no", "No", "NO", "on", "On", "ON", "off", "Off", "OFF",
+                                         "y", "Y", "n", "N", ".inf", ".Inf", ".INF", "-.inf", "-.Inf", "-.INF",
+                                         ".nan", ".NaN", ".NAN"};
+        for (const char *r : reserved)
+        {
+            if (value == r)
+                return true;
+        }
+        // numbers (also hex/octal notation)
+        const char *begin = value.c_str();
+        char *end;
+        strtod(begin, &end);
+        if (end != begin && *end == '\0')
+            return true;
+        strtol(begin, &end, 0);
+        return end != begin && *end == '\0';
+    }
+
+    // Returns true if the string can be written as plain scalar without changing its meaning
+    static bool isPlainSafe(const std::string &value)
+    {
+        if (value.empty() || value.front() == ' ' || value.back() == ' ')
+            return false;
+        // document markers
+        if (value.compare(0, 3, "---") == 0 || value.compare(0, 3, "...") == 0)
+            return false;
+        if (std::string("-?:,[]{}#&*!|>'\"%@`").find(value.front()) != std::string::npos)
+        {
+            // "-" and "?" and ":" are only indicators if followed by a space
+            if (!(value.size() > 1 && (value.front() == '-' || value.front() == '?' || value.front() == ':') && value[1] != ' '))
+                return false;
+        }
+        for (size_t i = 0; i < value.size(); ++i)
+        {
+            const unsigned char c = value[i];
+            if (c < 0x20 || c == 0x7f)
+                return false;
+            if (c == ':' && (i + 1 == value.size() || value[i + 1] == ' '))
+                return false;
+            if (c == '#' && i > 0 && value[i - 1] == ' ')
+                return false;
+        }
+        return true;
+    }
+
+    std::string YamlWriter::formatString(const std::string &value)
+    {
+        if (isPlainSafe(value) && !isReservedScalar(value))
+            return value;
+        bool needsEscapes = false;
+        for (unsigned char c : value)
+        {
+            if (c < 0x20 || c == 0x7f)
+            {
+                needsEscapes = true;
+                break;
+            }
+        }
+        std::string result;
+        result.reserve(value.size() + 2);
+        if (!needsEscapes)
+        {
+            result += '\'';
+            for (char c : value)
+            {
+                if (c == '\'')
+                    result += '\'';
+                result += c;
+            }
+            result += '\'';
+            return result;
+        }
+        result += '"';
+        for (unsigned char c : value)
+        {
+            switch (c)
+            {
+            case '"':
+                result += "\\\"";
+                break;
+            case '\\':
+                result += "\\\\";
+                break;
+            case '\n':
+                result += "\\n";
+                break;
+            case '\t':
+                result += "\\t";
+                break;
+            case '\r':
+                result += "\\r";
+                break;
+            default:
+                if (c < 0x20 || c == 0x7f)
+                {
+                    char buffer[8];
+                    snprintf(buffer, sizeof(buffer), "\\x%02x", c);
+                    result += buffer;
+                }
+                else
+                {
+                    result += (char)c;
+                }
+            }
+        }
+        result += '"';
+        return result;
+    }
+
+    std::string YamlWriter::formatDouble(double value)
+    {
+        if (std::isnan(value))
+            return ".nan";
+        if (std::isinf(value))
+            return value > 0 ? ".inf" : "-.inf";
+        char buffer[32];
+        // shortest representation which reads back to the same value
+        for (int precision = 15; precision <= 17; ++precision)
+        {
+            snprintf(buffer, sizeof(buffer), "%.*g", precision, value);
+            if (strtod(buffer, NULL) == value)
+                break;
+        }
+        return buffer;
+    }
+
+    std::string YamlWriter::formatScalar(ConfigItem &item)
+    {
+        ConfigAtom &atom = static_cast<ConfigAtom &>(item);
+        switch (atom.getType())
+        {
+        case ConfigAtom::ItemType::STRING_TYPE:
+            return formatString(atom.getString());
+        case ConfigAtom::ItemType::INT_TYPE:
+            return std::to_string(atom.getInt());
+        case ConfigAtom::ItemType::UINT_TYPE:
+            return std::to_string(atom.getUInt());
+        case ConfigAtom::ItemType::ULONG_TYPE:
+            return std::to_string(atom.getULong());
+        case ConfigAtom::ItemType::DOUBLE_TYPE:
+            return formatDouble(atom.getDouble());
+        case ConfigAtom::ItemType::BOOL_TYPE:
+            return atom.getBool() ? "true" : "false";
+        default:
+        {
+            // untyped scalars (e.g. read from yaml) are written as they were read
+            const std::string value = atom.toString();
+            return isPlainSafe(value) ? value : formatString(value);
+        }
+        }
+    }
+
+    // PyYAML compatible output (the yaml 1.1 resolver and the scalar styles of PyYAML's emitter)
+
+    static const size_t pyYamlWidth = 80;
+
+    // Returns the tag PyYAML's resolver assigns to a plain scalar
+    enum class PlainType
+    {
+        String,
+        Null,
+        Bool,
+        Int,
+        Float,
+        Other,
+    };
+
+    static PlainType resolvePlain(const std::string &value)
+    {
+        static const std::regex floatPattern("[-+]?(?:[0-9][0-9_]*)\\.[0-9_]*(?:[eE][-+][0-9]+)?"
+                                             "|\\.[0-9][0-9_]*(?:[eE][-+][0-9]+)?"
+                                             "|[-+]?[0-9][0-9_]*(?::[0-5]?[0-9])+\\.[0-9_]*"
+                                             "|[-+]?\\.(?:inf|Inf|INF)"
+                                             "|\\.(?:nan|NaN|NAN)");
+        static const std::regex intPattern("[-+]?0b[0-1_]+"
+                                           "|[-+]?0[0-7_]+"
+                                           "|[-+]?(?:0|[1-9][0-9_]*)"
+                                           "|[-+]?0x[0-9a-fA-F_]+"
+                                           "|[-+]?[1-9][0-9_]*(?::[0-5]?[0-9])+");
+        static const std::regex timestampPattern("[0-9]{4}-[0-9]{2}-[0-9]{2}"
+                                                 "|[0-9]{4}-[0-9]{1,2}-[0-9]{1,2}(?:[Tt]|[ \\t]+)[0-9]{1,2}:[0-9]{2}:[0-9]{2}"
+                                                 "(?:\\.[0-9]*)?(?:[ \\t]*(?:Z|[-+][0-9]{1,2}(?::[0-9]{2})?))?");
+        if (value.empty() || value == "~" || value == "null" || value == "Null" || value == "NULL")
+            return PlainType::Null;
+        if (value == "<<" || value == "=")
+            return PlainType::Other;
+        static const char *bools[] = {"yes", "Yes", "YES", "no", "No", "NO", "true", "True", "TRUE",
+                                      "false", "False", "FALSE", "on", "On", "ON", "off", "Off", "OFF"};
+        for (const char *b : bools)
+        {
+            if (value == b)
+                return PlainType::Bool;
+        }
+        // numbers and timestamps start with one of these (like the first characters PyYAML registers its resolvers for)
+        if (!std::strchr("-+.0123456789", value[0]))
+            return PlainType::String;
+        if (std::regex_match(value, intPattern))
+            return PlainType::Int;
+        if (std::regex_match(value, floatPattern))
+            return PlainType::Float;
+        if (std::regex_match(value, timestampPattern))
+            return PlainType::Other;
+        return PlainType::String;
+    }
+
+    // Python's repr() of a float as written by PyYAML (e.g. 0.1, 1.0, 1.0e+16, 1.0e-05)
+    static std::string formatPythonFloat(double value)
+    {
+        if (std::isnan(value))
+            return ".nan";
+        if (std::isinf(value))
+            return value > 0 ? ".inf" : "-.inf";
+        if (value == 0.0)
+            return std::signbit(value) ? "-0.0" : "0.0";
+        // shortest digits which read back to the same value
+        char buffer[32];
+        for (int precision = 0; precision < 17; ++precision)
+        {
+            snprintf(buffer, sizeof(buffer), "%.*e", precision, value);
+            if (strtod(buffer, NULL) == value)
+                break;
+        }
+        std::string mantissa = buffer;
+        const size_t e = mantissa.find('e');
+        const int exponent = atoi(mantissa.c_str() + e + 1);
+        mantissa.resize(e);
+        std::string sign;
+        if (mantissa[0] == '-')
+        {
+            sign = "-";
+            mantissa.erase(0, 1);
+        }
+        std::string digits;
+        for (char c : mantissa)
+        {
+            if (c != '.')
+                digits += c;
+        }
+        if (exponent < -4 || exponent >= 16)
+        {
+            char exponentText[8];
+            snprintf(exponentText, sizeof(exponentText), "e%+03d", exponent);
+            return sign + digits.substr(0, 1) + "." + (digits.size() > 1 ? digits.substr(1) : "0") + exponentText;
+        }
+        if (exponent < 0)
+            return sign + "0." + std::string(-exponent - 1, '0') + digits;
+        if (digits.size() <= (size_t)exponent + 1)
+            return sign + digits + std::string(exponent + 1 - digits.size(), '0') + ".0";
+        return sign + digits.substr(0, exponent + 1) + "." + digits.substr(exponent + 1);
+    }
+
+    // The value of an int or float scalar in yaml 1.1 notation (underscores, sign, base prefixes, base 60)
+    static std::string normalizeNumber(std::string value, PlainType type)
+    {
+        value.erase(std::remove(value.begin(), value.end(), '_'), value.end());
+        std::string sign;
+        if (value[0] == '-' || value[0] == '+')
+        {
+            if (value[0] == '-')
+                sign = "-";
+            value.erase(0, 1);
+        }
+        if (type == PlainType::Float)
+        {
+            std::transform(value.begin(), value.end(), value.begin(), ::tolower);
+            if (value == ".nan")
+                return ".nan";
+            if (value == ".inf")
+                return sign + ".inf";
+            double result = 0.0;
+            // base 60 (e.g. 1:30.5); the last part carries the fraction
+            const char *part = value.c_str();
+            char *end;
+            while (true)
+            {
+                result = result * 60.0 + strtod(part, &end);
+                if (*end != ':')
+                    break;
+                part = end + 1;
+            }
+            return formatPythonFloat(sign.empty() ? result : -result);
+        }
+        unsigned long long result = 0;
+        if (value == "0")
+            return "0";
+        else if (value.compare(0, 2, "0b") == 0)
+            result = strtoull(value.c_str() + 2, NULL, 2);
+        else if (value.compare(0, 2, "0x") == 0)
+            result = strtoull(value.c_str() + 2, NULL, 16);
+        else if (value[0] == '0')
+            result = strtoull(value.c_str(), NULL, 8);
+        else if (value.find(':') != std::string::npos)
+        {
+            const char *part = value.c_str();
+            char *end;
+            while (true)
+            {
+                result = result * 60 + strtoull(part, &end, 10);
+                if (*end != ':')
+                    break;
+                part = end + 1;
+            }
+        }
+        else
+            return sign + value; // arbitrary length like python's int
+        return result == 0 ? "0" : sign + std::to_string(result);
+    }
+
+    struct ScalarAnalysis
+    {
+        bool empty;
+        bool multiline;
+        bool allowBlockPlain;
+        bool allowSingleQuoted;
+    };
+
+    static bool isPyYamlSpace(char c)
+    {
+        return c == '\0' || c == ' ' || c == '\t' || c == '\r' || c == '\n';
+    }
+
+    // PyYAML's Emitter.analyze_scalar() for the block context. Non ascii characters count as special
+    // characters (allow_unicode is off by default), so they are only written in double quotes.
+    static ScalarAnalysis analyzeScalar(const std::string &value)
+    {
+        if (value.empty())
+            return ScalarAnalysis{true, false, true, true};
+        bool indicators = value.compare(0, 3, "---") == 0 || value.compare(0, 3, "...") == 0;
+        bool lineBreaks = false, special = false;
+        bool leadingSpace = false, leadingBreak = false, trailingSpace = false, trailingBreak = false;
+        bool breakSpace = false, spaceBreak = false;
+        bool previousSpace = false, previousBreak = false;
+        bool precededBySpace = true;
+        bool followedBySpace = value.size() == 1 || isPyYamlSpace(value[1]);
+        const size_t last = value.size() - 1;
+        for (size_t i = 0; i < value.size(); ++i)
+        {
+            const unsigned char c = value[i];
+            if (i == 0)
+            {
+                if (std::strchr("#,[]{}&*!|>'\"%@`", c))
+                    indicators = true;
+                if ((c == '?' || c == ':' || c == '-') && followedBySpace)
+                    indicators = true;
+            }
+            else
+            {
+                if (c == ':' && followedBySpace)
+                    indicators = true;
+                if (c == '#' && precededBySpace)
+                    indicators = true;
+            }
+            if (c == '\n')
+                lineBreaks = true;
+            else if (c < 0x20 || c > 0x7e)
+                special = true;
+            if (c == ' ')
+            {
+                leadingSpace |= i == 0;
+                trailingSpace |= i == last;
+                breakSpace |= previousBreak;
+                previousSpace = true;
+                previousBreak = false;
+            }
+            else if (c == '\n')
+            {
+                leadingBreak |= i == 0;
+                trailingBreak |= i == last;
+                spaceBreak |= previousSpace;
+                previousSpace = false;
+                previousBreak = true;
+            }
+            else
+            {
+                previousSpace = previousBreak = false;
+            }
+            precededBySpace = isPyYamlSpace(c);
+            followedBySpace = i + 2 >= value.size() || isPyYamlSpace(value[i + 2]);
+        }
+        ScalarAnalysis analysis{false, lineBreaks, true, true};
+        if (leadingSpace || leadingBreak || trailingSpace || trailingBreak || lineBreaks || indicators)
+            analysis.allowBlockPlain = false;
+        if (breakSpace || spaceBreak || special)
+            analysis.allowBlockPlain = analysis.allowSingleQuoted = false;
+        return analysis;
+    }
+
+    // Decodes utf-8; invalid bytes are taken as latin-1 characters
+    static std::vector<uint32_t> decodeUtf8(const std::string &value)
+    {
+        std::vector<uint32_t> result;
+        result.reserve(value.size());
+        for (size_t i = 0; i < value.size();)
+        {
+            const unsigned char c = value[i];
+            size_t length = c >= 0xf0 && c < 0xf8 ? 4 : c >= 0xe0 ? 3 : c >= 0xc0 ? 2 : 1;
+            uint32_t code = length == 4 ? c & 0x07 : length == 3 ? c & 0x0f : length == 2 ? c & 0x1f : c;
+            bool valid = c < 0x80 || (length > 1 && i + length <= value.size());
+            for (size_t k = 1; valid && k < length; ++k)
+            {
+                const unsigned char next = value[i + k];
+                valid = (next & 0xc0) == 0x80;
+                code = (code << 6) | (next & 0x3f);
+            }
+            if (!valid)
+            {
+                code = c;
+                length = 1;
+            }
+            result.push_back(code);
+            i += length;
+        }
+        return result;
+    }
+
+    static std::string escapeCharacter(uint32_t c)
+    {
+        switch (c)
+        {
+        case 0x00: return "\\0";
+        case 0x07: return "\\a";
+        case 0x08: return "\\b";
+        case 0x09: return "\\t";
+        case 0x0a: return "\\n";
+        case 0x0b: return "\\v";
+        case 0x0c: return "\\f";
+        case 0x0d: return "\\r";
+        case 0x1b: return "\\e";
+        case '"': return "\\\"";
+        case '\\': return "\\\\";
+        case 0x85: return "\\N";
+        case 0xa0: return "\\_";
+        case 0x2028: return "\\L";
+        case 0x2029: return "\\P";
+        }
+        char buffer[16];
+        if (c <= 0xff)
+            snprintf(buffer, sizeof(buffer), "\\x%02X", c);
+        else if (c <= 0xffff)
+            snprintf(buffer, sizeof(buffer), "\\u%04X", c);
+        else
+            snprintf(buffer, sizeof(buffer), "\\U%08X", c);
+        return buffer;
+    }
+
+    // PyYAML writes keys which are empty, multi line or too long as complex keys: its limit of
+    // 128 characters includes the tag "!!str"
+    static bool isPyYamlSimpleKey(const std::string &key)
+    {
+        if (key.empty())
+            return false;
+        const std::vector<uint32_t> text = decodeUtf8(key);
+        if (text.size() + 5 >= 128)
+            return false;
+        for (uint32_t c : text)
+        {
+            if (c == '\n' || c == 0x85 || c == 0x2028 || c == 0x2029)
+                return false;
+        }
+        return true;
+    }
+
+    void YamlWriter::write(const std::string &text)
+    {
+        out << text;
+        const size_t lineBreak = text.rfind('\n');
+        column = lineBreak == std::string::npos ? column + text.size() : text.size() - lineBreak - 1;
+    }
+
+    void YamlWriter::writeLineIndent(int indent)
+    {
+        write("\n" + std::string(indent * 2, ' '));
+    }
+
+    void YamlWriter::writePyYamlString(const std::string &value, int indent, bool isKey)
+    {
+        // keys are written in simple key context: not folded and never multi line
+        const ScalarAnalysis analysis = analyzeScalar(value);
+        if (!(isKey && (analysis.empty || analysis.multiline)) && analysis.allowBlockPlain &&
+            resolvePlain(value) == PlainType::String)
+        {
+            writePyYamlPlain(value, indent, !isKey);
+        }
+        else if (analysis.allowSingleQuoted && !(isKey && analysis.multiline))
+        {
+            writePyYamlSingleQuoted(value, indent, !isKey);
+        }
+        else
+        {
+            writePyYamlDoubleQuoted(value, indent, !isKey);
+        }
+    }
+
+    // The following functions follow the write_* functions of PyYAML's emitter, including where
+    // long lines are folded: at a single space once the line is longer than the width.
+    void YamlWriter::writePyYamlPlain(const std::string &value, int indent, bool split)
+    {
+        bool spaces = false;
+        size_t start = 0;
+        for (size_t end = 0; end <= value.size(); ++end)
+        {
+            const bool atEnd = end == value.size();
+            const char c = atEnd ? '\0' : value[end];
+            if (spaces)
+            {
+                if (atEnd || c != ' ')
+                {
+                    if (start + 1 == end && column > pyYamlWidth && split)
+                        writeLineIndent(indent);
+                    else
+                        write(value.substr(start, end - start));
+                    start = end;
+                }
+            }
+            else if (atEnd || c == ' ')
+            {
+                write(value.substr(start, end - start));
+                start = end;
+            }
+            spaces = c == ' ';
+        }
+    }
+
+    void YamlWriter::writePyYamlSingleQuoted(const std::string &value, int indent, bool split)
+    {
+        write("'");
+        bool spaces = false, breaks = false;
+        size_t start = 0;
+        for (size_t end = 0; end <= value.size(); ++end)
+        {
+            const bool atEnd = end == value.size();
+            const char c = atEnd ? '\0' : value[end];
+            if (spaces)
+            {
+                if (atEnd || c != ' ')
+                {
+                    if (start + 1 == end && column > pyYamlWidth && split && start != 0 && !atEnd)
+                        writeLineIndent(indent);
+                    else
+                        write(value.substr(start, end - start));
+                    start = end;
+                }
+            }
+            else if (breaks)
+            {
+                if (atEnd || c != '\n')
+                {
+                    // a line break is written as empty line
+                    write(std::string(end - start + 1, '\n') + std::string(indent * 2, ' '));
+                    start = end;
+                }
+            }
+            else if ((atEnd || c == ' ' || c == '\n' || c == '\'') && start < end)
+            {
+                write(value.substr(start, end - start));
+                start = end;
+            }
+            if (c == '\'')
+            {
+                write("''");
+                start = end + 1;
+            }
+            spaces = c == ' ';
+            breaks = c == '\n';
+        }
+        write("'");
+    }
+
+    void YamlWriter::writePyYamlDoubleQuoted(const std::string &value, int indent, bool split)
+    {
+        const std::vector<uint32_t> text = decodeUtf8(value);
+        auto ascii = [&text](size_t start, size_t end)
+        {
+            std::string result;
+            for (size_t i = start; i < end; ++i)
+                result += (char)text[i];
+            return result;
+        };
+        write("\"");
+        size_t start = 0;
+        for (size_t end = 0; end <= text.size(); ++end)
+        {
+            const bool atEnd = end == text.size();
+            const uint32_t c = atEnd ? 0 : text[end];
+            if (atEnd || c == '"' || c == '\\' || c < 0x20 || c > 0x7e)
+            {
+                if (start < end)
+                {
+                    write(ascii(start, end));
+                    start = end;
+                }
+                if (!atEnd)
+                {
+                    write(escapeCharacter(c));
+                    start = end + 1;
+                }
+            }
+            if (end > 0 && end + 1 < text.size() && (c == ' ' || start >= end) &&
+                column + (end > start ? end - start : 0) > pyYamlWidth && split)
+            {
+                // the escaped line break is not part of the value
+                write(ascii(start, end) + "\\");
+                if (start < end)
+                    start = end;
+                writeLineIndent(indent);
+                if (text[start] == ' ')
+                    write("\\");
+            }
+        }
+        write("\"");
+    }
+
+    void YamlWriter::writeScalar(ConfigItem &item, int indent)
+    {
+        if (style == Style::Default)
+        {
+            write(" " + formatScalar(item));
+            return;
+        }
+        write(" ");
+        ConfigAtom &atom = static_cast<ConfigAtom &>(item);
+        if (atom.getType() == ConfigAtom::ItemType::STRING_TYPE)
+        {
+            writePyYamlString(atom.getString(), indent, false);
+            return;
+        }
+        // everything else as PyYAML reads and writes it back
+        const std::string value = atom.getType() == ConfigAtom::ItemType::UNDEFINED_TYPE ? atom.toString() : formatScalar(item);
+        switch (resolvePlain(value))
+        {
+        case PlainType::Null:
+            write("null");
+            break;
+        case PlainType::Bool:
+        {
+            const char c = value[0];
+            write(c == 'y' || c == 'Y' || c == 't' || c == 'T' || value == "on" || value == "On" || value == "ON" ? "true" : "false");
+            break;
+        }
+        case PlainType::Int:
+            write(normalizeNumber(value, PlainType::Int));
+            break;
+        case PlainType::Float:
+            write(normalizeNumber(value, PlainType::Float));
+            break;
+        case PlainType::Other:
+            write(value);
+            break;
+        case PlainType::String:
+            writePyYamlString(value, indent, false);
+            break;
+        }
+    }
+
+    void YamlWriter::writeMapKey(const std::string &key)
+    {
+        if (style == Style::Default)
+            write(formatString(key));
+        else
+            writePyYamlString(key, 0, true);
+        write(":");
+    }
+
+    void YamlWriter::writeIndent(int indent)
+    {
+        for (int i = 0; i < indent; ++i)
+            out.write("  ", 2);
+        column += indent * 2;
+    }
+
+    // Size of the write buffer of writeFile()
+    static const size_t fileBufferSize = 1 << 20;
+
+    bool YamlWriter::writeFile(const std::string &fileName, ConfigMap &map, std::string &error)
+    {
+        return writeFile(fileName, [&map](std::ostream &out)
+                         {
+            YamlWriter writer(out);
+            writer.writeDocument(map); },
+                         error);
+    }
+
+    bool YamlWriter::writeFile(const std::string &fileName, const std::function<void(std::ostream &)> &write,
+                               std::string &error)
+    {
+        const std::string tmpFile = fileName + ".tmp";
+        {
+            // the buffer has to outlive the stream
+            std::vector<char> buffer(fileBufferSize);
+            std::ofstream out;
+            out.rdbuf()->pubsetbuf(buffer.data(), buffer.size());
+            out.open(tmpFile, std::ios::out | std::ios::trunc | std::ios::binary);
+            if (!out)
+            {
+                error = "cannot write " + tmpFile;
+                return false;
+            }
+            write(out);
+            out.flush();
+            if (!out)
+            {
+                out.close();
+                std::remove(tmpFile.c_str());
+                error = "error writing " + tmpFile;
+                return false;
+            }
+        }
+        if (std::rename(tmpFile.c_str(), fileName.c_str()) != 0)
+        {
+            std::remove(tmpFile.c_str());
+            error = "cannot replace " + fileName;
+            return false;
+        }
+        return true;
+    }
+
+    void YamlWriter::writeDocument(ConfigMap &map)
+    {
+        if (map.empty())
+        {
+            write("{}\n");
+            return;
+        }
+        writeMapEntries(map, 0, false);
+    }
+
+    void YamlWriter::writeEntry(const std::string &key, ConfigItem &item, int indent)
+    {
+        writeIndent(indent);
+        writeEntryInline(key, item, indent);
+    }
+
+    void YamlWriter::writeEntryInline(const std::string &key, ConfigItem &item, int indent)
+    {
+        if (style == Style::PyYaml && !isPyYamlSimpleKey(key))
+        {
+            // "? key" and ": value" on the next line
+            write("? ");
+            writePyYamlString(key, indent + 1, false);
+            write("\n");
+            writeIndent(indent);
+            write(":");
+            writeValue(item, indent + 1, true);
+            return;
+        }
+        writeMapKey(key);
+        writeValue(item, indent + 1, false);
+    }
+
+    void YamlWriter::writeKey(const std::string &key, int indent)
+    {
+        writeIndent(indent);
+        writeMapKey(key);
+        write("\n");
+    }
+
+    void YamlWriter::writeSequenceEntry(ConfigItem &item, int indent)
+    {
+        writeIndent(indent);
+        write("-");
+        writeValue(item, indent + 1, true);
+    }
+
+    void YamlWriter::writeValue(ConfigItem &item, int indent, bool inSequence)
+    {
+        if (item.isMap())
+        {
+            ConfigMap &map = item;
+            if (map.empty())
+            {
+                write(" {}\n");
+            }
+            else if (inSequence)
+            {
+                // compact form: the first entry follows the "- "
+                write(" ");
+                writeMapEntries(map, indent, true);
+            }
+            else
+            {
+                write("\n");
+                writeMapEntries(map, indent, false);
+            }
+        }
+        else if (item.isVector())
+        {
+            if (item.size() == 0)
+            {
+                write(" []\n");
+            }
+            else if (style == Style::PyYaml && inSequence)
+            {
+                // compact form "- - a"
+                write(" -");
+                writeValue(item[0], indent + 1, true);
+                for (size_t i = 1; i < item.size(); ++i)
+                    writeSequenceEntry(item[i], indent);
+            }
+            else
+            {
+                write("\n");
+                // PyYAML does not indent sequences in maps
+                writeSequenceEntries(item, style == Style::PyYaml ? indent - 1 : indent);
+            }
+        }
+        else if (item.isAtom())
+        {
+            writeScalar(item, indent);
+            write("\n");
+        }
+        else
+        {
+            write(style == Style::PyYaml ? " null\n" : " ~\n");
+        }
+    }
+
+    void YamlWriter::writeMapEntries(ConfigMap &map, int indent, bool firstInline)
+    {
+        std::vector<ConfigMap::value_type *> entries;
+        entries.reserve(map.size());
+        for (auto &it : map)
+            entries.push_back(&it);
+        if (style == Style::PyYaml)
+        {
+            std::sort(entries.begin(), entries.end(), [](const ConfigMap::value_type *a, const ConfigMap::value_type *b)
+                      { return a->first < b->first; });
+        }
+        bool first = true;
+        for (auto *it : entries)
+        {
+            if (first && firstInline)
+            {
+                writeEntryInline(it->first, it->second, indent);
+            }
+            else
+            {
+                writeEntry(it->first, it->second, indent);
+            }
+            first = false;
+        }
+    }
+
+    void YamlWriter::writeSequenceEntries(ConfigItem &vector, int indent)
+    {
+        for (size_t i = 0; i < vector.size(); ++i)
+        {
+            writeSequenceEntry(vector[i], indent);
+        }
+    }
+
+} // end of namespace xrock_gui_model
@@ -0,0 +1,79 @@
+/**
+ * \file YamlWriter.hpp
+ * \brief Streaming yaml emitter for config map trees
+ **/
+
+#pragma once
+#include <configmaps/ConfigData.h>
+#include <functional>
+#include <iosfwd>
+#include <string>
+
+namespace xrock_gui_model
+{
+
+    // Writes config map trees in yaml block style directly to a stream without building the
+    // document in memory first. The output is deterministic: maps keep their insertion order
+    // and doubles are written with the shortest representation that reads back exactly.
+    class YamlWriter
+    {
+    public:
+        enum class Style
+        {
+            Default,
+            // The output of PyYAML's yaml.dump() with its default settings for the data PyYAML
+            // would read from the Default output: sorted keys, sequences not indented in maps,
+            // scalars resolved with the yaml 1.1 rules, non ascii characters escaped and long
+            // scalars folded after 80 columns.
+            PyYaml,
+        };
+
+        explicit YamlWriter(std::ostream &out, Style style = Style::Default) : out(out), style(style), column(0) {}
+
+        // Writes the map as a complete yaml document
+        void writeDocument(configmaps::ConfigMap &map);
+        // Writes "key:" and the block of the item at the given indentation level.
+        // Successive calls stream the entries of a map without holding the whole map.
+        void writeEntry(const std::string &key, configmaps::ConfigItem &item, int indent = 0);
+        // Writes "key:" of a map entry whose entries follow with indent + 1
+        void writeKey(const std::string &key, int indent = 0);
+        // Writes the entry of a sequence at the given indentation level
+        void writeSequenceEntry(configmaps::ConfigItem &item, int indent = 0);
+
+        // Streams the map as a yaml document through a large write buffer into fileName.tmp, which
+        // replaces fileName once it is complete; peak memory stays at the size of the map tree
+        static bool writeFile(const std::string &fileName, configmaps::ConfigMap &map, std::string &error);
+        // The same for content written by the function (e.g. entries formatted before)
+        static bool writeFile(const std::string &fileName, const std::function<void(std::ostream &)> &write,
+                              std::string &error);
+
+        // Returns the yaml representation of an atom (quoted if needed)
+        static std::string formatScalar(configmaps::ConfigItem &item);
+        static std::string formatString(const std::string &value);
+        static std::string formatDouble(double value);
+
+    private:
+        void write(const std::string &text);
+        void writeIndent(int indent);
+        void writeMapKey(const std::string &key);
+        // Writes key and value of a map entry at the current position
+        void writeEntryInline(const std::string &key, configmaps::ConfigItem &item, int indent);
+        void writeScalar(configmaps::ConfigItem &item, int indent);
+        // Writes a string in the style PyYAML chooses; continuation lines of folded scalars are indented by indent
+        void writePyYamlString(const std::string &value, int indent, bool isKey);
+        void writePyYamlPlain(const std::string &value, int indent, bool split);
+        void writePyYamlSingleQuoted(const std::string &value, int indent, bool split);
+        void writePyYamlDoubleQuoted(const std::string &value, int indent, bool split);
+        void writeLineIndent(int indent);
+        // Writes the value after "key:" or "- " (a scalar, flow form of an empty container or a new line and the block)
+        void writeValue(configmaps::ConfigItem &item, int indent, bool inSequence);
+        void writeMapEntries(configmaps::ConfigMap &map, int indent, bool firstInline);
+        void writeSequenceEntries(configmaps::ConfigItem &vector, int indent);
+
+        std::ostream &out;
+        Style style;
+        // column of the current line (needed to fold long scalars)
+        size_t column;
+    };
+
+} // end of namespace xrock_gui_model
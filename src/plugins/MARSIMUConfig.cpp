@@ -1,4 +1,5 @@
 #include "MARSIMUConfig.hpp"
+#include "../Logger.hpp"
 #include <mars/config_map_gui/DataWidget.h>
 #include <mars/utils/misc.h>
 
@@ -190,7 +191,7 @@ namespace xrock_gui_model
                     if (path.back() != '/')
                         path += "/";
                     path += type + ".yml";
-                    std::cerr << "check for config file: " << path.c_str() << std::endl;
+                    XROCK_LOG(Debug, "check for config file: " << path);
                     if (mars::utils::pathExists(path))
                     {
                         configFileName = path;
@@ -294,7 +295,7 @@ namespace xrock_gui_model
                 }
                 catch (...)
                 {
-                    std::cerr << "Error converting config into yaml map!" << std::endl;
+                    XROCK_LOG(Error, "could not convert the config into a yaml map");
                 }
             }
         }
@@ -367,7 +368,7 @@ namespace xrock_gui_model
                     }
                 }
                 dw->setConfigMap("", dwConfig);
-                fprintf(stderr, ".");
+                XROCK_LOG(Debug, "data widget updated");
             }
             catch (...)
             {
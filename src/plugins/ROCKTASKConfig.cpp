@@ -12,6 +12,8 @@
 #include <fstream>
 
 #include "../ComponentModelInterface.hpp"
+#include "../BasicModelHelper.hpp"
+#include "../Logger.hpp"
 using namespace configmaps;
 using namespace bagel_gui;
 
@@ -220,6 +222,12 @@ namespace xrock_gui_model
     dw = nullptr;
     statusLabel = nullptr;
     nodeMap = xrockGui->getBagelGui()->getCurrentTabView()->getView()->getSelectedNodeMap(); // TODO: will be better to pass in nodeMap from XROCKGUI.cpp
+    // Part models keep their version data as yaml string until it is needed
+    if (!BasicModelHelper::decodeData(nodeMap["model"]["versions"][0]) ||
+        !nodeMap["model"]["versions"][0]["data"].hasKey("properties"))
+    {
+      nodeMap["model"]["versions"][0]["data"]["properties"] = ConfigVector();
+    }
     std::string nodeName = nodeMap["model"]["name"];
     this->setWindowTitle(QString::fromStdString(nodeName+" Configuration"));
     if (fileName.size())
@@ -294,7 +302,7 @@ namespace xrock_gui_model
           if (path.back() != '/')
             path += "/";
           path += type + ".yml";
-          std::cerr << "check for config file: " << path.c_str() << std::endl;
+          XROCK_LOG(Debug, "check for config file: " << path);
           if (mars::utils::pathExists(path))
           {
             configFileName = path;
@@ -393,7 +401,7 @@ namespace xrock_gui_model
         }
         catch (...)
         {
-          std::cerr << "Error converting config into yaml map!" << std::endl;
+          XROCK_LOG(Error, "could not convert the config into a yaml map");
         }
       }
     }
@@ -419,7 +427,7 @@ namespace xrock_gui_model
 
         updateDataWidget(newConfig);
 
-        fprintf(stderr, "dw updated from text edit");
+        XROCK_LOG(Debug, "data widget updated from text edit");
       }
       catch (...)
       {
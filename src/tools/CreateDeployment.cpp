@@ -0,0 +1,61 @@
+/**
+ * \file CreateDeployment.cpp
+ * \brief Command line tool to create the orogen deployment package of a cnd file
+ **/
+
+#include "../CndImporter.hpp"
+#include "../DeploymentGenerator.hpp"
+
+#include <mars/utils/misc.h>
+#include <cstring>
+#include <iostream>
+
+using namespace xrock_gui_model;
+
+int main(int argc, char **argv)
+{
+    std::string cndFile;
+    std::string folder = "deployment";
+    bool valid = true;
+    for (int i = 1; i < argc; ++i)
+    {
+        if ((strcmp(argv[i], "-c") == 0 || strcmp(argv[i], "--cnd_file") == 0) && i + 1 < argc)
+        {
+            cndFile = argv[++i];
+        }
+        else if ((strcmp(argv[i], "-f") == 0 || strcmp(argv[i], "--folder") == 0) && i + 1 < argc)
+        {
+            folder = argv[++i];
+        }
+        else
+        {
+            valid = false;
+            break;
+        }
+    }
+    if (!valid || cndFile.empty())
+    {
+        std::cerr << "usage: " << argv[0] << " -c <cnd file> [-f <output folder, default: deployment>]" << std::endl;
+        return 1;
+    }
+    if (!mars::utils::pathExists(cndFile))
+    {
+        std::cout << "Error: given file not found: " << cndFile << std::endl;
+        return 255;
+    }
+
+    configmaps::ConfigMap cnd;
+    CndImporter importer;
+    if (!importer.readCnd(cndFile, cnd))
+    {
+        std::cerr << "Error: " << importer.getError() << std::endl;
+        return 1;
+    }
+    DeploymentGenerator generator;
+    if (!generator.generate(cnd, cndFile, folder))
+    {
+        std::cerr << "Error: " << generator.getError() << std::endl;
+        return 1;
+    }
+    return 0;
+}
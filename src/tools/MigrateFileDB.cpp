@@ -0,0 +1,42 @@
+/**
+ * \file MigrateFileDB.cpp
+ * \brief Command line tool to convert a FileDB into the current model format
+ **/
+
+#include "../FileDB.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+using namespace xrock_gui_model;
+
+int main(int argc, char **argv)
+{
+    std::string dbPath;
+    size_t numThreads = 0;
+    for (int i = 1; i < argc; ++i)
+    {
+        if ((strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--threads") == 0) && i + 1 < argc)
+        {
+            numThreads = std::strtoul(argv[++i], NULL, 10);
+        }
+        else if (argv[i][0] != '-' && dbPath.empty())
+        {
+            dbPath = argv[i];
+        }
+        else
+        {
+            dbPath.clear();
+            break;
+        }
+    }
+    if (dbPath.empty())
+    {
+        std::cerr << "usage: " << argv[0] << " <db path> [-j <threads>]" << std::endl;
+        return 1;
+    }
+    FileDB db;
+    db.setDbAddress(dbPath);
+    return db.migrate(numThreads) ? 0 : 1;
+}
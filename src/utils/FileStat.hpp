@@ -0,0 +1,38 @@
+/**
+ * \file FileStat.hpp
+ * \brief Modification time and size of a file to detect changed files
+ **/
+
+#pragma once
+#include <sys/stat.h>
+#include <cstdint>
+#include <string>
+
+namespace xrock_gui_model
+{
+    // The modification time in nanoseconds and the size of a file. Whole seconds are not
+    // enough to detect a file which is written twice within the same second.
+    struct FileStat
+    {
+        int64_t mtime = 0;
+        int64_t size = -1;
+
+        bool operator==(const FileStat &other) const { return mtime == other.mtime && size == other.size; }
+        bool operator!=(const FileStat &other) const { return !(*this == other); }
+
+        // Returns false (and leaves the default values) if the file does not exist
+        static bool read(const std::string &path, FileStat &fileStat)
+        {
+            struct stat st;
+            if (stat(path.c_str(), &st) != 0)
+                return false;
+#ifdef __APPLE__
+            fileStat.mtime = (int64_t)st.st_mtimespec.tv_sec * 1000000000 + st.st_mtimespec.tv_nsec;
+#else
+            fileStat.mtime = (int64_t)st.st_mtim.tv_sec * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+            fileStat.size = st.st_size;
+            return true;
+        }
+    };
+} // end of namespace xrock_gui_model
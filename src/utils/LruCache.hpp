@@ -0,0 +1,64 @@
+/**
+ * \file LruCache.hpp
+ * \brief Bounded key/value cache which evicts the least recently used entries
+ **/
+
+#pragma once
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace xrock_gui_model
+{
+    // Keeps at most capacity entries. find() and insert() mark the entry as most recently used,
+    // inserting into a full cache drops the least recently used entry. Both are O(1).
+    // Pointers returned by find() stay valid until the entry is evicted.
+    template <typename Key, typename Value>
+    class LruCache
+    {
+    public:
+        explicit LruCache(size_t capacity) : capacity(capacity > 0 ? capacity : 1) {}
+
+        size_t size() const { return index.size(); }
+
+        Value *find(const Key &key)
+        {
+            auto it = index.find(key);
+            if (it == index.end())
+                return nullptr;
+            entries.splice(entries.begin(), entries, it->second);
+            return &it->second->second;
+        }
+
+        Value &insert(const Key &key, Value value)
+        {
+            auto it = index.find(key);
+            if (it != index.end())
+            {
+                it->second->second = std::move(value);
+                entries.splice(entries.begin(), entries, it->second);
+                return it->second->second;
+            }
+            if (index.size() >= capacity)
+            {
+                index.erase(entries.back().first);
+                entries.pop_back();
+            }
+            entries.emplace_front(key, std::move(value));
+            index[key] = entries.begin();
+            return entries.front().second;
+        }
+
+        void clear()
+        {
+            entries.clear();
+            index.clear();
+        }
+
+    private:
+        size_t capacity;
+        std::list<std::pair<Key, Value>> entries;
+        std::unordered_map<Key, typename std::list<std::pair<Key, Value>>::iterator> index;
+    };
+} // end of namespace xrock_gui_model
@@ -0,0 +1,66 @@
+/**
+ * \file ParallelFor.hpp
+ * \brief Minimal worker pool to process independent work items in parallel
+ **/
+
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace xrock_gui_model
+{
+    // Returns the number of worker threads to use if the caller does not specify one
+    inline size_t defaultNumThreads()
+    {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Calls func(i) for all i in [0, n) distributed over up to numThreads workers (0: one per core).
+    // The call blocks until all items are processed. The first exception thrown by func is
+    // rethrown in the calling thread.
+    inline void parallelFor(size_t n, const std::function<void(size_t)> &func, size_t numThreads = 0)
+    {
+        if (numThreads == 0)
+            numThreads = defaultNumThreads();
+        numThreads = std::min(numThreads, n);
+        if (numThreads <= 1)
+        {
+            for (size_t i = 0; i < n; ++i)
+                func(i);
+            return;
+        }
+
+        std::atomic<size_t> next(0);
+        std::exception_ptr error;
+        std::mutex errorMutex;
+        std::vector<std::thread> workers;
+        workers.reserve(numThreads);
+        for (size_t t = 0; t < numThreads; ++t)
+        {
+            workers.emplace_back([&]()
+                                 {
+                for (size_t i = next++; i < n; i = next++)
+                {
+                    try
+                    {
+                        func(i);
+                    }
+                    catch (...)
+                    {
+                        std::lock_guard<std::mutex> lock(errorMutex);
+                        if (!error)
+                            error = std::current_exception();
+                    }
+                } });
+        }
+        for (auto &worker : workers)
+            worker.join();
+        if (error)
+            std::rethrow_exception(error);
+    }
+} // end of namespace xrock_gui_model
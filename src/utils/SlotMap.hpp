@@ -0,0 +1,153 @@
+/**
+ * \file SlotMap.hpp
+ * \brief Dense storage of values addressed by externally assigned ids
+ **/
+
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace xrock_gui_model
+{
+    // Stores the values contiguously in insertion order with an id -> slot index for O(1) access.
+    // Removed values leave a free slot which is reclaimed by compacting once half of the slots are free,
+    // so iteration stays over (mostly) contiguous memory and keeps the insertion order.
+    // References to values stay valid until the next insert() or erase().
+    template <typename T>
+    class SlotMap
+    {
+    public:
+        typedef unsigned long Id;
+
+        struct Slot
+        {
+            Id id;
+            bool used;
+            T value;
+        };
+
+        template <typename SlotIterator, typename Value>
+        class Iterator
+        {
+        public:
+            Iterator(SlotIterator it, SlotIterator end) : it(it), end(end) { skip(); }
+            std::pair<const Id &, Value &> operator*() const { return {it->id, it->value}; }
+            Iterator &operator++()
+            {
+                ++it;
+                skip();
+                return *this;
+            }
+            bool operator!=(const Iterator &other) const { return it != other.it; }
+            bool operator==(const Iterator &other) const { return it == other.it; }
+
+        private:
+            void skip()
+            {
+                while (it != end && !it->used)
+                    ++it;
+            }
+            SlotIterator it, end;
+        };
+        typedef Iterator<typename std::vector<Slot>::iterator, T> iterator;
+        typedef Iterator<typename std::vector<Slot>::const_iterator, const T> const_iterator;
+
+        SlotMap() : numUsed(0) {}
+
+        size_t size() const { return numUsed; }
+        bool empty() const { return numUsed == 0; }
+        bool contains(Id id) const { return index.find(id) != index.end(); }
+
+        T *find(Id id)
+        {
+            auto it = index.find(id);
+            return it == index.end() ? nullptr : &entries[it->second].value;
+        }
+
+        const T *find(Id id) const
+        {
+            auto it = index.find(id);
+            return it == index.end() ? nullptr : &entries[it->second].value;
+        }
+
+        // Inserts or replaces the value of the given id
+        T &insert(Id id, T value)
+        {
+            auto it = index.find(id);
+            if (it != index.end())
+            {
+                entries[it->second].value = std::move(value);
+                return entries[it->second].value;
+            }
+            index[id] = entries.size();
+            entries.push_back(Slot{id, true, std::move(value)});
+            ++numUsed;
+            return entries.back().value;
+        }
+
+        bool erase(Id id)
+        {
+            auto it = index.find(id);
+            if (it == index.end())
+                return false;
+            Slot &slot = entries[it->second];
+            slot.used = false;
+            slot.value = T();
+            index.erase(it);
+            --numUsed;
+            if (numUsed < entries.size() / 2)
+                compact();
+            return true;
+        }
+
+        void clear()
+        {
+            entries.clear();
+            index.clear();
+            numUsed = 0;
+        }
+
+        // Ids of the stored values in ascending order. Iteration follows the insertion order, which differs
+        // from the id order once values are re-inserted (e.g. by undo), so serializations use these ids.
+        std::vector<Id> sortedIds() const
+        {
+            std::vector<Id> ids;
+            ids.reserve(numUsed);
+            for (const Slot &slot : entries)
+            {
+                if (slot.used)
+                    ids.push_back(slot.id);
+            }
+            std::sort(ids.begin(), ids.end());
+            return ids;
+        }
+
+        iterator begin() { return iterator(entries.begin(), entries.end()); }
+        iterator end() { return iterator(entries.end(), entries.end()); }
+        const_iterator begin() const { return const_iterator(entries.begin(), entries.end()); }
+        const_iterator end() const { return const_iterator(entries.end(), entries.end()); }
+
+    private:
+        void compact()
+        {
+            size_t next = 0;
+            for (size_t i = 0; i < entries.size(); ++i)
+            {
+                if (!entries[i].used)
+                    continue;
+                if (i != next)
+                    entries[next] = std::move(entries[i]);
+                index[entries[next].id] = next;
+                ++next;
+            }
+            entries.erase(entries.begin() + next, entries.end());
+        }
+
+        std::vector<Slot> entries;
+        std::unordered_map<Id, size_t> index;
+        size_t numUsed;
+    };
+} // end of namespace xrock_gui_model
@@ -0,0 +1,75 @@
+/**
+ * \file YamlFileScan.hpp
+ * \brief Parallel search of the yaml files of a directory tree (e.g. the xrock_node_definitions)
+ **/
+
+#pragma once
+#include "ParallelFor.hpp"
+#include <dirent.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+namespace xrock_gui_model
+{
+    // Lists the yaml files and sub directories of the given directory (path ends with '/', sorted by name).
+    // Returns false if the path is not a directory.
+    inline bool scanYamlDirectory(const std::string &path, std::vector<std::string> &files, std::vector<std::string> &dirs)
+    {
+        DIR *dir;
+        struct dirent *ent;
+        if ((dir = opendir(path.c_str())) == NULL)
+            return false;
+        // go through all entities
+        while ((ent = readdir(dir)) != NULL)
+        {
+            std::string file = ent->d_name;
+
+            if (file.size() >= 4 && file.find(".yml", file.size() - 4, 4) != std::string::npos)
+            {
+                files.push_back(path + file);
+            }
+            else if (file.find(".", 0, 1) != std::string::npos)
+            {
+                // skip ".*"
+            }
+            else
+            {
+                // go into the next dir
+                dirs.push_back(path + file + "/");
+            }
+        }
+        closedir(dir);
+        std::sort(files.begin(), files.end());
+        std::sort(dirs.begin(), dirs.end());
+        return true;
+    }
+
+    // Collects the yaml files below path (ends with '/') in sorted order. The tree is scanned level by level,
+    // the directories of a level on up to numThreads workers. Entries which are no directories end up in invalid.
+    inline void findYamlFiles(const std::string &path, std::vector<std::string> &files, std::vector<std::string> &invalid,
+                              size_t numThreads = 0)
+    {
+        std::vector<std::string> level(1, path);
+        while (!level.empty())
+        {
+            std::vector<std::vector<std::string>> levelFiles(level.size()), levelDirs(level.size());
+            std::vector<char> valid(level.size(), 1);
+            parallelFor(level.size(), [&](size_t i)
+                        { valid[i] = scanYamlDirectory(level[i], levelFiles[i], levelDirs[i]); }, numThreads);
+            std::vector<std::string> next;
+            for (size_t i = 0; i < level.size(); ++i)
+            {
+                if (!valid[i])
+                {
+                    invalid.push_back(level[i]);
+                    continue;
+                }
+                files.insert(files.end(), levelFiles[i].begin(), levelFiles[i].end());
+                next.insert(next.end(), levelDirs[i].begin(), levelDirs[i].end());
+            }
+            level.swap(next);
+        }
+        std::sort(files.begin(), files.end());
+    }
+} // end of namespace xrock_gui_model
@@ -0,0 +1,38 @@
+/**
+ * \file Check.hpp
+ * \brief Minimal assertion helpers shared by the unit tests
+ **/
+
+#pragma once
+#include <iostream>
+
+namespace xrock_gui_model
+{
+    namespace test
+    {
+        inline int &failures()
+        {
+            static int count = 0;
+            return count;
+        }
+
+        inline void check(bool condition, const char *expression, const char *file, int line)
+        {
+            if (!condition)
+            {
+                std::cerr << file << ":" << line << ": check failed: " << expression << std::endl;
+                ++failures();
+            }
+        }
+
+        // Exit code of a test executable
+        inline int result()
+        {
+            if (failures())
+                std::cerr << failures() << " check(s) failed" << std::endl;
+            return failures() ? 1 : 0;
+        }
+    } // end of namespace test
+} // end of namespace xrock_gui_model
+
+#define CHECK(expression) xrock_gui_model::test::check((expression), #expression, __FILE__, __LINE__)
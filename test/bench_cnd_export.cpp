@@ -0,0 +1,115 @@
+/**
+ * \file bench_cnd_export.cpp
+ * \brief Compares the in-process CND export with the external xrock-export-cnd tool
+ *
+ * Usage: bench_cnd_export <FileDB path> <model name> <version> [urdf file]
+ *
+ * Exports the model of the database with CndExporter (full and repeated export) and with
+ * xrock-export-cnd, prints the timings and compares both cnds entry by entry. The external
+ * tool is skipped if it is not installed. Returns 1 if the cnds differ.
+ **/
+
+#include "CndExporter.hpp"
+#include "ConfigMapHelper.hpp"
+#include "FileDB.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+using namespace configmaps;
+using namespace xrock_gui_model;
+
+static double elapsedMs(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Prints the entries of the cnd sections which differ, returns their number
+static int compare(ConfigMap &native, ConfigMap &external)
+{
+    int differences = 0;
+    for (const char *section : {"tasks", "connections", "deployments", "static_transformations", "dynamic_transformations"})
+    {
+        ConfigMap empty;
+        ConfigMap &a = native.hasKey(section) && native[section].isMap() ? (ConfigMap &)native[section] : empty;
+        ConfigMap &b = external.hasKey(section) && external[section].isMap() ? (ConfigMap &)external[section] : empty;
+        for (auto &it : a)
+        {
+            if (!b.hasKey(it.first))
+                std::cout << "only in native export: " << section << "/" << it.first << std::endl;
+            else if (!ConfigMapHelper::equals(it.second, b[it.first]))
+                std::cout << "differs: " << section << "/" << it.first << std::endl;
+            else
+                continue;
+            ++differences;
+        }
+        for (auto &it : b)
+        {
+            if (a.hasKey(it.first))
+                continue;
+            std::cout << "only in xrock-export-cnd: " << section << "/" << it.first << std::endl;
+            ++differences;
+        }
+    }
+    return differences;
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 4)
+    {
+        std::cerr << "usage: " << argv[0] << " <db path> <model name> <version> [urdf file]" << std::endl;
+        return 1;
+    }
+    const std::string dbPath = argv[1], modelName = argv[2], version = argv[3];
+    const std::string urdfFile = argc > 4 ? argv[4] : "";
+
+    FileDB db;
+    db.setDbAddress(dbPath);
+    ConfigMap model = db.requestModel("SOFTWARE", modelName, version);
+    if (!model.hasKey("versions"))
+    {
+        std::cerr << "unknown model " << modelName << " " << version << std::endl;
+        return 1;
+    }
+    CndExporter exporter([&db](const std::string &domain, const std::string &name, const std::string &version)
+                         { return db.requestModel(domain, name, version, true); });
+
+    const std::string nativeFile = "bench_native.cnd";
+    auto start = std::chrono::steady_clock::now();
+    if (!exporter.exportCnd(model, nativeFile, urdfFile))
+    {
+        std::cerr << "export failed: " << exporter.getError() << std::endl;
+        return 1;
+    }
+    const double nativeMs = elapsedMs(start);
+    start = std::chrono::steady_clock::now();
+    exporter.exportCnd(model, nativeFile, urdfFile);
+    const double repeatedMs = elapsedMs(start);
+    std::printf("CndExporter: %.1f ms, repeated export: %.1f ms\n", nativeMs, repeatedMs);
+
+    const std::string externalFile = "bench_external.cnd";
+    std::ostringstream command;
+    command << "xrock-export-cnd -m " << modelName << " -v " << version << " -o " << externalFile
+            << " -b Serverless --db_address " << dbPath;
+    if (!urdfFile.empty())
+        command << " -t --tf_enhance -u " << urdfFile;
+    command << " > /dev/null";
+    start = std::chrono::steady_clock::now();
+    if (std::system(command.str().c_str()) != 0)
+    {
+        std::printf("xrock-export-cnd: not available, comparison skipped\n");
+        return 0;
+    }
+    std::printf("xrock-export-cnd: %.1f ms\n", elapsedMs(start));
+
+    ConfigMap native = ConfigMap::fromYamlFile(nativeFile);
+    ConfigMap external = ConfigMap::fromYamlFile(externalFile);
+    const int differences = compare(native, external);
+    std::printf("%d differing entries\n", differences);
+    return differences ? 1 : 0;
+}
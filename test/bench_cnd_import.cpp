@@ -0,0 +1,68 @@
+/**
+ * \file bench_cnd_import.cpp
+ * \brief Times the import of a generated CND with many tasks
+ *
+ * Usage: bench_cnd_import [number of tasks (default 2000)]
+ *
+ * The generated cnd chains the tasks with connections and shares the task configuration
+ * through an anchor, like the cnds written by the python tooling do.
+ **/
+
+#include "CndImporter.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+using namespace configmaps;
+using namespace xrock_gui_model;
+
+static void writeCnd(const std::string &fileName, int taskCount)
+{
+    std::ofstream out(fileName);
+    out << "tasks:\n";
+    for (int i = 0; i < taskCount; ++i)
+    {
+        out << "  task_" << i << ":\n"
+            << "    type: bench::Task\n";
+        if (i == 0)
+            out << "    config: &config {rate: 10, frames: [base, tool], names: {in: input, out: output}}\n";
+        else
+            out << "    config: *config\n";
+    }
+    out << "connections:\n";
+    for (int i = 1; i < taskCount; ++i)
+    {
+        out << "  connection_" << i << ":\n"
+            << "    from: {task_id: task_" << i - 1 << ", port_name: out}\n"
+            << "    to: {task_id: task_" << i << ", port_name: in}\n";
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const int taskCount = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const std::string fileName = "bench_cnd_import.cnd";
+    writeCnd(fileName, taskCount);
+
+    CndImporter importer;
+    ConfigMap model;
+    auto start = std::chrono::steady_clock::now();
+    if (!importer.importCnd(fileName, model))
+    {
+        std::fprintf(stderr, "import failed: %s\n", importer.getError().c_str());
+        return 1;
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("importCnd: %d tasks, %d connections: %.1f ms\n", taskCount, taskCount - 1, ms);
+
+    ConfigMap cnd;
+    start = std::chrono::steady_clock::now();
+    importer.readCnd(fileName, cnd);
+    ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::printf("readCnd: %.1f ms\n", ms);
+    std::remove(fileName.c_str());
+    return 0;
+}
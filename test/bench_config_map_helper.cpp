@@ -0,0 +1,177 @@
+/**
+ * \file bench_config_map_helper.cpp
+ * \brief Measures the ConfigMapHelper path lookups, prune and merge on a task configuration tree
+ **/
+
+#include "ConfigMapHelper.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+using namespace configmaps;
+using namespace xrock_gui_model;
+
+// Resembles the configuration of a software model: tasks with scalar properties,
+// nested structs and vectors of structs
+static ConfigMap createConfig(size_t numTasks)
+{
+    ConfigMap config;
+    for (size_t t = 0; t < numTasks; ++t)
+    {
+        ConfigMap task;
+        task["activity"]["type"] = "PERIODIC";
+        task["activity"]["period"] = 0.01;
+        task["state"] = "RUNNING";
+        for (int p = 0; p < 20; ++p)
+            task["config"]["property_" + std::to_string(p)] = p * 0.5;
+        task["config"]["transformer"]["frame"] = "body";
+        task["config"]["transformer"]["max_latency"] = 0.1;
+        for (int j = 0; j < 6; ++j)
+        {
+            ConfigMap joint;
+            joint["name"] = "joint_" + std::to_string(j);
+            joint["limits"]["min"] = -1.5;
+            joint["limits"]["max"] = 1.5;
+            task["config"]["joints"].push_back(joint);
+        }
+        config["tasks"]["task_" + std::to_string(t)] = task;
+    }
+    return config;
+}
+
+// Adds the blank entries a configuration dialog leaves behind
+static void addBlanks(ConfigMap &config)
+{
+    ConfigMap &tasks = config["tasks"];
+    for (auto &task : tasks)
+    {
+        task.second["config"]["comment"] = "";
+        task.second["config"]["transformer"]["static_transforms"] = ConfigVector();
+        ConfigMap joint;
+        joint["name"] = " ";
+        task.second["config"]["joints"].push_back(joint);
+    }
+}
+
+// Pruning as it was done before ConfigMapHelper::prune: restart at the first entry after every erase
+static void pruneRestart(ConfigItem &item)
+{
+    if (item.isMap())
+    {
+        ConfigMap &map = item;
+        ConfigMap::iterator it = map.begin();
+        while (it != map.end())
+        {
+            if (it->second.isMap() || it->second.isVector())
+                pruneRestart(it->second);
+            bool blank = it->second.isAtom() ? it->second.toString().find_first_not_of(" \t\r\n") == std::string::npos
+                                             : it->second.size() == 0;
+            if (blank)
+            {
+                item.erase(it);
+                it = map.begin();
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+    else if (item.isVector())
+    {
+        ConfigVector &vector = item;
+        ConfigVector::iterator it = vector.begin();
+        while (it != vector.end())
+        {
+            if (it->isMap() || it->isVector())
+                pruneRestart(*it);
+            bool blank = it->isAtom() ? it->toString().find_first_not_of(" \t\r\n") == std::string::npos
+                                      : it->size() == 0;
+            if (blank)
+            {
+                vector.erase(it);
+                it = vector.begin();
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+}
+
+template <typename F>
+static double measure(F &&func, int repeat)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; ++i)
+        func();
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / repeat;
+}
+
+static void run(size_t numTasks)
+{
+    ConfigMap config = createConfig(numTasks);
+    std::vector<std::string> pathStrings;
+    std::vector<std::vector<std::string>> pathVectors;
+    std::vector<ConfigPath> paths;
+    for (size_t t = 0; t < numTasks; ++t)
+    {
+        const std::string task = "task_" + std::to_string(t);
+        pathStrings.push_back("tasks/" + task + "/config/joints/" + std::to_string(t % 6) + "/limits/max");
+        pathVectors.push_back({"tasks", task, "config", "joints", std::to_string(t % 6), "limits", "max"});
+        paths.emplace_back(pathStrings.back());
+    }
+
+    const int repeat = 20;
+    volatile size_t found = 0;
+    double parsed = measure([&] {
+        for (auto &path : pathStrings)
+            found = found + (ConfigMapHelper::getSubItem(config, ConfigPath(path)) != NULL); }, repeat);
+    double vectors = measure([&] {
+        for (auto &path : pathVectors)
+            found = found + (ConfigMapHelper::getSubItem(config, path) != NULL); }, repeat);
+    double compiled = measure([&] {
+        for (auto &path : paths)
+            found = found + (ConfigMapHelper::getSubItem(config, path) != NULL); }, repeat);
+    double readOnly = measure([&] {
+        for (auto &path : paths)
+            found = found + (ConfigMapHelper::findItem(config, path) != NULL); }, repeat);
+
+    ConfigMap copy = config;
+    double equals = measure([&] { found = found + ConfigMapHelper::equals(config, copy); }, repeat);
+
+    // the copies are part of the measurements of prune and merge
+    ConfigMap blanks = config;
+    addBlanks(blanks);
+    double copying = measure([&] {
+        ConfigItem item(blanks);
+        found = found + item.size(); }, repeat);
+    double restart = measure([&] {
+        ConfigItem item(blanks);
+        pruneRestart(item);
+        found = found + item.size(); }, repeat);
+    double prune = measure([&] {
+        ConfigItem item(blanks);
+        found = found + ConfigMapHelper::prune(item); }, repeat);
+    double merge = measure([&] {
+        ConfigMap target = config;
+        ConfigMapHelper::merge(target, blanks);
+        found = found + target.size(); }, repeat);
+
+    std::printf("%5zu tasks  lookups: parsed path %9.1f us  string vector %9.1f us  compiled path %9.1f us  findItem %9.1f us"
+                "   equals: %9.1f us\n",
+                numTasks, parsed, vectors, compiled, readOnly, equals);
+    std::printf("             copy %9.1f us  prune (restart) %9.1f us  prune %9.1f us  copy + merge %9.1f us\n",
+                copying, restart, prune, merge);
+}
+
+int main()
+{
+    for (size_t numTasks : {10, 100, 1000})
+        run(numTasks);
+    return 0;
+}
@@ -0,0 +1,105 @@
+/**
+ * \file bench_model_load.cpp
+ * \brief Times the legacy model conversion of the load path with and without the model dumps
+ *
+ * Usage: bench_model_load [number of nodes (default 2000)]
+ *
+ * "dump" writes the edges and the whole model on every conversion like the load path
+ * did before the logger was introduced (into /dev/null instead of a terminal, so the numbers are
+ * a lower bound). "log off" emits the same payloads through XROCK_LOG at the default info level,
+ * so they are not formatted at all.
+ **/
+
+#include "BasicModelHelper.hpp"
+#include "Logger.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <string>
+
+using namespace configmaps;
+using namespace xrock_gui_model;
+
+static ConfigMap createLegacyModel(int numNodes)
+{
+    ConfigMap model;
+    model["name"] = "bench_model";
+    model["domain"] = "SOFTWARE";
+    model["type"] = "system_modelling::task_graph::Network";
+    ConfigMap &version = model["versions"][0];
+    version["name"] = "v0.0.1";
+    version["softwareData"]["data"] = "framework: Rock\n";
+    for (int i = 0; i < numNodes; ++i)
+    {
+        ConfigMap node;
+        node["name"] = "task_" + std::to_string(i);
+        node["model"]["name"] = "bench::Task";
+        node["model"]["domain"] = "SOFTWARE";
+        node["model"]["version"] = "v0.0.1";
+        node["data"] = "gui:\n  position2D: {x: " + std::to_string(i * 10) + ", y: 0}\n";
+        version["components"]["nodes"].push_back(node);
+        if (i > 0)
+        {
+            ConfigMap edge;
+            edge["name"] = "edge_" + std::to_string(i);
+            edge["from"]["name"] = "task_" + std::to_string(i - 1);
+            edge["from"]["interface"] = "out";
+            edge["to"]["name"] = "task_" + std::to_string(i);
+            edge["to"]["interface"] = "in";
+            edge["data"] = "decouple: false\nweight: 1\n";
+            version["components"]["edges"].push_back(edge);
+        }
+        ConfigMap config;
+        config["name"] = "task_" + std::to_string(i);
+        config["data"] = "config:\n  rate: 10\n  frames: [base, tool]\n";
+        version["components"]["configuration"]["nodes"].push_back(config);
+    }
+    version["defaultConfiguration"]["data"] = "rate: 10\n";
+    return model;
+}
+
+static double measure(const ConfigMap &legacy, int repetitions, const std::function<void(ConfigMap &)> &emit)
+{
+    double total = 0;
+    for (int r = 0; r < repetitions; ++r)
+    {
+        ConfigMap model = legacy;
+        auto start = std::chrono::steady_clock::now();
+        BasicModelHelper::convertFromLegacyModelFormat(model);
+        emit(model);
+        total += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+    return total / repetitions;
+}
+
+int main(int argc, char **argv)
+{
+    const int numNodes = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const int repetitions = 5;
+    const ConfigMap legacy = createLegacyModel(numNodes);
+    FILE *devNull = std::fopen("/dev/null", "w");
+    if (!devNull)
+    {
+        std::fprintf(stderr, "cannot open /dev/null\n");
+        return 1;
+    }
+
+    double dump = measure(legacy, repetitions, [devNull](ConfigMap &model)
+                          {
+                              std::fputs(model["versions"][0]["components"]["edges"].toYamlString().c_str(), devNull);
+                              std::fputs(model.toYamlString().c_str(), devNull); });
+
+    Logger::instance().setLevel(LogLevel::Info);
+    double logOff = measure(legacy, repetitions, [](ConfigMap &model)
+                            {
+                                XROCK_LOG(Debug, model["versions"][0]["components"]["edges"].toYamlString());
+                                XROCK_LOG(Debug, model.toYamlString()); });
+    std::fclose(devNull);
+
+    std::printf("convert %d nodes, mean of %d runs:\n", numNodes, repetitions);
+    std::printf("  dump:    %.1f ms\n", dump);
+    std::printf("  log off: %.1f ms\n", logOff);
+    return 0;
+}
@@ -0,0 +1,106 @@
+/**
+ * \file bench_node_context.cpp
+ * \brief Counts the allocations of the node context menu lookups on a node with a large embedded model
+ *
+ * Usage: bench_node_context [number of inner nodes (default 1000)]
+ *
+ * "copy" reads the entries from a copy of the node like the context handlers did before,
+ * "view" reads them through the const lookups of ConfigMapHelper.
+ **/
+
+#include "BasicModelHelper.hpp"
+#include "ConfigMapHelper.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+using namespace configmaps;
+using namespace xrock_gui_model;
+
+static std::atomic<size_t> allocations(0);
+
+void *operator new(size_t size)
+{
+    ++allocations;
+    void *ptr = std::malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+void operator delete(void *ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+// A node of a part model whose model is embedded in the node map like in the BagelGui
+static ConfigMap createNode(int numInnerNodes)
+{
+    ConfigMap node;
+    node["name"] = "arm";
+    node["alias"] = "left_arm";
+    ConfigMap &model = node["model"];
+    model["name"] = "arm";
+    model["domain"] = "SOFTWARE";
+    model["versions"][0]["name"] = "v1";
+    ConfigItem &components = model["versions"][0]["components"];
+    for (int i = 0; i < numInnerNodes; ++i)
+    {
+        ConfigMap inner;
+        inner["name"] = "task_" + std::to_string(i);
+        inner["model"]["name"] = "bench::Task";
+        inner["model"]["domain"] = "SOFTWARE";
+        inner["model"]["version"] = "v1";
+        components["nodes"].push_back(inner);
+        ConfigMap config;
+        config["name"] = inner["name"];
+        config["data"]["rate"] = 10;
+        config["data"]["frames"][0] = "base";
+        components["configuration"]["nodes"].push_back(config);
+    }
+    return node;
+}
+
+template <typename F>
+static void measure(const char *name, F &&func)
+{
+    const int repeat = 20;
+    volatile size_t found = 0;
+    size_t before = allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; ++i)
+        found = found + func();
+    double us = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() / repeat;
+    std::printf("  %s: %8zu allocations %10.1f us\n", name, (allocations - before) / repeat, us);
+}
+
+int main(int argc, char **argv)
+{
+    const int numInnerNodes = argc > 1 ? std::atoi(argv[1]) : 1000;
+    const ConfigMap node = createNode(numInnerNodes);
+    const ConfigMap *nodePtr = &node;
+    static const ConfigPath modelDomainPath("model/domain");
+
+    std::printf("node context of a node with %d inner nodes, per right-click:\n", numInnerNodes);
+    measure("copy", [&]()
+            {
+                ConfigMap copy = *nodePtr;
+                bool components = BasicModelHelper::hasComponents(copy["model"]);
+                std::string domain = copy["model"]["domain"];
+                return components + domain.size(); });
+    measure("view", [&]()
+            {
+                bool components = BasicModelHelper::nodeHasComponents(*nodePtr);
+                std::string domain = ConfigMapHelper::getString(*nodePtr, modelDomainPath);
+                return components + domain.size(); });
+    return 0;
+}
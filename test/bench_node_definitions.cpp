@@ -0,0 +1,127 @@
+/**
+ * \file bench_node_definitions.cpp
+ * \brief Times the startup scan and parse of a node definition tree with different numbers of threads
+ *
+ * Usage: bench_node_definitions [number of definition files (default 2000)]
+ *
+ * A tree of component models similar to xrock_node_definitions is written to a temporary folder.
+ * It is then searched with findYamlFiles() and parsed on parallelFor() like ComponentModelInterface::loadNodeInfo()
+ * does at startup. The registration of the parsed models is sequential and not part of the times.
+ **/
+
+#include "utils/ParallelFor.hpp"
+#include "utils/YamlFileScan.hpp"
+
+#include <configmaps/ConfigData.h>
+#include <mars/utils/misc.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace configmaps;
+using namespace xrock_gui_model;
+
+static const std::string folder = "bench_node_definitions/";
+static const int filesPerDir = 50;
+
+static void createDefinitions(int numFiles)
+{
+    for (int i = 0; i < numFiles; ++i)
+    {
+        const std::string dir = folder + "domain_" + std::to_string(i % 4) + "/group_" + std::to_string(i / filesPerDir) + "/";
+        if (i % filesPerDir < 4)
+            mars::utils::createDirectory(dir);
+        std::ofstream out(dir + "model_" + std::to_string(i) + ".yml");
+        out << "name: model_" << i << "\n"
+            << "domain: SOFTWARE\n"
+            << "type: system_modelling::task_graph::Task\n"
+            << "versions:\n"
+            << "  - name: v1\n"
+            << "    interfaces:\n";
+        for (int p = 0; p < 8; ++p)
+        {
+            out << "      - {name: port_" << p << ", direction: " << (p % 2 ? "INCOMING" : "OUTGOING")
+                << ", type: \"::base::samples::Joints\"}\n";
+        }
+        out << "    defaultConfiguration:\n"
+            << "      data: \"rate: 10\\nframes: [base, tool]\\n\"\n";
+    }
+}
+
+static void removeDefinitions()
+{
+    std::vector<std::string> files, invalid;
+    findYamlFiles(folder, files, invalid);
+    for (const std::string &file : files)
+        std::remove(file.c_str());
+    // the directories are listed level by level and removed from the deepest level up
+    std::vector<std::string> dirs;
+    std::vector<std::string> level(1, folder);
+    while (!level.empty())
+    {
+        std::vector<std::string> next;
+        for (const std::string &dir : level)
+        {
+            std::vector<std::string> unused;
+            scanYamlDirectory(dir, unused, next);
+        }
+        dirs.insert(dirs.end(), level.begin(), level.end());
+        level.swap(next);
+    }
+    for (auto it = dirs.rbegin(); it != dirs.rend(); ++it)
+        std::remove(it->c_str());
+}
+
+// Returns the time (ms) of the scan and of the parse
+static std::pair<double, double> load(size_t numThreads, size_t &numFiles)
+{
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::string> files, invalid;
+    findYamlFiles(folder, files, invalid, numThreads);
+    const auto scanned = std::chrono::steady_clock::now();
+    std::vector<ConfigMap> maps(files.size());
+    parallelFor(files.size(), [&](size_t i)
+                { maps[i] = ConfigMap::fromYamlFile(files[i]); }, numThreads);
+    const auto parsed = std::chrono::steady_clock::now();
+    numFiles = files.size();
+    return std::make_pair(std::chrono::duration<double, std::milli>(scanned - start).count(),
+                          std::chrono::duration<double, std::milli>(parsed - scanned).count());
+}
+
+int main(int argc, char **argv)
+{
+    const int numFiles = argc > 1 ? std::atoi(argv[1]) : 2000;
+    removeDefinitions();
+    createDefinitions(numFiles);
+
+    std::vector<size_t> threads = {1, 2, 4};
+    if (defaultNumThreads() > 4)
+        threads.push_back(defaultNumThreads());
+    double sequential = 0;
+    std::printf("load %d node definitions, best of 3 runs:\n", numFiles);
+    for (size_t numThreads : threads)
+    {
+        double best = 0, bestScan = 0, bestParse = 0;
+        size_t found = 0;
+        for (int r = 0; r < 3; ++r)
+        {
+            std::pair<double, double> times = load(numThreads, found);
+            if (r == 0 || times.first + times.second < best)
+            {
+                best = times.first + times.second;
+                bestScan = times.first;
+                bestParse = times.second;
+            }
+        }
+        if (numThreads == 1)
+            sequential = best;
+        std::printf("  %2zu threads: scan %7.1f ms, parse %7.1f ms, total %7.1f ms (%.2fx), %zu files\n",
+                    numThreads, bestScan, bestParse, best, sequential / best, found);
+    }
+    removeDefinitions();
+    return 0;
+}
@@ -0,0 +1,83 @@
+/**
+ * \file bench_slot_map.cpp
+ * \brief Compares the SlotMap used for the node and edge stores with std::map
+ **/
+
+#include "utils/SlotMap.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace xrock_gui_model;
+
+// Stand-in for a node or edge ConfigMap: a few strings per entry
+struct Entry
+{
+    std::string name, type, data;
+};
+
+template <typename F>
+static double measure(F &&func, int repeat)
+{
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeat; ++i)
+        func();
+    std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count() / repeat;
+}
+
+static void run(size_t count)
+{
+    std::vector<unsigned long> ids(count);
+    for (size_t i = 0; i < count; ++i)
+        ids[i] = i * 7 + 1;
+    std::vector<unsigned long> lookups = ids;
+    std::shuffle(lookups.begin(), lookups.end(), std::mt19937(42));
+
+    SlotMap<Entry> slotMap;
+    std::map<unsigned long, Entry> stdMap;
+    for (unsigned long id : ids)
+    {
+        Entry entry{"node_" + std::to_string(id), "software::Task", std::string(64, 'x')};
+        slotMap.insert(id, entry);
+        stdMap[id] = entry;
+    }
+
+    const int repeat = count >= 100000 ? 10 : 100;
+    volatile size_t sink = 0;
+    double slotIter = measure([&] {
+        size_t sum = 0;
+        for (const auto &[id, entry] : slotMap)
+            sum += entry.name.size();
+        sink = sink + sum; }, repeat);
+    double mapIter = measure([&] {
+        size_t sum = 0;
+        for (auto &[id, entry] : stdMap)
+            sum += entry.name.size();
+        sink = sink + sum; }, repeat);
+    double slotFind = measure([&] {
+        size_t sum = 0;
+        for (unsigned long id : lookups)
+            sum += slotMap.find(id)->name.size();
+        sink = sink + sum; }, repeat);
+    double mapFind = measure([&] {
+        size_t sum = 0;
+        for (unsigned long id : lookups)
+            sum += stdMap.find(id)->second.name.size();
+        sink = sink + sum; }, repeat);
+
+    std::printf("%7zu entries  iterate: SlotMap %9.1f us  std::map %9.1f us   lookup: SlotMap %9.1f us  std::map %9.1f us\n",
+                count, slotIter, mapIter, slotFind, mapFind);
+}
+
+int main()
+{
+    for (size_t count : {1000, 10000, 100000})
+        run(count);
+    return 0;
+}
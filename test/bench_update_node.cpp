@@ -0,0 +1,101 @@
+/**
+ * \file bench_update_node.cpp
+ * \brief Times the model check of ComponentModelInterface::updateNode() on a node with a large embedded model
+ *
+ * Usage: bench_update_node [number of inner nodes (default 1000)]
+ *
+ * "copy" assigns the model to the node on every update like updateNode() did before the model was shared,
+ * "unchanged" compares the node model with the shared model (the common case of an interactive edit),
+ * "edited" compares a model with a changed inner entry and restores the shared model.
+ * The times are per update and should stay well below a frame (16.7 ms at 60 Hz).
+ **/
+
+#include "ConfigMapHelper.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+using namespace configmaps;
+using namespace xrock_gui_model;
+
+static const double frameBudget = 1000. / 60.;
+
+static ConfigMap createModel(int numInnerNodes)
+{
+    ConfigMap model;
+    model["name"] = "arm";
+    model["domain"] = "SOFTWARE";
+    model["versions"][0]["name"] = "v1";
+    ConfigItem &components = model["versions"][0]["components"];
+    for (int i = 0; i < numInnerNodes; ++i)
+    {
+        ConfigMap inner;
+        inner["name"] = "task_" + std::to_string(i);
+        inner["model"]["name"] = "bench::Task";
+        inner["model"]["domain"] = "SOFTWARE";
+        inner["model"]["version"] = "v1";
+        components["nodes"].push_back(inner);
+        ConfigMap config;
+        config["name"] = inner["name"];
+        config["data"]["rate"] = 10;
+        config["data"]["frames"][0] = "base";
+        components["configuration"]["nodes"].push_back(config);
+    }
+    return model;
+}
+
+// The model part of updateNode()
+static bool restoreModel(ConfigMap &node, const ConfigMap &shared)
+{
+    if (!node.hasKey("model") || !node["model"].isMap() ||
+        !ConfigMapHelper::equals((ConfigMap &)node["model"], shared))
+    {
+        node["model"] = shared;
+        return true;
+    }
+    return false;
+}
+
+template <typename F>
+static void measure(const char *name, F &&func)
+{
+    const int repeat = 20;
+    double total = 0;
+    for (int i = 0; i < repeat; ++i)
+        total += func();
+    double ms = total / repeat;
+    std::printf("  %-10s %8.3f ms (%5.1f %% of a frame)\n", name, ms, 100. * ms / frameBudget);
+}
+
+int main(int argc, char **argv)
+{
+    const int numInnerNodes = argc > 1 ? std::atoi(argv[1]) : 1000;
+    const std::shared_ptr<const ConfigMap> shared = std::make_shared<const ConfigMap>(createModel(numInnerNodes));
+    ConfigMap node;
+    node["name"] = "arm";
+    node["model"] = *shared;
+
+    std::printf("updateNode() model check of a node with %d inner nodes, per update:\n", numInnerNodes);
+    measure("copy", [&]()
+            {
+                auto start = std::chrono::steady_clock::now();
+                node["model"] = *shared;
+                return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); });
+    measure("unchanged", [&]()
+            {
+                auto start = std::chrono::steady_clock::now();
+                if (restoreModel(node, *shared))
+                    std::fprintf(stderr, "unexpected restore\n");
+                return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); });
+    measure("edited", [&]()
+            {
+                node["model"]["versions"][0]["components"]["configuration"]["nodes"][numInnerNodes - 1]["data"]["rate"] = 20;
+                auto start = std::chrono::steady_clock::now();
+                if (!restoreModel(node, *shared))
+                    std::fprintf(stderr, "edit not reverted\n");
+                return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); });
+    return 0;
+}
@@ -0,0 +1,77 @@
+/**
+ * \file test_basic_model_helper.cpp
+ * \brief Unit tests of the lazy data conversion of the BasicModelHelper
+ **/
+
+#include "Check.hpp"
+#include "BasicModelHelper.hpp"
+
+#include <string>
+
+using namespace configmaps;
+using namespace xrock_gui_model;
+
+static ConfigMap createLegacyModel()
+{
+    return ConfigMap::fromYamlString("name: arm\n"
+                                     "domain: SOFTWARE\n"
+                                     "versions:\n"
+                                     "  - name: v1\n"
+                                     "    softwareData:\n"
+                                     "      data: \"framework:   Rock\\n\"\n"
+                                     "    components:\n"
+                                     "      nodes:\n"
+                                     "        - {name: left}\n"
+                                     "        - {name: right}\n"
+                                     "      edges:\n"
+                                     "        - {name: e, data: \"weight:  2\\n\"}\n"
+                                     "        - {name: f, data: \"decouple:  true\\n\"}\n"
+                                     "      configuration:\n"
+                                     "        nodes:\n"
+                                     "          - {name: left, data: \"rate:  10\\n\"}\n"
+                                     "          - {name: right, data: \"rate:  10\\n# right\\n\"}\n");
+}
+
+// Data strings stay encoded until they are accessed
+static void testLazyDecoding()
+{
+    ConfigMap model = createLegacyModel();
+    BasicModelHelper::convertFromLegacyModelFormat(model);
+    ConfigItem &version = model["versions"][0];
+    CHECK(!version["data"].isMap());
+    CHECK(!version["components"]["configuration"]["nodes"][0]["data"].isMap());
+    // edges with a weight are decoded to copy the weight
+    ConfigItem &edges = version["components"]["edges"];
+    CHECK(edges[0]["data"].isMap());
+    CHECK((int)edges[0]["weight"] == 2);
+    CHECK(!edges[1]["data"].isMap());
+    CHECK(!edges[1].hasKey("weight"));
+}
+
+// Only data which changed after decoding is serialized again, the other entries keep their original string
+static void testDirtyEncoding()
+{
+    ConfigMap model = createLegacyModel();
+    BasicModelHelper::convertFromLegacyModelFormat(model);
+    ConfigItem &nodes = model["versions"][0]["components"]["configuration"]["nodes"];
+    CHECK(BasicModelHelper::decodeData(nodes[0]));
+    CHECK(BasicModelHelper::decodeData(nodes[1]));
+    CHECK(BasicModelHelper::decodeData(model["versions"][0]));
+    nodes[1]["data"]["rate"] = 20;
+
+    BasicModelHelper::convertToLegacyModelFormat(model);
+    ConfigItem &version = model["versions"][0];
+    CHECK(version["softwareData"]["data"].getString() == "framework:   Rock\n");
+    CHECK(version["components"]["edges"][0]["data"].getString() == "weight:  2\n");
+    CHECK(version["components"]["edges"][1]["data"].getString() == "decouple:  true\n");
+    CHECK(nodes[0]["data"].getString() == "rate:  10\n");
+    CHECK(nodes[1]["data"].getString() != "rate:  10\n# right\n");
+    CHECK((int)ConfigMap::fromYamlString(nodes[1]["data"].getString())["rate"] == 20);
+}
+
+int main()
+{
+    testLazyDecoding();
+    testDirtyEncoding();
+    return test::result();
+}
@@ -0,0 +1,264 @@
+/**
+ * \file test_cnd_exporter.cpp
+ * \brief Unit tests of the CND export
+ **/
+
+#include "Check.hpp"
+#include "CndExporter.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+
+using namespace configmaps;
+using namespace xrock_gui_model;
+
+// Part models by name, all of them in version v1
+static std::map<std::string, ConfigMap> parts()
+{
+    std::map<std::string, ConfigMap> parts;
+    parts["camera::Task"] = ConfigMap::fromYamlString("name: camera::Task\n"
+                                                      "type: software::Task\n"
+                                                      "versions: [{name: v1}]\n");
+    parts["orogen::Deployment"] = ConfigMap::fromYamlString("name: orogen::Deployment\n"
+                                                            "type: software::Deployment\n"
+                                                            "versions: [{name: v1}]\n");
+    return parts;
+}
+
+static ConfigMap node(const std::string &name, const std::string &modelName)
+{
+    ConfigMap node;
+    node["name"] = name;
+    node["model"]["domain"] = "SOFTWARE";
+    node["model"]["name"] = modelName;
+    node["model"]["version"] = "v1";
+    return node;
+}
+
+static ConfigMap createModel()
+{
+    ConfigMap model = ConfigMap::fromYamlString("name: system\n"
+                                                "versions: [{name: v1}]\n");
+    ConfigItem &components = model["versions"][0]["components"];
+    components["nodes"].push_back(node("left", "camera::Task"));
+    components["nodes"].push_back(node("right", "camera::Task"));
+    ConfigMap edge = ConfigMap::fromYamlString("name: sync\n"
+                                               "from: {name: left, interface: frame}\n"
+                                               "to: {name: right, interface: trigger}\n");
+    components["edges"].push_back(edge);
+    return model;
+}
+
+static void testDefaultDeployments()
+{
+    std::map<std::string, ConfigMap> models = parts();
+    CndExporter exporter([&](const std::string &, const std::string &name, const std::string &)
+                         { return models[name]; });
+    ConfigMap model = createModel();
+    ConfigMap cnd;
+    CHECK(exporter.createCnd(model, cnd));
+    CHECK(cnd["tasks"].size() == 2);
+    CHECK(cnd["tasks"]["left"]["type"].getString() == "camera::Task");
+    CHECK(cnd["connections"]["sync"]["from"]["task_id"].getString() == "left");
+    CHECK(cnd["connections"]["sync"]["to"]["port_name"].getString() == "trigger");
+
+    // Tasks of the same type run in separate default deployments
+    CHECK(cnd["deployments"].size() == 2);
+    ConfigItem &left = cnd["deployments"]["left_deployment"];
+    ConfigItem &right = cnd["deployments"]["right_deployment"];
+    CHECK(left["process_name"].getString() == "orogen_default_left");
+    CHECK(right["process_name"].getString() == "orogen_default_right");
+    CHECK(left["taskList"]["left"].getString() == "camera::Task");
+    CHECK(!left["taskList"].hasKey("right"));
+}
+
+static void testDeploymentNode()
+{
+    std::map<std::string, ConfigMap> models = parts();
+    CndExporter exporter([&](const std::string &, const std::string &name, const std::string &)
+                         { return models[name]; });
+    ConfigMap model = createModel();
+    ConfigItem &components = model["versions"][0]["components"];
+    components["nodes"].push_back(node("cameras", "orogen::Deployment"));
+    ConfigMap config = ConfigMap::fromYamlString("name: left\n"
+                                                 "data: {deployment: cameras}\n");
+    components["configuration"]["nodes"].push_back(config);
+    ConfigMap cnd;
+    CHECK(exporter.createCnd(model, cnd));
+    CHECK(cnd["deployments"].hasKey("cameras"));
+    CHECK(cnd["deployments"]["cameras"]["process_name"].getString() == "cameras");
+    CHECK(cnd["deployments"]["cameras"]["taskList"].hasKey("left"));
+    CHECK(!cnd["tasks"]["left"].hasKey("deployment"));
+    CHECK(!cnd["deployments"].hasKey("left_deployment"));
+    CHECK(cnd["deployments"].hasKey("right_deployment"));
+}
+
+// A changed part model has to be exported again although the node itself did not change
+static void testChangedPartModel()
+{
+    std::map<std::string, ConfigMap> models = parts();
+    CndExporter exporter([&](const std::string &, const std::string &name, const std::string &)
+                         { return models[name]; });
+    ConfigMap model = createModel();
+    ConfigMap cnd;
+    CHECK(exporter.createCnd(model, cnd));
+    CHECK(!cnd["tasks"]["left"].hasKey("rate"));
+
+    models["camera::Task"]["versions"][0]["defaultConfiguration"]["data"]["rate"] = 10;
+    model = createModel();
+    cnd = ConfigMap();
+    CHECK(exporter.createCnd(model, cnd));
+    CHECK(cnd["tasks"]["left"].hasKey("rate") && cnd["tasks"]["left"]["rate"].getInt() == 10);
+    CHECK(cnd["tasks"]["right"].hasKey("rate"));
+}
+
+// With revisions unchanged nodes and part models are neither hashed nor resolved again
+static void testRevisions()
+{
+    std::map<std::string, ConfigMap> models = parts();
+    std::map<std::string, uint64_t> partRevisions{{"camera::Task", 1}, {"orogen::Deployment", 1}};
+    std::map<std::string, uint64_t> nodeRevisions{{"left", 1}, {"right", 1}};
+    int resolved = 0;
+    CndExporter exporter([&](const std::string &, const std::string &name, const std::string &)
+                         { ++resolved; return models[name]; });
+    exporter.setRevisions([&](const std::string &name)
+                          { return nodeRevisions[name]; },
+                          [&](const std::string &, const std::string &name, const std::string &)
+                          { return partRevisions[name]; });
+    ConfigMap model = createModel();
+    ConfigMap cnd;
+    CHECK(exporter.createCnd(model, cnd));
+    CHECK(resolved == 1);
+
+    resolved = 0;
+    model = createModel();
+    CHECK(exporter.createCnd(model, cnd));
+    CHECK(resolved == 0);
+    CHECK(cnd["tasks"].size() == 2);
+
+    // a new part revision re-exports the nodes of the part
+    models["camera::Task"]["versions"][0]["defaultConfiguration"]["data"]["rate"] = 10;
+    partRevisions["camera::Task"] = 2;
+    model = createModel();
+    cnd = ConfigMap();
+    CHECK(exporter.createCnd(model, cnd));
+    CHECK(resolved == 1);
+    CHECK(cnd["tasks"]["left"].hasKey("rate"));
+
+    // a new node revision re-exports the node only
+    ConfigMap config = ConfigMap::fromYamlString("name: right\n"
+                                                 "data: {rate: 20}\n");
+    nodeRevisions["right"] = 2;
+    model = createModel();
+    model["versions"][0]["components"]["configuration"]["nodes"].push_back(config);
+    cnd = ConfigMap();
+    CHECK(exporter.createCnd(model, cnd));
+    CHECK(cnd["tasks"]["right"]["rate"].getInt() == 20);
+    CHECK(cnd["tasks"]["left"]["rate"].getInt() == 10);
+}
+
+// The file is rewritten if it was changed outside of the exporter, also within the same second
+static void testRewriteChangedFile()
+{
+    std::map<std::string, ConfigMap> models = parts();
+    CndExporter exporter([&](const std::string &, const std::string &name, const std::string &)
+                         { return models[name]; });
+    const std::string fileName = "test_cnd_exporter.cnd";
+    ConfigMap model = createModel();
+    CHECK(exporter.exportCnd(model, fileName));
+    const ConfigMap exported = ConfigMap::fromYamlFile(fileName);
+    {
+        std::ofstream out(fileName);
+        out << "tasks: {}\n";
+    }
+    model = createModel();
+    CHECK(exporter.exportCnd(model, fileName));
+    ConfigMap written = ConfigMap::fromYamlFile(fileName);
+    CHECK(written["tasks"].size() == 2);
+    CHECK(exported.size() == written.size());
+    std::remove(fileName.c_str());
+}
+
+// A host named like the unassigned partition must not merge with it
+static void testPartitionByHost()
+{
+    ConfigMap cnd = ConfigMap::fromYamlString("tasks:\n"
+                                              "  a: {type: camera::Task}\n"
+                                              "  b: {type: camera::Task}\n"
+                                              "  c: {type: camera::Task}\n"
+                                              "  d: {type: camera::Task}\n"
+                                              "connections:\n"
+                                              "  ab: {from: {task_id: a, port_name: out}, to: {task_id: b, port_name: in}}\n"
+                                              "  bc: {from: {task_id: b, port_name: out}, to: {task_id: c, port_name: in}}\n"
+                                              "deployments:\n"
+                                              "  first: {hostID: default, taskList: {a: camera::Task, b: camera::Task}}\n"
+                                              "  second: {hostID: \"<unassigned>\", taskList: {c: camera::Task}}\n"
+                                              "  third: {taskList: {}}\n");
+    std::map<std::string, ConfigMap> partitions;
+    ConfigMap manifest;
+    CHECK(CndExporter::partitionCnd(cnd, "hostID", partitions, manifest));
+    const std::string unassigned = manifest["unassigned_partition"].getString();
+    CHECK(unassigned != "default" && unassigned != "<unassigned>");
+    CHECK(partitions.size() == 3);
+    CHECK(partitions["default"]["tasks"].size() == 2);
+    CHECK(partitions["default"]["connections"].hasKey("ab"));
+    CHECK(partitions["<unassigned>"]["tasks"].hasKey("c"));
+    // the deployment without host and the task without deployment
+    CHECK(partitions[unassigned]["deployments"].hasKey("third"));
+    CHECK(partitions[unassigned]["tasks"].hasKey("d"));
+    CHECK(manifest["cross_partition_connections"].hasKey("bc"));
+    CHECK(manifest["cross_partition_connections"]["bc"]["to"]["partition"].getString() == "<unassigned>");
+    CHECK(manifest["partitions"][unassigned]["file"].getString() != manifest["partitions"]["<unassigned>"]["file"].getString());
+}
+
+static bool fileExists(const std::string &fileName)
+{
+    return std::ifstream(fileName).good();
+}
+
+// Partition files of a previous export which are not written again are removed
+static void testStalePartitions()
+{
+    std::map<std::string, ConfigMap> models = parts();
+    CndExporter exporter([&](const std::string &, const std::string &name, const std::string &)
+                         { return models[name]; });
+    const std::string folder = "test_cnd_partitions";
+    ConfigMap model = createModel();
+    CHECK(exporter.exportPartitions(model, folder, "deployment", "", 1));
+    CHECK(fileExists(folder + "/left_deployment.cnd"));
+    CHECK(fileExists(folder + "/right_deployment.cnd"));
+    {
+        std::ofstream other(folder + "/notes.cnd");
+        other << "{}\n";
+    }
+
+    // both tasks move to the deployment cameras
+    model = createModel();
+    ConfigItem &components = model["versions"][0]["components"];
+    components["nodes"].push_back(node("cameras", "orogen::Deployment"));
+    components["configuration"]["nodes"].push_back(ConfigMap::fromYamlString("{name: left, data: {deployment: cameras}}"));
+    components["configuration"]["nodes"].push_back(ConfigMap::fromYamlString("{name: right, data: {deployment: cameras}}"));
+    CHECK(exporter.exportPartitions(model, folder, "deployment", "", 1));
+    CHECK(fileExists(folder + "/cameras.cnd"));
+    CHECK(!fileExists(folder + "/left_deployment.cnd"));
+    CHECK(!fileExists(folder + "/right_deployment.cnd"));
+    // files which are not listed in the manifest are kept
+    CHECK(fileExists(folder + "/notes.cnd"));
+    for (const char *file : {"cameras.cnd", "notes.cnd", "partitions.yml"})
+        std::remove((folder + "/" + file).c_str());
+    std::remove(folder.c_str());
+}
+
+int main()
+{
+    testDefaultDeployments();
+    testDeploymentNode();
+    testChangedPartModel();
+    testRevisions();
+    testRewriteChangedFile();
+    testPartitionByHost();
+    testStalePartitions();
+    return test::result();
+}
@@ -0,0 +1,103 @@
+/**
+ * \file test_cnd_importer.cpp
+ * \brief Unit tests of the CND import
+ **/
+
+#include "Check.hpp"
+#include "CndImporter.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace configmaps;
+using namespace xrock_gui_model;
+
+static std::string writeFile(const std::string &content)
+{
+    const std::string fileName = "test_cnd_importer.cnd";
+    std::ofstream out(fileName);
+    out << content;
+    return fileName;
+}
+
+static void testImport()
+{
+    std::string fileName = writeFile("tasks:\n"
+                                     "  left: {type: camera::Task, config: {rate: 10}}\n"
+                                     "  right: {type: camera::Task}\n"
+                                     "connections:\n"
+                                     "  sync:\n"
+                                     "    from: {task_id: left, port_name: frame}\n"
+                                     "    to: {task_id: right, port_name: trigger}\n");
+    CndImporter importer;
+    ConfigMap model;
+    CHECK(importer.importCnd(fileName, model));
+    ConfigItem &components = model["versions"][0]["components"];
+    CHECK(components["nodes"].size() == 2);
+    CHECK(components["nodes"][0]["model"]["name"].getString() == "camera::Task");
+    CHECK(components["configuration"]["nodes"][0]["data"]["config"]["rate"].getInt() == 10);
+    CHECK(components["edges"].size() == 1);
+    CHECK(components["edges"][0]["from"]["interface"].getString() == "frame");
+    ConfigItem &layout = model["versions"][0]["data"]["gui"]["layouts"]["software"];
+    CHECK(layout["left"]["x"].getDouble() < layout["right"]["x"].getDouble());
+    std::remove(fileName.c_str());
+}
+
+static void testAliases()
+{
+    std::string fileName = writeFile("tasks:\n"
+                                     "  left: &camera {type: camera::Task, config: &config {rate: 10, names: [a, b]}}\n"
+                                     "  right: *camera\n"
+                                     "  filter: {type: filter::Task, config: *config, name: &name filtered}\n"
+                                     "  *name : {type: sink::Task}\n");
+    CndImporter importer;
+    ConfigMap cnd;
+    CHECK(importer.readCnd(fileName, cnd));
+    CHECK(cnd["tasks"].size() == 4);
+    CHECK(cnd["tasks"]["right"]["type"].getString() == "camera::Task");
+    CHECK(cnd["tasks"]["right"]["config"]["names"].size() == 2);
+    CHECK(cnd["tasks"]["filter"]["config"]["rate"].getString() == "10");
+    CHECK(cnd["tasks"]["filtered"]["type"].getString() == "sink::Task");
+
+    ConfigMap model;
+    CHECK(importer.importCnd(fileName, model));
+    ConfigItem &nodes = model["versions"][0]["components"]["nodes"];
+    CHECK(nodes.size() == 4);
+    CHECK(nodes[1]["model"]["name"].getString() == "camera::Task");
+    ConfigItem &configurations = model["versions"][0]["components"]["configuration"]["nodes"];
+    CHECK(configurations[2]["data"]["config"]["rate"].getInt() == 10);
+    std::remove(fileName.c_str());
+}
+
+static void testAliasedSection()
+{
+    std::string fileName = writeFile("templates: &tasks\n"
+                                     "  left: {type: camera::Task}\n"
+                                     "tasks: *tasks\n");
+    CndImporter importer;
+    ConfigMap cnd;
+    CHECK(importer.readCnd(fileName, cnd));
+    CHECK(cnd["tasks"]["left"]["type"].getString() == "camera::Task");
+    std::remove(fileName.c_str());
+}
+
+static void testInvalidFile()
+{
+    std::string fileName = writeFile("tasks:\n"
+                                     "  left: *unknown\n");
+    CndImporter importer;
+    ConfigMap model;
+    CHECK(!importer.importCnd(fileName, model));
+    CHECK(!importer.getError().empty());
+    std::remove(fileName.c_str());
+}
+
+int main()
+{
+    testImport();
+    testAliases();
+    testAliasedSection();
+    testInvalidFile();
+    return test::result();
+}
@@ -0,0 +1,177 @@
+/**
+ * \file test_config_map_helper.cpp
+ * \brief Unit tests of the ConfigMapHelper paths, prune, merge and the SubmodelView
+ **/
+
+#include "Check.hpp"
+#include "ConfigMapHelper.hpp"
+
+#include <string>
+
+using namespace configmaps;
+using namespace xrock_gui_model;
+
+static void testPaths()
+{
+    ConfigMap map = ConfigMap::fromYamlString("a: {b: [x, {c: 1}]}\n"
+                                              "'0': zero\n");
+    ConfigItem *item = ConfigMapHelper::getSubItem(map, ConfigPath("a/b/1/c"));
+    CHECK(item && item->toString() == "1");
+    // numeric segments are keys on maps
+    CHECK(ConfigMapHelper::getString(map, ConfigPath("0")) == "zero");
+    CHECK(ConfigMapHelper::getSubItem(map, ConfigPath("a/b/2")) == NULL);
+    CHECK(ConfigMapHelper::getSubItem(map, ConfigPath("a/x")) == NULL);
+
+    // const lookups point into the map and do not insert missing keys
+    const ConfigMap &constMap = map;
+    const ConfigItem *found = ConfigMapHelper::findItem(constMap, ConfigPath("a/b"));
+    CHECK(found == ConfigMapHelper::getSubItem(map, ConfigPath("a/b")));
+    CHECK(ConfigMapHelper::getSize(*found) == 2);
+    CHECK(ConfigMapHelper::getString(*found, ConfigPath("0")) == "x");
+    CHECK(ConfigMapHelper::findItem(constMap, ConfigPath("a/missing/c")) == NULL);
+    CHECK(!map["a"].hasKey("missing"));
+    ConfigMap copy;
+    CHECK(ConfigMapHelper::getMap(constMap, ConfigPath("a/b/1"), copy));
+    CHECK(copy.hasKey("c"));
+    CHECK(!ConfigMapHelper::getMap(constMap, ConfigPath("a/b/0"), copy));
+}
+
+static void testPrune()
+{
+    ConfigMap map = ConfigMap::fromYamlString("keep: 1\n"
+                                              "blank: '  '\n"
+                                              "empty: {a: '', b: {c: ' '}}\n"
+                                              "list: ['', x, {d: ''}, y, []]\n"
+                                              "nested: {e: [' ', z]}\n");
+    ConfigItem item(map);
+    CHECK(!ConfigMapHelper::prune(item));
+    ConfigMap &pruned = item;
+    CHECK(pruned.hasKey("keep"));
+    CHECK(!pruned.hasKey("blank"));
+    CHECK(!pruned.hasKey("empty"));
+    // the remaining vector elements keep their order
+    CHECK(pruned["list"].size() == 2);
+    CHECK(pruned["list"][0].toString() == "x");
+    CHECK(pruned["list"][1].toString() == "y");
+    CHECK(pruned["nested"]["e"].size() == 1);
+    CHECK(pruned["nested"]["e"][0].toString() == "z");
+
+    ConfigItem blank(ConfigMap::fromYamlString("a: ''\nb: [' ']\n"));
+    CHECK(ConfigMapHelper::prune(blank));
+}
+
+static void testMerge()
+{
+    ConfigMap target = ConfigMap::fromYamlString("a: {b: 1, c: 2}\n"
+                                                 "list: [1, 2]\n"
+                                                 "value: old\n");
+    ConfigMap source = ConfigMap::fromYamlString("a: {c: 3, d: 4}\n"
+                                                 "list: [5]\n"
+                                                 "value: {x: 1}\n"
+                                                 "added: new\n");
+    ConfigMapHelper::merge(target, source);
+    CHECK(target["a"]["b"].toString() == "1");
+    CHECK(target["a"]["c"].toString() == "3");
+    CHECK(target["a"]["d"].toString() == "4");
+    // vectors and values of another kind are replaced
+    CHECK(target["list"].size() == 1);
+    CHECK(target["list"][0].toString() == "5");
+    CHECK(target["value"].isMap());
+    CHECK(target["added"].toString() == "new");
+}
+
+// Nested assemblies are decoded on every level and written back in their original encoding
+static void testSubmodelView()
+{
+    ConfigMap node = ConfigMap::fromYamlString("submodel:\n"
+                                               "  - name: arm\n"
+                                               "    data: \"rate: 10\\n\"\n"
+                                               "    submodel:\n"
+                                               "      - name: joint\n"
+                                               "        data: \"limit: 1.5\\n\"\n"
+                                               "        submodel:\n"
+                                               "          - name: motor\n"
+                                               "            data: {current: 2}\n");
+    SubmodelView view(node["submodel"]);
+    ConfigMap config;
+    view.unpack(config);
+    ConfigItem &arm = config["submodel"][0];
+    CHECK(arm["data"].isMap());
+    CHECK(arm["submodel"][0]["data"].isMap());
+    CHECK(arm["submodel"][0]["data"]["limit"].toString() == "1.5");
+    CHECK(arm["submodel"][0]["submodel"][0]["data"].isMap());
+
+    // nothing changed
+    CHECK(view.pack(config) == 0);
+    CHECK(!node["submodel"][0]["submodel"][0]["data"].isMap());
+
+    arm["submodel"][0]["data"]["limit"] = 2;
+    CHECK(view.pack(config) == 1);
+    ConfigItem &joint = node["submodel"][0]["submodel"][0];
+    CHECK(!joint["data"].isMap());
+    CHECK(ConfigMap::fromYamlString(joint["data"].getString())["limit"].toString() == "2");
+    // the untouched entry on the first level keeps its stored string
+    CHECK(node["submodel"][0]["data"].getString() == "rate: 10\n");
+
+    // with a limited depth the deeper levels stay in their stored encoding
+    SubmodelView shallow(node["submodel"]);
+    ConfigMap shallowConfig;
+    shallow.unpack(shallowConfig, 1);
+    CHECK(shallowConfig["submodel"][0]["data"].isMap());
+    CHECK(!shallowConfig["submodel"][0]["submodel"][0]["data"].isMap());
+}
+
+// Only the entries which differ from the defaults of the part model are kept
+static void testSubmodelDiff()
+{
+    ConfigMap defaults = ConfigMap::fromYamlString("submodel:\n"
+                                                   "  - {name: left, data: {rate: 10}}\n"
+                                                   "  - {name: right, data: {rate: 10}}\n"
+                                                   "  - name: arm\n"
+                                                   "    data: {speed: 1}\n"
+                                                   "    submodel:\n"
+                                                   "      - {name: joint, data: {limit: 1}}\n"
+                                                   "      - {name: motor, data: {current: 2}}\n");
+    ConfigMap stored = ConfigMap::fromYamlString("submodel:\n"
+                                                 "  - {name: right, data: {rate: 20}}\n"
+                                                 "  - name: arm\n"
+                                                 "    submodel:\n"
+                                                 "      - {name: motor, data: {current: 3}}\n");
+    ConfigMap config = defaults;
+    SubmodelView::overlay(config["submodel"], stored["submodel"]);
+    CHECK(config["submodel"].size() == 3);
+    CHECK(config["submodel"][1]["data"]["rate"].toString() == "20");
+    CHECK(config["submodel"][2]["data"]["speed"].toString() == "1");
+    CHECK(config["submodel"][2]["submodel"][1]["data"]["current"].toString() == "3");
+
+    // unchanged defaults are not stored
+    ConfigVector changed;
+    CHECK(SubmodelView::diff(config["submodel"], defaults["submodel"], changed) == 2);
+    ConfigMap changedMap;
+    changedMap["submodel"] = changed;
+    CHECK(ConfigMapHelper::equals(changedMap, stored));
+
+    // an entry which is set back to its default is dropped
+    config["submodel"][1]["data"]["rate"] = 10;
+    config["submodel"][0]["data"]["rate"] = 5;
+    changed.clear();
+    CHECK(SubmodelView::diff(config["submodel"], defaults["submodel"], changed) == 2);
+    CHECK(changed.size() == 2);
+    CHECK(changed[0]["name"].toString() == "left");
+    CHECK(changed[1]["name"].toString() == "arm");
+    CHECK(!changed[1].hasKey("data"));
+
+    changed.clear();
+    CHECK(SubmodelView::diff(defaults["submodel"], defaults["submodel"], changed) == 0);
+    CHECK(changed.empty());
+}
+
+int main()
+{
+    testPaths();
+    testPrune();
+    testMerge();
+    testSubmodelView();
+    testSubmodelDiff();
+    return test::result();
+}
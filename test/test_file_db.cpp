@@ -0,0 +1,152 @@
+/**
+ * \file test_file_db.cpp
+ * \brief Unit tests of the FileDB format migration
+ **/
+
+#include "Check.hpp"
+#include "BasicModelHelper.hpp"
+#include "FileDB.hpp"
+
+#include <mars/utils/misc.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+using namespace configmaps;
+using namespace xrock_gui_model;
+
+static const std::string folder = "test_file_db";
+
+static void writeFile(const std::string &fileName, const std::string &content)
+{
+    std::ofstream out(fileName);
+    out << content;
+}
+
+static bool fileExists(const std::string &fileName)
+{
+    return std::ifstream(fileName).good();
+}
+
+// A legacy database with one model which uses the old keys and yaml encoded data strings
+static void createLegacyDB()
+{
+    mars::utils::createDirectory(folder + "/arm/v1");
+    writeFile(folder + "/info.yml",
+              "models:\n"
+              "  - name: arm\n"
+              "    type: system_modelling::task_graph::Network\n"
+              "    versions:\n"
+              "      - name: v1\n");
+    writeFile(folder + "/arm/v1/model.yml",
+              "name: arm\n"
+              "domain: SOFTWARE\n"
+              "type: system_modelling::task_graph::Network\n"
+              "versions:\n"
+              "  - name: v1\n"
+              "    softwareData:\n"
+              "      data: \"framework: Rock\\n\"\n"
+              "    defaultConfig:\n"
+              "      data: \"rate: 10\\n\"\n"
+              "    components:\n"
+              "      nodes:\n"
+              "        - name: left\n"
+              "          model: {name: camera, domain: SOFTWARE, version: v1}\n"
+              "      edges:\n"
+              "        - name: e\n"
+              "          from: {name: left, interface: out}\n"
+              "          to: {name: left, interface: in}\n"
+              "          data: \"weight: 2\\n\"\n"
+              "        - name: f\n"
+              "          from: {name: left, interface: out}\n"
+              "          to: {name: left, interface: in}\n"
+              "          data: \"\"\n");
+}
+
+static void removeDB()
+{
+    for (const char *file : {"/arm/v1/model.yml", "/arm/v1/model.yml.legacy", "/info.yml"})
+        std::remove((folder + file).c_str());
+    std::remove((folder + "/arm/v1").c_str());
+    std::remove((folder + "/arm").c_str());
+    std::remove(folder.c_str());
+}
+
+// The decoded maps of a model have to be the same whether the database is migrated or not
+static void checkModel(ConfigMap &model)
+{
+    CHECK(model.hasKey("model"));
+    CHECK(model["model"]["name"] == "arm");
+    ConfigItem &version = model["versions"][0];
+    CHECK(!version.hasKey("softwareData"));
+    CHECK(!version.hasKey("defaultConfig"));
+    CHECK(BasicModelHelper::decodeData(version));
+    CHECK(version["data"]["framework"] == "Rock");
+    // the default configuration is decoded on first access as well
+    CHECK(!version["defaultConfiguration"]["data"].isMap());
+    CHECK(BasicModelHelper::decodeData(version["defaultConfiguration"]));
+    CHECK((int)version["defaultConfiguration"]["data"]["rate"] == 10);
+    ConfigItem &edges = version["components"]["edges"];
+    // the weight is copied to the edge
+    CHECK((int)edges[0]["weight"] == 2);
+    CHECK(BasicModelHelper::decodeData(edges[0]));
+    CHECK((int)edges[0]["data"]["weight"] == 2);
+    CHECK(!edges[1].hasKey("data"));
+}
+
+static void testLegacyDB()
+{
+    createLegacyDB();
+    FileDB db;
+    db.setDbAddress(folder);
+    CHECK(db.getFormatVersion() == FileDB::legacyFormatVersion);
+    ConfigMap model = db.requestModel("SOFTWARE", "arm", "v1", true);
+    checkModel(model);
+    removeDB();
+}
+
+static void testMigratedDB()
+{
+    createLegacyDB();
+    FileDB db;
+    db.setDbAddress(folder);
+    CHECK(db.migrate(1));
+    CHECK(db.getFormatVersion() == FileDB::currentFormatVersion);
+    // the original files are only kept until the migration is complete
+    CHECK(!fileExists(folder + "/arm/v1/model.yml.legacy"));
+    CHECK(!fileExists(folder + "/arm/v1/model.yml.migrating"));
+
+    FileDB reopened;
+    reopened.setDbAddress(folder);
+    CHECK(reopened.getFormatVersion() == FileDB::currentFormatVersion);
+    ConfigMap model = reopened.requestModel("SOFTWARE", "arm", "v1", true);
+    checkModel(model);
+    removeDB();
+}
+
+// Models stored in the current format may still contain the old keys, e.g. if they were edited by hand
+static void testCurrentFormatWithOldKeys()
+{
+    createLegacyDB();
+    writeFile(folder + "/info.yml",
+              "format_version: 2\n"
+              "models:\n"
+              "  - name: arm\n"
+              "    type: system_modelling::task_graph::Network\n"
+              "    versions:\n"
+              "      - name: v1\n");
+    FileDB db;
+    db.setDbAddress(folder);
+    ConfigMap model = db.requestModel("SOFTWARE", "arm", "v1", true);
+    checkModel(model);
+    removeDB();
+}
+
+int main()
+{
+    testLegacyDB();
+    testMigratedDB();
+    testCurrentFormatWithOldKeys();
+    return test::result();
+}
@@ -0,0 +1,93 @@
+/**
+ * \file test_graph_layout.cpp
+ * \brief Unit tests of the automatic node placement
+ **/
+
+#include "Check.hpp"
+#include "GraphLayout.hpp"
+
+#include <cmath>
+#include <vector>
+
+using namespace xrock_gui_model;
+
+typedef std::vector<GraphLayout::Position> Positions;
+
+static bool overlap(const Positions &positions, double distance)
+{
+    for (size_t i = 0; i < positions.size(); ++i)
+        for (size_t j = i + 1; j < positions.size(); ++j)
+            if (std::fabs(positions[i].x - positions[j].x) < distance && std::fabs(positions[i].y - positions[j].y) < distance)
+                return true;
+    return false;
+}
+
+static void testLayered()
+{
+    // 0 -> 1 -> 2, 0 -> 3 -> 2 and the back edge 2 -> 0
+    std::vector<GraphLayout::Edge> edges{{0, 1}, {1, 2}, {0, 3}, {3, 2}, {2, 0}};
+    Positions positions = GraphLayout::layered(4, edges, 300.0, 100.0);
+    CHECK(positions.size() == 4);
+    CHECK(positions[0].x == 0.0);
+    CHECK(positions[1].x == 300.0);
+    CHECK(positions[3].x == 300.0);
+    CHECK(positions[2].x == 600.0);
+    // the columns are centered around y = 0
+    CHECK(positions[0].y == 0.0);
+    CHECK(positions[1].y + positions[3].y == 0.0);
+    CHECK(std::fabs(positions[1].y - positions[3].y) == 100.0);
+
+    // columns with more than maxColumnSize nodes are wrapped
+    positions = GraphLayout::layered(5, {}, 300.0, 100.0, 2);
+    CHECK(positions[4].x == 600.0);
+    CHECK(!overlap(positions, 50.0));
+}
+
+static void testForceDirected()
+{
+    std::vector<GraphLayout::Edge> edges;
+    for (size_t i = 1; i < 50; ++i)
+        edges.emplace_back(i / 3, i);
+    Positions positions = GraphLayout::forceDirected(GraphLayout::layered(50, edges), edges, 250.0, 100, 2);
+    CHECK(positions.size() == 50);
+    // the top left corner of the layout is at the origin
+    double minX = positions[0].x, minY = positions[0].y;
+    for (auto &position : positions)
+    {
+        CHECK(std::isfinite(position.x) && std::isfinite(position.y));
+        minX = std::min(minX, position.x);
+        minY = std::min(minY, position.y);
+    }
+    CHECK(minX == 0.0);
+    CHECK(minY == 0.0);
+    CHECK(!overlap(positions, 1.0));
+}
+
+static void testPlace()
+{
+    Positions placed{{0.0, 0.0}, {300.0, 0.0}, {300.0, 120.0}};
+    const size_t none = GraphLayout::noAnchor;
+    Positions positions = GraphLayout::place(placed, {0, 0, none, none}, 300.0, 120.0);
+    CHECK(positions.size() == 4);
+    // right of node 0 are two placed nodes, the new ones go above and below them
+    CHECK(positions[0].x == 300.0 && positions[0].y == -120.0);
+    CHECK(positions[1].x == 300.0 && positions[1].y == 240.0);
+    // nodes without anchor get a free column right of the layout
+    CHECK(positions[2].x == 600.0 && positions[2].y == 0.0);
+    CHECK(positions[3].x == 600.0 && positions[3].y == 120.0);
+    Positions all(placed);
+    all.insert(all.end(), positions.begin(), positions.end());
+    CHECK(!overlap(all, 100.0));
+
+    positions = GraphLayout::place({}, {none, none}, 300.0, 120.0);
+    CHECK(positions[0].x == 0.0 && positions[0].y == 0.0);
+    CHECK(positions[1].x == 0.0 && positions[1].y == 120.0);
+}
+
+int main()
+{
+    testLayered();
+    testForceDirected();
+    testPlace();
+    return test::result();
+}
@@ -0,0 +1,62 @@
+/**
+ * \file test_lru_cache.cpp
+ * \brief Unit tests of the LruCache
+ **/
+
+#include "Check.hpp"
+#include "utils/LruCache.hpp"
+
+#include <string>
+
+using namespace xrock_gui_model;
+
+static void testEviction()
+{
+    LruCache<std::string, int> cache(2);
+    cache.insert("a", 1);
+    cache.insert("b", 2);
+    CHECK(cache.size() == 2);
+    // a becomes the most recently used entry, so b is evicted
+    CHECK(cache.find("a") && *cache.find("a") == 1);
+    cache.insert("c", 3);
+    CHECK(cache.size() == 2);
+    CHECK(!cache.find("b"));
+    CHECK(cache.find("a") && cache.find("c"));
+}
+
+static void testUpdate()
+{
+    LruCache<std::string, int> cache(2);
+    cache.insert("a", 1);
+    cache.insert("b", 2);
+    // updating an entry marks it as used and does not evict
+    CHECK(cache.insert("a", 10) == 10);
+    CHECK(cache.size() == 2);
+    cache.insert("c", 3);
+    CHECK(!cache.find("b"));
+    CHECK(*cache.find("a") == 10);
+
+    int *value = cache.find("c");
+    *value = 30;
+    CHECK(*cache.find("c") == 30);
+    cache.clear();
+    CHECK(cache.size() == 0);
+    CHECK(!cache.find("a"));
+}
+
+static void testZeroCapacity()
+{
+    LruCache<int, int> cache(0);
+    cache.insert(1, 1);
+    cache.insert(2, 2);
+    CHECK(cache.size() == 1);
+    CHECK(cache.find(2) && !cache.find(1));
+}
+
+int main()
+{
+    testEviction();
+    testUpdate();
+    testZeroCapacity();
+    return test::result();
+}
@@ -0,0 +1,65 @@
+/**
+ * \file test_markdown_renderer.cpp
+ * \brief Unit tests of the markdown rendering
+ *
+ * The expected html has the structure python-markdown produces, only the line breaks between tags differ.
+ **/
+
+#include "Check.hpp"
+#include "MarkdownRenderer.hpp"
+
+#include <iostream>
+#include <string>
+
+using namespace xrock_gui_model;
+
+static void expect(const std::string &markdown, const std::string &html)
+{
+    const std::string result = MarkdownRenderer::toHtml(markdown);
+    if (result != html)
+        std::cerr << "markdown:\n" << markdown << "\nexpected:\n" << html << "\nresult:\n" << result << std::endl;
+    CHECK(result == html);
+}
+
+static void testBlocks()
+{
+    expect("# Title\n\ntext *with* `code`\n", "<h1>Title</h1>\n<p>text <em>with</em> <code>code</code></p>\n");
+    expect("Title\n=====\n", "<h1>Title</h1>\n");
+    expect("> quoted\n> text\n", "<blockquote>\n<p>quoted\ntext</p>\n</blockquote>\n");
+    expect("    int a;\n", "<pre><code>int a;\n</code></pre>\n");
+    expect("```cpp\na < b\n```\n", "<pre><code class=\"language-cpp\">a &lt; b\n</code></pre>\n");
+    expect("a\n\n---\n", "<p>a</p>\n<hr />\n");
+}
+
+static void testLists()
+{
+    expect("- a\n- b\n", "<ul>\n<li>a</li>\n<li>b</li>\n</ul>\n");
+    expect("1. a\n2. b\n", "<ol>\n<li>a</li>\n<li>b</li>\n</ol>\n");
+    expect("- a\n\n- b\n", "<ul>\n<li><p>a</p></li>\n<li><p>b</p></li>\n</ul>\n");
+    expect("- a\n    - b\n", "<ul>\n<li>a\n<ul>\n<li>b</li>\n</ul></li>\n</ul>\n");
+    expect("text\n\n- a\n", "<p>text</p>\n<ul>\n<li>a</li>\n</ul>\n");
+}
+
+// A list needs a blank line before it, directly after a paragraph line it is part of the paragraph
+static void testListAfterParagraph()
+{
+    expect("text\n- a\n- b\n", "<p>text\n- a\n- b</p>\n");
+    expect("text\n1. a\n", "<p>text\n1. a</p>\n");
+    expect("> text\n> - a\n", "<blockquote>\n<p>text\n- a</p>\n</blockquote>\n");
+}
+
+static void testInline()
+{
+    expect("[link](http://x.org \"title\")\n", "<p><a href=\"http://x.org\" title=\"title\">link</a></p>\n");
+    expect("**bold** and \\*escaped\\*\n", "<p><strong>bold</strong> and *escaped*</p>\n");
+    expect("a < b & c\n", "<p>a &lt; b &amp; c</p>\n");
+}
+
+int main()
+{
+    testBlocks();
+    testLists();
+    testListAfterParagraph();
+    testInline();
+    return test::result();
+}
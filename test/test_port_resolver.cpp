@@ -0,0 +1,58 @@
+/**
+ * \file test_port_resolver.cpp
+ * \brief Unit tests of the cache keys and version names of the port resolution
+ **/
+
+#include "Check.hpp"
+#include "PortResolver.hpp"
+
+using namespace xrock_gui_model;
+
+static PortResolver::Request request()
+{
+    PortResolver::Request request;
+    request.taskModel = "camera::Task";
+    request.taskVersion = "v1";
+    request.config = "rate: 10\n";
+    request.newVersion = "v1_system_v1";
+    request.dbPath = "/db/main";
+    request.dbGraph = "graph_v1";
+    return request;
+}
+
+int main()
+{
+    const std::string key = PortResolver::cacheKey(request());
+    // the name of the new version does not matter, an existing resolved version is reused
+    PortResolver::Request other = request();
+    other.newVersion = "v1_other_v1";
+    CHECK(PortResolver::cacheKey(other) == key);
+
+    other = request();
+    other.dbPath = "/db/other";
+    CHECK(PortResolver::cacheKey(other) != key);
+    other = request();
+    other.dbGraph = "graph_v2";
+    CHECK(PortResolver::cacheKey(other) != key);
+    other = request();
+    other.config = "rate: 20\n";
+    CHECK(PortResolver::cacheKey(other) != key);
+    other = request();
+    other.taskVersion = "v2";
+    CHECK(PortResolver::cacheKey(other) != key);
+
+    // configuration names and inline configurations do not share keys
+    other = request();
+    other.config.clear();
+    other.configNames = {"default"};
+    CHECK(PortResolver::cacheKey(other) != key);
+
+    // different configurations of a task model in the same model get their own version
+    const std::string version = PortResolver::versionName(request());
+    CHECK(version.compare(0, request().newVersion.size() + 1, request().newVersion + "_") == 0);
+    CHECK(PortResolver::versionName(request()) == version);
+    other = request();
+    other.config = "rate: 20\n";
+    CHECK(PortResolver::versionName(other) != version);
+    return test::result();
+}
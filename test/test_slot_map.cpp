@@ -0,0 +1,71 @@
+/**
+ * \file test_slot_map.cpp
+ * \brief Unit tests of the SlotMap container
+ **/
+
+#include "Check.hpp"
+#include "utils/SlotMap.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace xrock_gui_model;
+
+static std::vector<SlotMap<std::string>::Id> ids(const SlotMap<std::string> &map)
+{
+    std::vector<SlotMap<std::string>::Id> result;
+    for (const auto &[id, value] : map)
+        result.push_back(id);
+    return result;
+}
+
+static void testInsertFind()
+{
+    SlotMap<std::string> map;
+    CHECK(map.empty());
+    map.insert(7, "seven");
+    map.insert(3, "three");
+    CHECK(map.size() == 2);
+    CHECK(map.contains(7));
+    CHECK(!map.contains(4));
+    CHECK(map.find(4) == nullptr);
+    CHECK(*map.find(3) == "three");
+
+    // Inserting an existing id replaces the value in place
+    map.insert(7, "SEVEN");
+    CHECK(map.size() == 2);
+    CHECK(*map.find(7) == "SEVEN");
+    CHECK((ids(map) == std::vector<SlotMap<std::string>::Id>{7, 3}));
+}
+
+static void testEraseKeepsOrder()
+{
+    SlotMap<std::string> map;
+    for (unsigned long id = 0; id < 10; ++id)
+        map.insert(id, std::to_string(id));
+    CHECK(!map.erase(42));
+    // Erasing more than half of the slots triggers the compaction
+    for (unsigned long id = 0; id < 10; id += 2)
+        CHECK(map.erase(id));
+    CHECK(map.erase(1));
+    CHECK(map.size() == 4);
+    CHECK((ids(map) == std::vector<SlotMap<std::string>::Id>{3, 5, 7, 9}));
+    for (unsigned long id : {3ul, 5ul, 7ul, 9ul})
+        CHECK(map.find(id) && *map.find(id) == std::to_string(id));
+    CHECK(!map.contains(1));
+
+    map.insert(1, "one");
+    CHECK((ids(map) == std::vector<SlotMap<std::string>::Id>{3, 5, 7, 9, 1}));
+    CHECK((map.sortedIds() == std::vector<SlotMap<std::string>::Id>{1, 3, 5, 7, 9}));
+
+    map.clear();
+    CHECK(map.empty());
+    CHECK(map.begin() == map.end());
+}
+
+int main()
+{
+    testInsertFind();
+    testEraseKeepsOrder();
+    return test::result();
+}
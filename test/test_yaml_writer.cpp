@@ -0,0 +1,124 @@
+/**
+ * \file test_yaml_writer.cpp
+ * \brief Unit tests of the yaml emitter
+ **/
+
+#include "Check.hpp"
+#include "ConfigMapHelper.hpp"
+#include "YamlWriter.hpp"
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+
+using namespace configmaps;
+using namespace xrock_gui_model;
+
+static ConfigMap createMap()
+{
+    ConfigMap map = ConfigMap::fromYamlString("b: 1\n"
+                                              "a: [x, 'true', '', '12', 'a: b']\n"
+                                              "c: {d: 1.5, e: []}\n"
+                                              "f: {}\n");
+    map["g"] = 0.1;
+    map["h"] = std::string("line1\nline2");
+    return map;
+}
+
+// The double is compared by value, the atoms read back as strings
+static bool readsBack(ConfigMap &read, ConfigMap &map)
+{
+    if (!read.hasKey("g") || read["g"].getDouble() != map["g"].getDouble())
+        return false;
+    ConfigMap a = read, b = map;
+    a.erase("g");
+    b.erase("g");
+    return ConfigMapHelper::equals(a, b);
+}
+
+static std::string write(ConfigMap &map, YamlWriter::Style style)
+{
+    std::ostringstream out;
+    YamlWriter writer(out, style);
+    writer.writeDocument(map);
+    return out.str();
+}
+
+static void testDefaultStyle()
+{
+    ConfigMap map = createMap();
+    const std::string yaml = write(map, YamlWriter::Style::Default);
+    CHECK(yaml == "b: 1\n"
+                  "a:\n"
+                  "  - x\n"
+                  "  - 'true'\n"
+                  "  - ''\n"
+                  "  - '12'\n"
+                  "  - 'a: b'\n"
+                  "c:\n"
+                  "  d: 1.5\n"
+                  "  e: []\n"
+                  "f: {}\n"
+                  "g: 0.1\n"
+                  "h: \"line1\\nline2\"\n");
+    // strings which would read back as other types are quoted
+    ConfigMap read = ConfigMap::fromYamlString(yaml);
+    CHECK(readsBack(read, map));
+}
+
+// The expected output is the one of yaml.dump() of PyYAML 6 for the same data
+static void testPyYamlStyle()
+{
+    ConfigMap map = createMap();
+    CHECK(write(map, YamlWriter::Style::PyYaml) == "a:\n"
+                                                   "- x\n"
+                                                   "- 'true'\n"
+                                                   "- ''\n"
+                                                   "- '12'\n"
+                                                   "- 'a: b'\n"
+                                                   "b: 1\n"
+                                                   "c:\n"
+                                                   "  d: 1.5\n"
+                                                   "  e: []\n"
+                                                   "f: {}\n"
+                                                   "g: 0.1\n"
+                                                   "h: 'line1\n"
+                                                   "\n"
+                                                   "  line2'\n");
+}
+
+static void testScalars()
+{
+    CHECK(YamlWriter::formatString("plain") == "plain");
+    CHECK(YamlWriter::formatString("true") == "'true'");
+    CHECK(YamlWriter::formatString("") == "''");
+    CHECK(YamlWriter::formatString("a: b") == "'a: b'");
+    CHECK(YamlWriter::formatDouble(0.1) == "0.1");
+    CHECK(std::stod(YamlWriter::formatDouble(1.0 / 3.0)) == 1.0 / 3.0);
+}
+
+static void testWriteFile()
+{
+    const std::string fileName = "test_yaml_writer.yml";
+    ConfigMap map = createMap();
+    std::string error;
+    CHECK(YamlWriter::writeFile(fileName, map, error));
+    CHECK(error.empty());
+    ConfigMap read = ConfigMap::fromYamlFile(fileName);
+    CHECK(readsBack(read, map));
+    // the temporary file is gone
+    CHECK(std::remove((fileName + ".tmp").c_str()) != 0);
+    std::remove(fileName.c_str());
+
+    CHECK(!YamlWriter::writeFile("missing_directory/test.yml", map, error));
+    CHECK(!error.empty());
+}
+
+int main()
+{
+    testDefaultStyle();
+    testPyYamlStyle();
+    testScalars();
+    testWriteFile();
+    return test::result();
+}